@@ -0,0 +1,522 @@
+/*
+ * Module Name: Guess Engine
+ * Date: 19th October 2026
+ *
+ * The guessing game without a terminal. A GuessGame holds the secret and
+ * answers guesses with "too low", "too high" or "correct". A GuessStrategy
+ * is a pair of callbacks: one picks the next guess, the other hears the
+ * answer. guess_play() runs one game between them. The interactive game
+ * uses the same engine, with a human in place of the strategy.
+ *
+ * Numbers are int64_t and a range may span up to 2^64 values, so all
+ * distances are computed in uint64_t to avoid signed overflow.
+ *
+ * guess_game_deal() draws the secret from a distribution:
+ *     uniform      every number equally likely
+ *     skewed       low + floor(n * u^3): most secrets near the bottom
+ *     adversarial  no secret at all until the end; every answer keeps as
+ *                  many numbers possible as it can, so no strategy beats
+ *                  ceil(log2(n + 1)) guesses
+ * A noisy game lies: each "too low" or "too high" is flipped with
+ * probability `noise`. "Correct" is always true.
+ *
+ * Built-in strategies:
+ *     bisect   the middle of the range; never more than ceil(log2(n + 1))
+ *              guesses without lies, which is optimal for the worst case
+ *     third    a third of the way in; correct but slower
+ *     random   anywhere in the range; about 2 ln(n) guesses on average
+ *     bayes    the median of the posterior over the range, given the
+ *              prior and the noise (probabilistic bisection). It matches
+ *              bisect on a uniform honest game, needs fewer guesses on a
+ *              skewed one and keeps working when answers lie.
+ * The first three narrow [low, high] on each answer and start over when a
+ * lie has emptied it.
+ *
+ * The posterior lives in a PosteriorTree: a segment tree over the range
+ * whose nodes are only created when an update or a query splits them. An
+ * unsplit node spreads its mass like the prior. An answer multiplies the
+ * numbers on each side of the guess by a likelihood with lazy range
+ * multiplication, and the median is found by one descent. Each step costs
+ * O(log n) even for ranges of 10^9 and more; no array over the range is
+ * ever built.
+ *
+ * Usage:
+ *     GuessGame game;
+ *     GuessState state;
+ *     guess_state_init(&state, seed, GUESS_UNIFORM, 0.0);
+ *     guess_game_start(&game, 1, 100, 42);
+ *     long attempts = guess_play(&guess_strategies[0], &state, &game);
+ *     guess_state_free(&state);
+ */
+#ifndef GUESS_ENGINE_H
+#define GUESS_ENGINE_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/random.h" // per-thread xoshiro256** generator
+/*================= Constant =================*/
+#define GUESS_MAX_ATTEMPTS 100000 // A strategy still guessing after this many is broken.
+#define GUESS_STRATEGY_COUNT 4
+#define GUESS_DISTRIBUTION_COUNT 3
+#define POSTERIOR_INITIAL_NODES 1024
+/*================= Type =================*/
+typedef enum
+{
+    GUESS_CORRECT = 0,
+    GUESS_TOO_LOW = 1,
+    GUESS_TOO_HIGH = 2,
+    GUESS_OUT_OF_RANGE = 3
+} GuessFeedback;
+typedef enum
+{
+    GUESS_UNIFORM = 0,
+    GUESS_SKEWED = 1,
+    GUESS_ADVERSARIAL = 2
+} GuessDistribution;
+typedef struct
+{
+    int64_t low, high; // Inclusive range of the game.
+    int64_t secret;    // Fixed only when an adversarial game is won.
+    long attempts;     // Guesses so far, out of range ones included.
+    double noise;      // Chance that "too low" or "too high" is a lie.
+    Random* random;    // Draws the lies; only used when noise > 0.
+    int adversarial;   // Nonzero: answers are chosen, not looked up.
+    int64_t possible_low, possible_high; // Secrets the true answers still allow (adversarial).
+} GuessGame;
+typedef struct
+{
+    double mass;          // Posterior mass of the node's numbers.
+    double factor;        // Multiplier the children have not taken yet.
+    uint32_t left, right; // Children; 0 while the node is not split.
+} PosteriorNode;
+typedef struct
+{
+    PosteriorNode* nodes; // nodes[0] is the root and covers [low, high].
+    uint32_t count, capacity;
+    int64_t low, high;
+    GuessDistribution prior;
+} PosteriorTree;
+typedef struct
+{
+    int64_t low, high;             // Numbers the answers so far still allow.
+    int64_t range_low, range_high; // The game's range, to start over from after a lie.
+    Random random;                 // Generator of randomized strategies.
+    GuessDistribution prior;       // What bayes assumes about the secret.
+    double noise;                  // What bayes assumes about lies.
+    PosteriorTree posterior;       // Belief of bayes.
+} GuessState;
+typedef struct
+{
+    const char* name;
+    int64_t (*guess)(GuessState* state); // The next guess.
+    void (*feedback)(GuessState* state, int64_t guess, GuessFeedback feedback);
+    void (*start)(GuessState* state);    // Called once the range is set; may be NULL.
+} GuessStrategy;
+/*================= Global =================*/
+static const char* const guess_distribution_names[GUESS_DISTRIBUTION_COUNT] = {"uniform", "skewed", "adversarial"};
+/*================= Function Definition =================*/
+/**
+ * @brief Number of values in [low, high] as a double (2^64 for the full int64_t range).
+ */
+static inline double guess_range_size(int64_t low, int64_t high)
+{
+    return (double)((uint64_t)high - (uint64_t)low) + 1.0;
+}
+/**
+ * @brief Prior probability that the secret lies in [a, b], a sub-range of [low, high].
+ */
+static inline double guess_prior_mass(GuessDistribution distribution, int64_t low, int64_t high, int64_t a,
+                                      int64_t b)
+{
+    double size = guess_range_size(low, high);
+    if (distribution != GUESS_SKEWED)
+    {
+        return guess_range_size(a, b) / size;
+    }
+    // P(secret <= low + k) = ((k + 1) / n)^(1/3). The difference of two cube
+    // roots is rewritten as (B - A) / (B^(2/3) + (AB)^(1/3) + A^(2/3)) so
+    // narrow ranges near the top do not cancel to zero.
+    double width = guess_range_size(a, b) / size; // B - A, without the cancellation
+    double below = (double)((uint64_t)a - (uint64_t)low) / size;
+    double root_below = cbrt(below), root_through = cbrt(below + width);
+    return width / (root_through * root_through + root_below * root_through + root_below * root_below);
+}
+/**
+ * @brief Starts a game with a known secret, honest answers.
+ * @param game The game.
+ * @param low Smallest possible secret.
+ * @param high Largest possible secret.
+ * @param secret The number to guess, in [low, high].
+ */
+static inline void guess_game_start(GuessGame* game, int64_t low, int64_t high, int64_t secret)
+{
+    memset(game, 0, sizeof(*game));
+    game->low = low;
+    game->high = high;
+    game->secret = secret;
+}
+/**
+ * @brief Starts a game whose secret comes from a distribution.
+ * @param noise Chance that a "too low"/"too high" answer is a lie, 0 for an honest game.
+ * @param random Draws the secret and the lies; must outlive the game.
+ */
+static inline void guess_game_deal(GuessGame* game, int64_t low, int64_t high, GuessDistribution distribution,
+                                   double noise, Random* random)
+{
+    int64_t secret = low;
+    if (distribution == GUESS_UNIFORM)
+    {
+        secret = random_between(random, low, high);
+    }
+    else if (distribution == GUESS_SKEWED)
+    {
+        double u = random_double(random);
+        double offset = floor(guess_range_size(low, high) * u * u * u);
+        uint64_t span = (uint64_t)high - (uint64_t)low;
+        secret = (int64_t)((uint64_t)low + ((offset < (double)span) ? (uint64_t)offset : span));
+    }
+    guess_game_start(game, low, high, secret);
+    game->noise = noise;
+    game->random = random;
+    game->adversarial = (distribution == GUESS_ADVERSARIAL);
+    game->possible_low = low;
+    game->possible_high = high;
+}
+/**
+ * @brief The adversary's true answer: the side with more possible secrets.
+ */
+static inline GuessFeedback guess_adversary_answer(GuessGame* game, int64_t guess)
+{
+    if (guess < game->possible_low)
+    {
+        return GUESS_TOO_LOW;
+    }
+    if (guess > game->possible_high)
+    {
+        return GUESS_TOO_HIGH;
+    }
+    if (game->possible_low == game->possible_high)
+    {
+        game->secret = guess; // only one number is left and it was guessed
+        return GUESS_CORRECT;
+    }
+    uint64_t below = (uint64_t)guess - (uint64_t)game->possible_low;
+    uint64_t above = (uint64_t)game->possible_high - (uint64_t)guess;
+    if (below >= above)
+    {
+        game->possible_high = guess - 1;
+        return GUESS_TOO_HIGH;
+    }
+    game->possible_low = guess + 1;
+    return GUESS_TOO_LOW;
+}
+/**
+ * @brief Answers one guess and counts it.
+ */
+static inline GuessFeedback guess_game_check(GuessGame* game, int64_t guess)
+{
+    game->attempts++;
+    if (guess < game->low || guess > game->high)
+    {
+        return GUESS_OUT_OF_RANGE;
+    }
+    GuessFeedback feedback;
+    if (game->adversarial)
+    {
+        feedback = guess_adversary_answer(game, guess);
+    }
+    else if (guess < game->secret)
+    {
+        feedback = GUESS_TOO_LOW;
+    }
+    else
+    {
+        feedback = (guess > game->secret) ? GUESS_TOO_HIGH : GUESS_CORRECT;
+    }
+    if (feedback != GUESS_CORRECT && game->noise > 0 && random_double(game->random) < game->noise)
+    {
+        feedback = (feedback == GUESS_TOO_LOW) ? GUESS_TOO_HIGH : GUESS_TOO_LOW; // a lie
+    }
+    return feedback;
+}
+/**
+ * @brief Takes a new tree node, growing the pool if needed; ends the program when out of memory.
+ * @return The node's index. Earlier PosteriorNode pointers may be invalid afterwards.
+ */
+static inline uint32_t posterior_new_node(PosteriorTree* tree, double mass)
+{
+    if (tree->count == tree->capacity)
+    {
+        uint32_t capacity = (tree->capacity > 0) ? 2 * tree->capacity : POSTERIOR_INITIAL_NODES;
+        PosteriorNode* nodes = realloc(tree->nodes, capacity * sizeof(PosteriorNode));
+        if (nodes == NULL)
+        {
+            fprintf(stderr, "Out of memory.\n");
+            exit(1);
+        }
+        tree->nodes = nodes;
+        tree->capacity = capacity;
+    }
+    tree->nodes[tree->count] = (PosteriorNode){.mass = mass, .factor = 1.0, .left = 0, .right = 0};
+    return tree->count++;
+}
+/**
+ * @brief Sets the posterior back to the prior over [low, high].
+ */
+static inline void posterior_reset(PosteriorTree* tree, int64_t low, int64_t high, GuessDistribution prior)
+{
+    tree->count = 0;
+    tree->low = low;
+    tree->high = high;
+    tree->prior = prior;
+    posterior_new_node(tree, 1.0);
+}
+static inline void posterior_free(PosteriorTree* tree)
+{
+    free(tree->nodes);
+    tree->nodes = NULL;
+    tree->count = tree->capacity = 0;
+}
+static inline int64_t posterior_middle(int64_t l, int64_t r)
+{
+    return (int64_t)((uint64_t)l + ((uint64_t)r - (uint64_t)l) / 2);
+}
+/**
+ * @brief Makes sure node [l, r] (l < r) has children and hands them its pending factor.
+ */
+static inline void posterior_split(PosteriorTree* tree, uint32_t index, int64_t l, int64_t r)
+{
+    int64_t middle = posterior_middle(l, r);
+    if (tree->nodes[index].left == 0)
+    {
+        // An unsplit node's mass is spread like the prior
+        double whole = guess_prior_mass(tree->prior, tree->low, tree->high, l, r);
+        double part = guess_prior_mass(tree->prior, tree->low, tree->high, l, middle);
+        double mass = tree->nodes[index].mass;
+        double left_mass = (whole > 0) ? mass * (part / whole) : 0;
+        left_mass = (left_mass < mass) ? left_mass : mass;
+        uint32_t left = posterior_new_node(tree, left_mass);
+        uint32_t right = posterior_new_node(tree, mass - left_mass);
+        tree->nodes[index].left = left;
+        tree->nodes[index].right = right;
+        tree->nodes[index].factor = 1.0;
+        return;
+    }
+    PosteriorNode* node = &tree->nodes[index];
+    if (node->factor != 1.0)
+    {
+        PosteriorNode* children[2] = {&tree->nodes[node->left], &tree->nodes[node->right]};
+        for (int i = 0; i < 2; i++)
+        {
+            children[i]->mass *= node->factor;
+            children[i]->factor *= node->factor;
+        }
+        node->factor = 1.0;
+    }
+}
+/**
+ * @brief Multiplies the mass of [a, b] by a factor within node [l, r].
+ */
+static inline void posterior_multiply(PosteriorTree* tree, uint32_t index, int64_t l, int64_t r, int64_t a,
+                                      int64_t b, double factor)
+{
+    if (b < l || a > r)
+    {
+        return;
+    }
+    if (a <= l && r <= b)
+    {
+        tree->nodes[index].mass *= factor;
+        tree->nodes[index].factor *= factor;
+        return;
+    }
+    posterior_split(tree, index, l, r);
+    int64_t middle = posterior_middle(l, r);
+    uint32_t left = tree->nodes[index].left, right = tree->nodes[index].right;
+    posterior_multiply(tree, left, l, middle, a, b, factor);
+    posterior_multiply(tree, right, middle + 1, r, a, b, factor);
+    tree->nodes[index].mass = tree->nodes[left].mass + tree->nodes[right].mass;
+}
+/**
+ * @brief Bayes update for one answer.
+ * @param tree The posterior.
+ * @param guess The guess that was not correct.
+ * @param above Nonzero if the answer said the secret is above the guess ("too low").
+ * @param noise Assumed chance of a lie.
+ */
+static inline void posterior_observe(PosteriorTree* tree, int64_t guess, int above, double noise)
+{
+    // Likelihood of the answer: 1 - noise on the side it points to, noise on
+    // the other side, 0 for the guess itself since "correct" never lies
+    if (guess > tree->low)
+    {
+        posterior_multiply(tree, 0, tree->low, tree->high, tree->low, guess - 1, above ? noise : 1 - noise);
+    }
+    if (guess < tree->high)
+    {
+        posterior_multiply(tree, 0, tree->low, tree->high, guess + 1, tree->high, above ? 1 - noise : noise);
+    }
+    posterior_multiply(tree, 0, tree->low, tree->high, guess, guess, 0.0);
+
+    double total = tree->nodes[0].mass;
+    if (!(total > 0) || !isfinite(total))
+    {
+        // Answers the model calls impossible (lies with noise 0): start over
+        posterior_reset(tree, tree->low, tree->high, tree->prior);
+        return;
+    }
+    tree->nodes[0].mass = 1.0; // normalize, so repeated small factors cannot underflow
+    tree->nodes[0].factor /= total;
+}
+/**
+ * @brief Finds the posterior median: the number where the cumulative mass reaches one half.
+ */
+static inline int64_t posterior_median(PosteriorTree* tree)
+{
+    uint32_t index = 0;
+    int64_t l = tree->low, r = tree->high;
+    double target = tree->nodes[0].mass / 2;
+    while (l < r)
+    {
+        posterior_split(tree, index, l, r);
+        int64_t middle = posterior_middle(l, r);
+        const PosteriorNode* node = &tree->nodes[index];
+        double left_mass = tree->nodes[node->left].mass, right_mass = tree->nodes[node->right].mass;
+        // Never step into a side without mass, even if rounding says so
+        if (left_mass > 0 && (target <= left_mass || !(right_mass > 0)))
+        {
+            index = node->left;
+            r = middle;
+        }
+        else
+        {
+            target -= left_mass;
+            index = node->right;
+            l = middle + 1;
+        }
+    }
+    return l;
+}
+/**
+ * @brief Prepares a strategy state.
+ * @param state The state.
+ * @param seed Seeds the random strategy.
+ * @param prior What bayes assumes about the secret.
+ * @param noise What bayes assumes about lies.
+ */
+static inline void guess_state_init(GuessState* state, uint64_t seed, GuessDistribution prior, double noise)
+{
+    memset(state, 0, sizeof(*state));
+    random_seed(&state->random, seed);
+    state->prior = prior;
+    state->noise = noise;
+}
+static inline void guess_state_free(GuessState* state)
+{
+    posterior_free(&state->posterior);
+}
+/**
+ * @brief Narrows the possible range by one answer; the feedback callback of the simple strategies.
+ */
+static inline void guess_narrow(GuessState* state, int64_t guess, GuessFeedback feedback)
+{
+    // A lie can point past INT64_MAX or INT64_MIN, where guess +/- 1 would overflow
+    int past_edge = (feedback == GUESS_TOO_LOW && guess == INT64_MAX) || (feedback == GUESS_TOO_HIGH && guess == INT64_MIN);
+    if (feedback == GUESS_TOO_LOW && !past_edge)
+    {
+        state->low = guess + 1;
+    }
+    else if (feedback == GUESS_TOO_HIGH && !past_edge)
+    {
+        state->high = guess - 1;
+    }
+    if (past_edge || state->low > state->high) // a lie ruled the secret out
+    {
+        state->low = state->range_low;
+        state->high = state->range_high;
+    }
+}
+static inline int64_t guess_bisect(GuessState* state)
+{
+    return (int64_t)((uint64_t)state->low + ((uint64_t)state->high - (uint64_t)state->low) / 2);
+}
+static inline int64_t guess_third(GuessState* state)
+{
+    return (int64_t)((uint64_t)state->low + ((uint64_t)state->high - (uint64_t)state->low) / 3);
+}
+static inline int64_t guess_uniform(GuessState* state)
+{
+    return random_between(&state->random, state->low, state->high);
+}
+static inline void guess_bayes_start(GuessState* state)
+{
+    // The adversary has no distribution; assume every number equally likely
+    posterior_reset(&state->posterior, state->low, state->high,
+                    (state->prior == GUESS_SKEWED) ? GUESS_SKEWED : GUESS_UNIFORM);
+}
+static inline int64_t guess_bayes(GuessState* state)
+{
+    return posterior_median(&state->posterior);
+}
+static inline void guess_bayes_feedback(GuessState* state, int64_t guess, GuessFeedback feedback)
+{
+    if (feedback == GUESS_TOO_LOW || feedback == GUESS_TOO_HIGH)
+    {
+        posterior_observe(&state->posterior, guess, feedback == GUESS_TOO_LOW, state->noise);
+    }
+}
+/*================= Global =================*/
+static const GuessStrategy guess_strategies[GUESS_STRATEGY_COUNT] = {
+    {"bisect", guess_bisect, guess_narrow, NULL},
+    {"third", guess_third, guess_narrow, NULL},
+    {"random", guess_uniform, guess_narrow, NULL},
+    {"bayes", guess_bayes, guess_bayes_feedback, guess_bayes_start},
+};
+/*================= Function Definition =================*/
+/**
+ * @brief Plays one game from start to finish.
+ * @param strategy The player.
+ * @param state The player's state; its range is reset to the game's.
+ * @param game A started game.
+ * @return Guesses used, or -1 if the strategy gave up after GUESS_MAX_ATTEMPTS.
+ */
+static inline long guess_play(const GuessStrategy* strategy, GuessState* state, GuessGame* game)
+{
+    state->low = state->range_low = game->low;
+    state->high = state->range_high = game->high;
+    if (strategy->start != NULL)
+    {
+        strategy->start(state);
+    }
+    while (game->attempts < GUESS_MAX_ATTEMPTS)
+    {
+        int64_t guess = strategy->guess(state);
+        GuessFeedback feedback = guess_game_check(game, guess);
+        if (feedback == GUESS_CORRECT)
+        {
+            return game->attempts;
+        }
+        strategy->feedback(state, guess, feedback);
+    }
+    return -1;
+}
+/**
+ * @brief Worst-case guesses of bisection for a range: ceil(log2(n + 1)).
+ */
+static inline int guess_optimal_attempts(int64_t low, int64_t high)
+{
+    // The smallest k with 2^k - 1 >= n, i.e. 2^k - 2 >= n - 1
+    uint64_t span = (uint64_t)high - (uint64_t)low; // n - 1
+    int k = 1;
+    while (k < 64 && (1ULL << k) - 2 < span)
+    {
+        k++;
+    }
+    return (k == 64 && span == UINT64_MAX) ? 65 : k;
+}
+
+#endif // GUESS_ENGINE_H
@@ -3,54 +3,1040 @@ __Project Name: Number Guessing Game
 __Author: Shad Hossain Fardin
 __Date: 27th May 2025
 */
+#ifdef __linux__
+    #define _GNU_SOURCE // For accept4()
+#endif
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
-#include <stdlib.h> // for rand() and srand()
-#include <time.h>   // for seeding
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <errno.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <signal.h>
+    #include <sys/epoll.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+#endif
 
-int main()
+#include "../common/input.h" // line input without scanf()
+#include "guess_engine.h"  // headless game, strategies and solver
+#include "session_table.h" // slab session table and idle timer wheel of --serve
+/*================= Constant =================*/
+#define MIN_NUMBER 1
+#define MAX_NUMBER 100
+#define SOLVE_GAMES 1000000 // default games per strategy for --solve
+#define MAX_THREADS 64
+#define GUESS_PORT 5050           // default localhost port of --serve and --load
+#define SERVER_MAX_SESSIONS 65536 // default most sessions open at once
+#define SERVER_IDLE_SECONDS 30    // default idle time before a session is closed
+#define SERVER_TICK_MS 100        // timer wheel resolution
+#define SERVER_EVENTS 256         // epoll events taken per wait
+#define SERVER_READ_SIZE 4096
+#define SERVER_REPLY_LENGTH 64    // longest reply line: "RANGE <int64> <int64>\n"
+#define SERVER_RESERVED_FDS 16    // descriptors kept for stdio, epoll and the listener
+#define SERVER_ACCEPT_PAUSE_TICKS 5 // listener rest after running out of descriptors
+#define LOAD_CONNECTIONS 1000     // default concurrent connections of --load
+#define LOAD_SECONDS 5
+#define LOAD_GAMES 10             // default games per session before reconnecting
+/*================= Type =================*/
+typedef struct
+{
+    long games;        // per strategy, split over the threads
+    int64_t low, high; // range of the secret
+    int thread_count;
+    int strategy;      // index into guess_strategies, -1 for all
+    uint64_t seed;
+    GuessDistribution distribution; // where secrets come from
+    double noise;                   // chance that an answer lies
+} SolveSettings;
+// One thread's share of the games for one strategy.
+typedef struct
+{
+    const GuessStrategy* strategy;
+    const SolveSettings* settings;
+    int id;
+    long games;
+    long long total_attempts;
+    long worst;
+    long failures; // games the strategy gave up
+    double seconds;
+} SolveWorker;
+typedef struct
+{
+    int port;
+    int64_t low, high; // range of the secrets
+    long sessions;     // most open at once
+    int idle_seconds;
+} ServerSettings;
+// State of the --serve event loop.
+typedef struct
+{
+    SessionTable sessions;
+    int epoll_fd;
+    int64_t low, high;
+    long long accepted, rejected, expired, games, guesses;
+    uint32_t peak; // most sessions open at once so far
+    int listener_paused;      // out of descriptors: EPOLLIN is off until listener_resume
+    uint32_t listener_resume; // wheel tick to watch the listener again
+} GuessServer;
+typedef struct
+{
+    int port;
+    long connections;
+    double seconds;
+    long games; // per session
+} LoadSettings;
+// One connection of the load client, playing bisection against the server.
+typedef struct
+{
+    int fd;
+    uint32_t generation; // tells events of a closed socket from those of its replacement
+    GuessState state;
+    int64_t low, high;   // range the server announced
+    int64_t guess;
+    long games;          // finished in this session
+    int input_length;
+    char input[SERVER_REPLY_LENGTH];
+} LoadConnection;
+typedef struct
+{
+    LoadConnection* connections;
+    const LoadSettings* settings;
+    int epoll_fd;
+    long long greeted; // READY lines received
+    long long sessions, games, guesses, errors;
+} LoadClient;
+/*================= Function Prototypes =================*/
+void play_game(int64_t low, int64_t high, GuessDistribution distribution, double noise);
+int parse_arguments(int argc, char* argv[], SolveSettings* settings);
+void run_solver(const SolveSettings* settings);
+void* solve_thread(void* arg);
+int get_thread_count();
+double seconds_now();
+int run_server(int argc, char* argv[]);
+int run_load_client(int argc, char* argv[]);
+#ifdef __linux__
+long raise_file_limit(long wanted);
+int open_listener(int port);
+double monotonic_seconds();
+void request_stop(int signal_number);
+int accept_sessions(GuessServer* server, int listener);
+void start_session_game(GuessServer* server, Session* session);
+void serve_session(GuessServer* server, Session* session);
+size_t answer_guess(GuessServer* server, Session* session, char* reply);
+void close_session(GuessServer* server, Session* session);
+void expire_session(Session* session, void* context);
+int load_connect(LoadClient* client, LoadConnection* connection);
+void load_reconnect(LoadClient* client, LoadConnection* connection, int failed);
+int load_send_guess(LoadClient* client, LoadConnection* connection);
+void load_receive(LoadClient* client, LoadConnection* connection);
+int load_answer(LoadClient* client, LoadConnection* connection, const char* line);
+#endif
+/*================= Global =================*/
+#ifdef __linux__
+volatile sig_atomic_t stop_requested = 0; // set by Ctrl+C to end --serve
+#endif
+/*================= Main =================*/
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "--serve") == 0)
+        {
+            return run_server(argc, argv);
+        }
+        if (strcmp(argv[1], "--load") == 0)
+        {
+            return run_load_client(argc, argv);
+        }
+        SolveSettings settings;
+        int playing = (strcmp(argv[1], "--play") == 0);
+        if ((!playing && strcmp(argv[1], "--solve") != 0) || !parse_arguments(argc, argv, &settings))
+        {
+            printf("Usage: %s --solve [games] [--range LOW HIGH] [--threads N] [--strategy NAME] [--seed N]\n"
+                   "               [--distribution NAME] [--noise P]\n",
+                   argv[0]);
+            printf("       %s --play [--range LOW HIGH] [--distribution NAME] [--noise P]\n", argv[0]);
+            printf("       %s --serve [--port N] [--range LOW HIGH] [--sessions N] [--idle SECONDS]\n", argv[0]);
+            printf("       %s --load [connections] [--port N] [--seconds S] [--games N]\n", argv[0]);
+            printf("       strategies:");
+            for (int i = 0; i < GUESS_STRATEGY_COUNT; i++)
+            {
+                printf(" %s", guess_strategies[i].name);
+            }
+            printf("\n       distributions:");
+            for (int i = 0; i < GUESS_DISTRIBUTION_COUNT; i++)
+            {
+                printf(" %s", guess_distribution_names[i]);
+            }
+            printf("\n       noise: 0 <= P < 0.5\n");
+            return 1;
+        }
+        if (playing)
+        {
+            play_game(settings.low, settings.high, settings.distribution, settings.noise);
+            return 0;
+        }
+        run_solver(&settings);
+        return 0;
+    }
+    play_game(MIN_NUMBER, MAX_NUMBER, GUESS_UNIFORM, 0);
+    return 0;
+}
+/*================= Function Definition =================*/
+void play_game(int64_t low, int64_t high, GuessDistribution distribution, double noise)
 {
     printf("\n--------------------------------------------------------------\n");
     printf("\t\tWelcome to the Number Guessing Game!");
     printf("\n--------------------------------------------------------------\n");
 
-    int number_to_guess;
-    srand(time(NULL));                  // Seed
-    number_to_guess = rand() % 100 + 1; // Generate a random number between 1 and 100
+    GuessGame game;
+    guess_game_deal(&game, low, high, distribution, noise, random_local());
 
-    printf("***Try to guess the number I'm thinking of between 1 and 100***\n\n");
-    int guess;
-    int attempts = 0;
+    printf("***Try to guess the number I'm thinking of between %" PRId64 " and %" PRId64 "***\n\n", low, high);
+    if (noise > 0)
+    {
+        printf("***Careful: %g%% of my hints are lies!***\n\n", noise * 100);
+    }
+    int64_t guess;
     while (1)
     {
         printf("Enter your guess: ");
-        scanf("%d", &guess);
-        attempts++;
+        int status = input_int64(input_stdin(), &guess);
+        if (status < 0)
+        {
+            printf("\nNo more input. Bye bye :)\n");
+            return;
+        }
 
-        if (guess < 1 || guess > 100)
+        GuessFeedback feedback = (status == 1) ? guess_game_check(&game, guess) : GUESS_OUT_OF_RANGE;
+        if (feedback == GUESS_OUT_OF_RANGE)
         {
-            printf("Please enter a number between 1 and 100.\n\n");
+            printf("Please enter a number between %" PRId64 " and %" PRId64 ".\n\n", low, high);
             continue;
         }
-        else if (guess < number_to_guess)
+        else if (feedback == GUESS_TOO_LOW)
         {
             printf("Too low! Try again.\n");
         }
-        else if (guess > number_to_guess)
+        else if (feedback == GUESS_TOO_HIGH)
         {
             printf("Too high! Try again.\n");
         }
         else
         {
-            printf("Congratulations! You've guessed the number %d in %d attempts.\n\n", number_to_guess, attempts);
+            printf("Congratulations! You've guessed the number %" PRId64 " in %ld attempts.\n\n", game.secret,
+                   game.attempts);
             printf("Bye bye :)\n");
             printf("Thank you for playing. I hope you had fun!\n");
             printf("If you want to play again, just run the program again.\n\n");
             printf("***Developed by Shad Hossain Fardin.***\n");
             printf("Exiting...\n");
-            return 0;
+            return;
         }
         printf("\n");
     }
+}
+int parse_arguments(int argc, char* argv[], SolveSettings* settings)
+{
+    *settings = (SolveSettings){
+        .games = SOLVE_GAMES,
+        .low = MIN_NUMBER,
+        .high = MAX_NUMBER,
+        .thread_count = get_thread_count(),
+        .strategy = -1,
+        .seed = random_entropy(),
+        .distribution = GUESS_UNIFORM,
+        .noise = 0,
+    };
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--range") == 0 && i + 2 < argc)
+        {
+            settings->low = strtoll(argv[i + 1], NULL, 10);
+            settings->high = strtoll(argv[i + 2], NULL, 10);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            settings->thread_count = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            settings->seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc)
+        {
+            settings->noise = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--distribution") == 0 && i + 1 < argc)
+        {
+            i++;
+            settings->distribution = GUESS_DISTRIBUTION_COUNT;
+            for (int d = 0; d < GUESS_DISTRIBUTION_COUNT; d++)
+            {
+                if (strcmp(argv[i], guess_distribution_names[d]) == 0)
+                {
+                    settings->distribution = (GuessDistribution)d;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc)
+        {
+            i++;
+            settings->strategy = GUESS_STRATEGY_COUNT;
+            for (int s = 0; s < GUESS_STRATEGY_COUNT; s++)
+            {
+                if (strcmp(argv[i], guess_strategies[s].name) == 0)
+                {
+                    settings->strategy = s;
+                }
+            }
+        }
+        else if (i == 2 && strncmp(argv[i], "--", 2) != 0)
+        {
+            settings->games = atol(argv[i]);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    return settings->games >= 1 && settings->low <= settings->high && settings->thread_count >= 1 &&
+           settings->thread_count <= MAX_THREADS && settings->strategy < GUESS_STRATEGY_COUNT &&
+           settings->distribution < GUESS_DISTRIBUTION_COUNT && settings->noise >= 0 && settings->noise < 0.5;
+}
+void run_solver(const SolveSettings* settings)
+{
+    printf("%ld games per strategy, secrets in [%" PRId64 ", %" PRId64 "], %d threads, seed %" PRIu64 "\n",
+           settings->games, settings->low, settings->high, settings->thread_count, settings->seed);
+    printf("Secrets: %s", guess_distribution_names[settings->distribution]);
+    if (settings->noise > 0)
+    {
+        printf(", %g%% of the answers lie.\n\n", settings->noise * 100);
+    }
+    else
+    {
+        printf(". Bisection needs at most %d guesses here.\n\n", guess_optimal_attempts(settings->low, settings->high));
+    }
+    printf("%-8s %10s %8s %16s %16s\n", "Strategy", "Average", "Worst", "Games/s/thread", "Games/s total");
 
+    for (int s = 0; s < GUESS_STRATEGY_COUNT; s++)
+    {
+        if (settings->strategy >= 0 && settings->strategy != s)
+        {
+            continue;
+        }
+        SolveWorker workers[MAX_THREADS];
+        pthread_t threads[MAX_THREADS];
+        int started = 0;
+        double start = seconds_now();
+        for (int t = 0; t < settings->thread_count; t++)
+        {
+            // Spread the games evenly; the first threads take the remainder
+            long share = settings->games / settings->thread_count + (t < settings->games % settings->thread_count);
+            workers[t] = (SolveWorker){.strategy = &guess_strategies[s], .settings = settings, .id = t, .games = share};
+            if (pthread_create(&threads[started], NULL, solve_thread, &workers[t]) == 0)
+            {
+                started++;
+            }
+            else
+            {
+                solve_thread(&workers[t]); // no thread: play this share here
+            }
+        }
+        for (int t = 0; t < started; t++)
+        {
+            pthread_join(threads[t], NULL);
+        }
+        double elapsed = seconds_now() - start;
+
+        long long total_attempts = 0;
+        long worst = 0, failures = 0;
+        double per_thread = 0;
+        for (int t = 0; t < settings->thread_count; t++)
+        {
+            total_attempts += workers[t].total_attempts;
+            failures += workers[t].failures;
+            worst = (workers[t].worst > worst) ? workers[t].worst : worst;
+            per_thread += (workers[t].seconds > 0) ? workers[t].games / workers[t].seconds : 0;
+        }
+        printf("%-8s %10.3f %8ld %16.0f %16.0f\n", guess_strategies[s].name,
+               (double)total_attempts / (settings->games - failures > 0 ? settings->games - failures : 1), worst,
+               per_thread / settings->thread_count, settings->games / elapsed);
+        if (failures > 0)
+        {
+            printf("         %ld games gave up after %d guesses.\n", failures, GUESS_MAX_ATTEMPTS);
+        }
+    }
+}
+void* solve_thread(void* arg)
+{
+    SolveWorker* worker = arg;
+    const SolveSettings* settings = worker->settings;
+    // Every thread gets its own stream; the same seed replays the same games
+    Random secrets; // draws the secrets and the lies
+    GuessState state;
+    random_seed_stream(&secrets, settings->seed, (unsigned)worker->id);
+    guess_state_init(&state, random_next(&secrets), settings->distribution, settings->noise);
+    GuessGame game;
+    double start = seconds_now();
+    for (long i = 0; i < worker->games; i++)
+    {
+        guess_game_deal(&game, settings->low, settings->high, settings->distribution, settings->noise, &secrets);
+        long attempts = guess_play(worker->strategy, &state, &game);
+        if (attempts < 0)
+        {
+            worker->failures++;
+            continue;
+        }
+        worker->total_attempts += attempts;
+        worker->worst = (attempts > worker->worst) ? attempts : worker->worst;
+    }
+    worker->seconds = seconds_now() - start;
+    guess_state_free(&state);
+    return NULL;
+}
+int get_thread_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long cores = info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cores < 1)
+    {
+        return 1;
+    }
+    return (cores > MAX_THREADS) ? MAX_THREADS : (int)cores;
+}
+double seconds_now()
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+/**
+ * Serves guessing games to many clients at once on 127.0.0.1 (--serve).
+ *
+ * One thread runs an epoll loop; every connection is one session with its
+ * own secret. The protocol is line based:
+ *     server: READY <low> <high>    after connecting
+ *     client: <guess>
+ *     server: LOW | HIGH | CORRECT <attempts> | RANGE <low> <high> | ERROR
+ * After CORRECT the session starts a new game with a new secret. A full
+ * table answers BUSY and closes; a session silent for the idle time is
+ * closed. Ctrl+C stops the server and prints its totals.
+ */
+int run_server(int argc, char* argv[])
+{
+    ServerSettings settings = {
+        .port = GUESS_PORT,
+        .low = MIN_NUMBER,
+        .high = MAX_NUMBER,
+        .sessions = SERVER_MAX_SESSIONS,
+        .idle_seconds = SERVER_IDLE_SECONDS,
+    };
+    int valid = 1;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+        {
+            settings.port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--range") == 0 && i + 2 < argc)
+        {
+            settings.low = strtoll(argv[i + 1], NULL, 10);
+            settings.high = strtoll(argv[i + 2], NULL, 10);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc)
+        {
+            settings.sessions = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--idle") == 0 && i + 1 < argc)
+        {
+            settings.idle_seconds = atoi(argv[++i]);
+        }
+        else
+        {
+            valid = 0;
+        }
+    }
+    if (!valid || settings.port < 1 || settings.port > 65535 || settings.low > settings.high ||
+        settings.sessions < 1 || settings.sessions > 100000000 || settings.idle_seconds < 1)
+    {
+        printf("Usage: %s --serve [--port N] [--range LOW HIGH] [--sessions N] [--idle SECONDS]\n", argv[0]);
+        return 1;
+    }
+#ifdef __linux__
+    long descriptors = raise_file_limit(settings.sessions + SERVER_RESERVED_FDS);
+    if (settings.sessions > descriptors - SERVER_RESERVED_FDS)
+    {
+        settings.sessions = descriptors - SERVER_RESERVED_FDS;
+        printf("Open file limit: at most %ld sessions.\n", settings.sessions);
+    }
+    int listener = open_listener(settings.port);
+    if (listener < 0)
+    {
+        printf("Error: cannot listen on 127.0.0.1:%d.\n", settings.port);
+        return 1;
+    }
+    GuessServer server = {.low = settings.low, .high = settings.high};
+    server.epoll_fd = epoll_create1(0);
+    uint32_t idle_ticks = (uint32_t)settings.idle_seconds * (1000 / SERVER_TICK_MS);
+    if (!session_table_init(&server.sessions, (uint32_t)settings.sessions, idle_ticks))
+    {
+        printf("Out of memory.\n");
+        close(listener);
+        return 1;
+    }
+    struct epoll_event event = {.events = EPOLLIN, .data.u64 = UINT64_MAX}; // no session has this handle
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, listener, &event);
+    signal(SIGINT, request_stop);
+    signal(SIGTERM, request_stop);
+    printf("Serving games in [%" PRId64 ", %" PRId64 "] on 127.0.0.1:%d, up to %ld sessions, %d s idle timeout.\n",
+           settings.low, settings.high, settings.port, settings.sessions, settings.idle_seconds);
+    printf("Press Ctrl+C to stop.\n");
+    fflush(stdout);
+
+    double start = monotonic_seconds(); // the wheel must not jump with the wall clock
+    struct epoll_event events[SERVER_EVENTS];
+    while (!stop_requested)
+    {
+        int count = epoll_wait(server.epoll_fd, events, SERVER_EVENTS, SERVER_TICK_MS);
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.u64 == UINT64_MAX)
+            {
+                if (!accept_sessions(&server, listener))
+                {
+                    // The pending connection stays queued, so a level-triggered listener would wake every wait
+                    event.events = 0;
+                    epoll_ctl(server.epoll_fd, EPOLL_CTL_MOD, listener, &event);
+                    server.listener_paused = 1;
+                    server.listener_resume = server.sessions.tick + SERVER_ACCEPT_PAUSE_TICKS;
+                }
+                continue;
+            }
+            // NULL when an earlier event of this batch closed the session
+            Session* session = session_find(&server.sessions, events[i].data.u64);
+            if (session != NULL)
+            {
+                serve_session(&server, session);
+            }
+        }
+        uint32_t tick = (uint32_t)((monotonic_seconds() - start) * 1000 / SERVER_TICK_MS);
+        session_wheel_advance(&server.sessions, tick, expire_session, &server);
+        if (server.listener_paused && (int32_t)(server.sessions.tick - server.listener_resume) >= 0)
+        {
+            event.events = EPOLLIN;
+            epoll_ctl(server.epoll_fd, EPOLL_CTL_MOD, listener, &event);
+            server.listener_paused = 0;
+        }
+    }
+
+    printf("\nSessions: %lld accepted, %lld turned away, %lld expired, %" PRIu32 " open at peak\n",
+           server.accepted, server.rejected, server.expired, server.peak);
+    printf("Games: %lld won, %lld guesses in %.1f s\n", server.games, server.guesses,
+           monotonic_seconds() - start);
+    for (uint32_t i = 0; i < server.sessions.slab_count * SESSION_SLAB_SIZE; i++)
+    {
+        Session* session = session_at(&server.sessions, i);
+        if (session->fd >= 0)
+        {
+            close(session->fd);
+        }
+    }
+    session_table_free(&server.sessions);
+    close(server.epoll_fd);
+    close(listener);
+    return 0;
+#else
+    printf("The server needs Linux (epoll).\n");
+    return 1;
+#endif
+}
+/**
+ * Plays bisection against a running --serve over many connections (--load).
+ *
+ * Every connection plays `games` games, then closes and reconnects, so both
+ * session setup and guessing are measured. Prints sessions, games and
+ * guesses per second.
+ */
+int run_load_client(int argc, char* argv[])
+{
+    LoadSettings settings = {
+        .port = GUESS_PORT,
+        .connections = LOAD_CONNECTIONS,
+        .seconds = LOAD_SECONDS,
+        .games = LOAD_GAMES,
+    };
+    int valid = 1;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+        {
+            settings.port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            settings.seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+        {
+            settings.games = atol(argv[++i]);
+        }
+        else if (i == 2 && strncmp(argv[i], "--", 2) != 0)
+        {
+            settings.connections = atol(argv[i]);
+        }
+        else
+        {
+            valid = 0;
+        }
+    }
+    if (!valid || settings.port < 1 || settings.port > 65535 || settings.connections < 1 ||
+        settings.connections > 1000000 || settings.seconds <= 0 || settings.games < 1)
+    {
+        printf("Usage: %s --load [connections] [--port N] [--seconds S] [--games N]\n", argv[0]);
+        return 1;
+    }
+#ifdef __linux__
+    long descriptors = raise_file_limit(settings.connections + SERVER_RESERVED_FDS);
+    if (settings.connections > descriptors - SERVER_RESERVED_FDS)
+    {
+        settings.connections = descriptors - SERVER_RESERVED_FDS;
+        printf("Open file limit: at most %ld connections.\n", settings.connections);
+    }
+    LoadClient client = {.settings = &settings};
+    client.connections = calloc(settings.connections, sizeof(LoadConnection));
+    if (client.connections == NULL)
+    {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    client.epoll_fd = epoll_create1(0);
+    signal(SIGPIPE, SIG_IGN);
+
+    double start = seconds_now();
+    long connected = 0;
+    while (connected < settings.connections && load_connect(&client, &client.connections[connected]))
+    {
+        connected++;
+    }
+    if (connected < settings.connections)
+    {
+        printf("Error: cannot connect to 127.0.0.1:%d.\n", settings.port);
+        settings.connections = connected; // only these get closed below
+    }
+    struct epoll_event events[SERVER_EVENTS];
+    // Stops early if connections fail before the server ever answered
+    while (connected == settings.connections && seconds_now() - start < settings.seconds &&
+           (client.greeted > 0 || client.errors == 0))
+    {
+        int count = epoll_wait(client.epoll_fd, events, SERVER_EVENTS, SERVER_TICK_MS);
+        for (int i = 0; i < count; i++)
+        {
+            LoadConnection* connection = &client.connections[(uint32_t)events[i].data.u64];
+            if (connection->fd >= 0 && connection->generation == (uint32_t)(events[i].data.u64 >> 32))
+            {
+                load_receive(&client, connection);
+            }
+        }
+    }
+    double elapsed = seconds_now() - start;
+
+    for (long i = 0; i < settings.connections; i++)
+    {
+        if (client.connections[i].fd >= 0)
+        {
+            close(client.connections[i].fd);
+        }
+    }
+    free(client.connections);
+    close(client.epoll_fd);
+    if (client.greeted == 0)
+    {
+        if (connected > 0)
+        {
+            printf("Error: no game started on 127.0.0.1:%d; is --serve running?\n", settings.port);
+        }
+        return 1;
+    }
+    printf("%ld connections for %.1f s, %ld games per session\n", settings.connections, elapsed, settings.games);
+    printf("%-9s %12s %14s\n", "", "Total", "Per second");
+    printf("%-9s %12lld %14.0f\n", "Sessions", client.sessions, client.sessions / elapsed);
+    printf("%-9s %12lld %14.0f\n", "Games", client.games, client.games / elapsed);
+    printf("%-9s %12lld %14.0f\n", "Guesses", client.guesses, client.guesses / elapsed);
+    if (client.errors > 0)
+    {
+        printf("%lld connections failed or were turned away.\n", client.errors);
+    }
+    return 0;
+#else
+    printf("The load client needs Linux (epoll).\n");
+    return 1;
+#endif
+}
+#ifdef __linux__
+/**
+ * @brief Raises the soft open file limit towards `wanted`.
+ * @return The descriptors now allowed, at most `wanted`.
+ */
+long raise_file_limit(long wanted)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+    {
+        return wanted;
+    }
+    if (limit.rlim_cur < (rlim_t)wanted)
+    {
+        limit.rlim_cur = (limit.rlim_max > (rlim_t)wanted) ? (rlim_t)wanted : limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return (limit.rlim_cur >= (rlim_t)wanted) ? wanted : (long)limit.rlim_cur;
+}
+/**
+ * @brief Opens a non-blocking TCP listener on 127.0.0.1.
+ * @return The socket, or -1.
+ */
+int open_listener(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons((uint16_t)port)};
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+/**
+ * @brief Seconds on a clock that only moves forward, unlike seconds_now() when the system time is set.
+ */
+double monotonic_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+void request_stop(int signal_number)
+{
+    (void)signal_number;
+    stop_requested = 1;
+}
+/**
+ * @brief Accepts every pending connection and greets it, or turns it away when the table is full.
+ * @return 0 if the process ran out of descriptors with connections still pending, otherwise 1.
+ */
+int accept_sessions(GuessServer* server, int listener)
+{
+    while (1)
+    {
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK);
+        if (fd < 0)
+        {
+            return errno != EMFILE && errno != ENFILE; // none left, or no descriptor to take one
+        }
+        Session* session = session_alloc(&server->sessions, fd);
+        if (session == NULL)
+        {
+            send(fd, "BUSY\n", 5, MSG_NOSIGNAL);
+            close(fd);
+            server->rejected++;
+            continue;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // replies are tiny: send them at once
+        start_session_game(server, session);
+
+        struct epoll_event event = {.events = EPOLLIN, .data.u64 = session_handle(session)};
+        char greeting[SERVER_REPLY_LENGTH];
+        int length = sprintf(greeting, "READY %" PRId64 " %" PRId64 "\n", server->low, server->high);
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0 ||
+            send(fd, greeting, length, MSG_NOSIGNAL) != length)
+        {
+            close_session(server, session);
+            continue;
+        }
+        server->accepted++;
+        server->peak = (server->sessions.count > server->peak) ? server->sessions.count : server->peak;
+    }
+}
+void start_session_game(GuessServer* server, Session* session)
+{
+    session->number_to_guess = random_between(random_local(), server->low, server->high);
+    session->attempts = 0;
+}
+/**
+ * @brief Reads what a session sent and answers every complete line with one send().
+ */
+void serve_session(GuessServer* server, Session* session)
+{
+    char buffer[SERVER_READ_SIZE];
+    ssize_t received = read(session->fd, buffer, sizeof(buffer));
+    if (received <= 0)
+    {
+        if (received == 0 || (errno != EAGAIN && errno != EINTR))
+        {
+            close_session(server, session); // closed by the client, or reset
+        }
+        return;
+    }
+    session_touch(&server->sessions, session);
+
+    char reply[SERVER_READ_SIZE];
+    size_t length = 0;
+    for (ssize_t i = 0; i < received; i++)
+    {
+        if (buffer[i] != '\n')
+        {
+            if (session->input_length == SESSION_LINE_LENGTH)
+            {
+                close_session(server, session); // no guess is that long
+                return;
+            }
+            session->input[session->input_length++] = buffer[i];
+            continue;
+        }
+        if (length + SERVER_REPLY_LENGTH > sizeof(reply))
+        {
+            if (send(session->fd, reply, length, MSG_NOSIGNAL) != (ssize_t)length)
+            {
+                close_session(server, session);
+                return;
+            }
+            length = 0;
+        }
+        length += answer_guess(server, session, reply + length);
+        session->input_length = 0;
+    }
+    // A client that stops reading its answers fills the socket buffer and is dropped
+    if (length > 0 && send(session->fd, reply, length, MSG_NOSIGNAL) != (ssize_t)length)
+    {
+        close_session(server, session);
+    }
+}
+/**
+ * @brief Answers the session's buffered line as one guess.
+ * @param reply At least SERVER_REPLY_LENGTH bytes.
+ * @return Length of the reply.
+ */
+size_t answer_guess(GuessServer* server, Session* session, char* reply)
+{
+    char line[SESSION_LINE_LENGTH + 1];
+    size_t length = session->input_length;
+    if (length > 0 && session->input[length - 1] == '\r')
+    {
+        length--;
+    }
+    memcpy(line, session->input, length);
+    line[length] = '\0';
+    char* end;
+    errno = 0;
+    long long guess = strtoll(line, &end, 10);
+    if (end == line || *end != '\0' || errno == ERANGE)
+    {
+        memcpy(reply, "ERROR\n", 6);
+        return 6;
+    }
+
+    server->guesses++;
+    GuessGame game;
+    guess_game_start(&game, server->low, server->high, session->number_to_guess);
+    game.attempts = session->attempts;
+    GuessFeedback feedback = guess_game_check(&game, guess);
+    session->attempts = (uint32_t)game.attempts;
+    if (feedback == GUESS_TOO_LOW)
+    {
+        memcpy(reply, "LOW\n", 4);
+        return 4;
+    }
+    else if (feedback == GUESS_TOO_HIGH)
+    {
+        memcpy(reply, "HIGH\n", 5);
+        return 5;
+    }
+    else if (feedback == GUESS_OUT_OF_RANGE)
+    {
+        return sprintf(reply, "RANGE %" PRId64 " %" PRId64 "\n", server->low, server->high);
+    }
+    server->games++;
+    int written = sprintf(reply, "CORRECT %" PRIu32 "\n", session->attempts);
+    start_session_game(server, session);
+    return written;
+}
+void close_session(GuessServer* server, Session* session)
+{
+    close(session->fd); // also removes it from the epoll set
+    session_free(&server->sessions, session);
+}
+void expire_session(Session* session, void* context)
+{
+    GuessServer* server = context;
+    server->expired++;
+    close_session(server, session);
+}
+/**
+ * @brief Starts a non-blocking connection to the server; its READY line arrives through epoll.
+ * @return 1 on success, 0 if no socket could be opened.
+ */
+int load_connect(LoadClient* client, LoadConnection* connection)
+{
+    connection->fd = -1;
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    // Close with a reset: thousands of sessions a second would otherwise use
+    // up the local ports in TIME_WAIT
+    struct linger linger = {.l_onoff = 1, .l_linger = 0};
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons((uint16_t)client->settings->port)};
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0 && errno != EINPROGRESS)
+    {
+        close(fd);
+        return 0;
+    }
+    connection->generation++;
+    struct epoll_event event = {
+        .events = EPOLLIN,
+        .data.u64 = (uint64_t)connection->generation << 32 | (uint32_t)(connection - client->connections),
+    };
+    if (epoll_ctl(client->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+    connection->fd = fd;
+    connection->games = 0;
+    connection->input_length = 0;
+    return 1;
+}
+/**
+ * @brief Replaces a connection with a new one.
+ * @param failed Nonzero if the old one ended in an error.
+ */
+void load_reconnect(LoadClient* client, LoadConnection* connection, int failed)
+{
+    close(connection->fd);
+    client->errors += failed;
+    if (!load_connect(client, connection))
+    {
+        client->errors++; // the connection stays closed
+    }
+}
+/**
+ * @brief Sends the next bisection guess.
+ * @return 1 if sent, 0 if the connection was replaced.
+ */
+int load_send_guess(LoadClient* client, LoadConnection* connection)
+{
+    char text[SERVER_REPLY_LENGTH];
+    connection->guess = guess_bisect(&connection->state);
+    int length = sprintf(text, "%" PRId64 "\n", connection->guess);
+    if (send(connection->fd, text, length, MSG_NOSIGNAL) != length)
+    {
+        load_reconnect(client, connection, 1);
+        return 0;
+    }
+    return 1;
+}
+/**
+ * @brief Reads the server's replies and acts on every complete line.
+ */
+void load_receive(LoadClient* client, LoadConnection* connection)
+{
+    char buffer[SERVER_READ_SIZE];
+    ssize_t received = read(connection->fd, buffer, sizeof(buffer));
+    if (received <= 0)
+    {
+        if (received == 0 || (errno != EAGAIN && errno != EINTR))
+        {
+            load_reconnect(client, connection, 1);
+        }
+        return;
+    }
+    for (ssize_t i = 0; i < received; i++)
+    {
+        if (buffer[i] != '\n')
+        {
+            if (connection->input_length < SERVER_REPLY_LENGTH - 1)
+            {
+                connection->input[connection->input_length++] = buffer[i];
+            }
+            continue;
+        }
+        connection->input[connection->input_length] = '\0';
+        connection->input_length = 0;
+        if (!load_answer(client, connection, connection->input))
+        {
+            return; // the rest belongs to the closed connection
+        }
+    }
+}
+/**
+ * @brief Acts on one reply line of the server.
+ * @return 1 to keep reading this connection, 0 if it was replaced.
+ */
+int load_answer(LoadClient* client, LoadConnection* connection, const char* line)
+{
+    if (strncmp(line, "READY ", 6) == 0 &&
+        sscanf(line + 6, "%" SCNd64 " %" SCNd64, &connection->low, &connection->high) == 2)
+    {
+        client->greeted++;
+        connection->state.low = connection->state.range_low = connection->low;
+        connection->state.high = connection->state.range_high = connection->high;
+        return load_send_guess(client, connection);
+    }
+    if (strcmp(line, "LOW") == 0 || strcmp(line, "HIGH") == 0)
+    {
+        client->guesses++;
+        guess_narrow(&connection->state, connection->guess, (line[0] == 'L') ? GUESS_TOO_LOW : GUESS_TOO_HIGH);
+        return load_send_guess(client, connection);
+    }
+    if (strncmp(line, "CORRECT", 7) == 0)
+    {
+        client->guesses++;
+        client->games++;
+        if (++connection->games >= client->settings->games)
+        {
+            client->sessions++;
+            load_reconnect(client, connection, 0);
+            return 0;
+        }
+        connection->state.low = connection->low;
+        connection->state.high = connection->high;
+        return load_send_guess(client, connection);
+    }
+    load_reconnect(client, connection, 1); // BUSY, or a reply bisection never causes
     return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
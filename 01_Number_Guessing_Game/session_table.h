@@ -0,0 +1,250 @@
+/*
+ * Module Name: Session Table
+ * Date: 19th October 2026
+ *
+ * Game sessions of the guessing server. A Session is one connected player:
+ * its socket, number_to_guess, attempts and the part of a line not yet
+ * complete. The struct is 64 bytes, one cache line.
+ *
+ * Sessions live in slabs of SESSION_SLAB_SIZE that are allocated when first
+ * needed and never move, so a Session* stays valid while its session is
+ * open. Free slots are chained through `next` and reused last-in, first-out
+ * while they are still warm in the cache. A handle (index plus generation)
+ * names a session in epoll events. Freeing a slot bumps its generation, so
+ * an event queued for a closed session no longer finds anything, even if
+ * the slot already holds a new session.
+ *
+ * Idle sessions expire on a timer wheel of SESSION_WHEEL_SLOTS buckets. One
+ * bucket is checked per tick. Activity only moves the session's `expires`
+ * tick; the session is relinked when its bucket comes around and it is not
+ * due yet. A guess therefore never touches the wheel, and any idle timeout
+ * works, even one longer than a turn of the wheel.
+ *
+ * Usage:
+ *     SessionTable table;
+ *     session_table_init(&table, 65536, 300);   // close after 300 idle ticks
+ *     Session* session = session_alloc(&table, fd);
+ *     uint64_t handle = session_handle(session);
+ *     ... session_find(&table, handle), session_touch(&table, session) ...
+ *     session_wheel_advance(&table, tick, on_expire, context);
+ *     session_free(&table, session);
+ *     session_table_free(&table);
+ */
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+/*================= Constant =================*/
+#define SESSION_SLAB_SIZE 1024 // Sessions per slab (64 KiB).
+#define SESSION_LINE_LENGTH 26 // Longest guess line, '\n' excluded; an int64_t needs 20.
+#define SESSION_WHEEL_SLOTS 256 // At most 256: a session keeps its bucket in one byte.
+#define SESSION_NONE UINT32_MAX
+/*================= Type =================*/
+typedef struct
+{
+    int64_t number_to_guess;
+    uint32_t attempts;
+    int fd;              // -1 while the slot is free.
+    uint32_t generation; // Bumped on free; stale handles stop matching.
+    uint32_t next, prev; // Wheel bucket links; `next` chains the free list.
+    uint32_t expires;    // Tick at which the session counts as idle.
+    uint32_t index;      // Own slot number.
+    unsigned char bucket; // Wheel bucket it is linked in.
+    unsigned char input_length;
+    char input[SESSION_LINE_LENGTH]; // Start of a line still waiting for its '\n'.
+} Session;
+typedef struct
+{
+    Session** slabs;
+    uint32_t slab_count;  // Slabs allocated so far.
+    uint32_t capacity;    // Most sessions open at once.
+    uint32_t count;       // Sessions open now.
+    uint32_t free_head;   // First free slot of the allocated slabs.
+    uint32_t idle_ticks;  // Ticks without a guess before a session expires.
+    uint32_t tick;        // Last tick the wheel was advanced to.
+    uint32_t wheel[SESSION_WHEEL_SLOTS]; // First session of each bucket.
+} SessionTable;
+/*================= Function Definition =================*/
+static inline Session* session_at(const SessionTable* table, uint32_t index)
+{
+    return &table->slabs[index / SESSION_SLAB_SIZE][index % SESSION_SLAB_SIZE];
+}
+/**
+ * @brief Sets up an empty table; no slab is allocated yet.
+ * @param table The table.
+ * @param capacity Most sessions open at once.
+ * @param idle_ticks Ticks without activity before a session expires (at least 1).
+ * @return 1 on success, 0 if out of memory.
+ */
+static inline int session_table_init(SessionTable* table, uint32_t capacity, uint32_t idle_ticks)
+{
+    table->slab_count = 0;
+    table->capacity = capacity;
+    table->count = 0;
+    table->free_head = SESSION_NONE;
+    table->idle_ticks = (idle_ticks > 0) ? idle_ticks : 1;
+    table->tick = 0;
+    for (int i = 0; i < SESSION_WHEEL_SLOTS; i++)
+    {
+        table->wheel[i] = SESSION_NONE;
+    }
+    table->slabs = calloc((capacity + SESSION_SLAB_SIZE - 1) / SESSION_SLAB_SIZE + 1, sizeof(Session*));
+    return table->slabs != NULL;
+}
+/**
+ * @brief Releases every slab. Open sockets are left to the caller.
+ */
+static inline void session_table_free(SessionTable* table)
+{
+    for (uint32_t i = 0; i < table->slab_count; i++)
+    {
+        free(table->slabs[i]);
+    }
+    free(table->slabs);
+    table->slabs = NULL;
+}
+/**
+ * @brief Packs a session's index and generation for epoll_event.data.
+ */
+static inline uint64_t session_handle(const Session* session)
+{
+    return (uint64_t)session->generation << 32 | session->index;
+}
+/**
+ * @brief Finds the open session a handle names.
+ * @return The session, or NULL if it was closed since the handle was made.
+ */
+static inline Session* session_find(const SessionTable* table, uint64_t handle)
+{
+    uint32_t index = (uint32_t)handle;
+    if (index / SESSION_SLAB_SIZE >= table->slab_count)
+    {
+        return NULL;
+    }
+    Session* session = session_at(table, index);
+    return (session->fd >= 0 && session->generation == (uint32_t)(handle >> 32)) ? session : NULL;
+}
+static inline void session_link(SessionTable* table, Session* session)
+{
+    session->bucket = (unsigned char)(session->expires % SESSION_WHEEL_SLOTS);
+    uint32_t* head = &table->wheel[session->bucket];
+    session->prev = SESSION_NONE;
+    session->next = *head;
+    if (*head != SESSION_NONE)
+    {
+        session_at(table, *head)->prev = session->index;
+    }
+    *head = session->index;
+}
+static inline void session_unlink(SessionTable* table, Session* session)
+{
+    if (session->prev != SESSION_NONE)
+    {
+        session_at(table, session->prev)->next = session->next;
+    }
+    else
+    {
+        table->wheel[session->bucket] = session->next;
+    }
+    if (session->next != SESSION_NONE)
+    {
+        session_at(table, session->next)->prev = session->prev;
+    }
+}
+/**
+ * @brief Takes a free slot for a new connection and starts its idle timer.
+ * @return The session with an empty game, or NULL if the table is full or out of memory.
+ */
+static inline Session* session_alloc(SessionTable* table, int fd)
+{
+    if (table->count >= table->capacity)
+    {
+        return NULL;
+    }
+    if (table->free_head == SESSION_NONE)
+    {
+        // Every slab is in use: add one and chain its slots, lowest first
+        Session* slab = malloc(SESSION_SLAB_SIZE * sizeof(Session));
+        if (slab == NULL)
+        {
+            return NULL;
+        }
+        uint32_t base = table->slab_count * SESSION_SLAB_SIZE;
+        for (uint32_t i = 0; i < SESSION_SLAB_SIZE; i++)
+        {
+            slab[i].fd = -1;
+            slab[i].generation = 0;
+            slab[i].index = base + i;
+            slab[i].next = (i + 1 < SESSION_SLAB_SIZE) ? base + i + 1 : SESSION_NONE;
+        }
+        table->slabs[table->slab_count++] = slab;
+        table->free_head = base;
+    }
+    Session* session = session_at(table, table->free_head);
+    table->free_head = session->next;
+    table->count++;
+
+    session->number_to_guess = 0;
+    session->attempts = 0;
+    session->fd = fd;
+    session->input_length = 0;
+    session->expires = table->tick + table->idle_ticks;
+    session_link(table, session);
+    return session;
+}
+/**
+ * @brief Returns a session's slot to the free list; the caller closes the socket.
+ */
+static inline void session_free(SessionTable* table, Session* session)
+{
+    session_unlink(table, session);
+    session->fd = -1;
+    session->generation++;
+    session->next = table->free_head;
+    table->free_head = session->index;
+    table->count--;
+}
+/**
+ * @brief Marks a session active now; it expires idle_ticks from the current tick.
+ */
+static inline void session_touch(SessionTable* table, Session* session)
+{
+    // Only the deadline moves; session_wheel_advance() relinks it later
+    session->expires = table->tick + table->idle_ticks;
+}
+/**
+ * @brief Advances the wheel to a tick and hands every expired session to a callback.
+ * @param table The table.
+ * @param now The current tick; a tick behind the wheel's own is ignored.
+ * @param expire Called once per idle session; must close it with session_free().
+ * @param context Passed to expire.
+ */
+static inline void session_wheel_advance(SessionTable* table, uint32_t now, void (*expire)(Session*, void*),
+                                         void* context)
+{
+    while ((int32_t)(now - table->tick) > 0) // wrap-safe: only ever moves forward
+    {
+        table->tick++;
+        uint32_t bucket = table->tick % SESSION_WHEEL_SLOTS;
+        uint32_t index = table->wheel[bucket];
+        while (index != SESSION_NONE)
+        {
+            Session* session = session_at(table, index);
+            uint32_t next = session->next;
+            if ((int32_t)(session->expires - table->tick) <= 0)
+            {
+                expire(session, context);
+            }
+            else if (session->expires % SESSION_WHEEL_SLOTS != bucket)
+            {
+                // Touched since it was linked: move it to the bucket of its deadline
+                session_unlink(table, session);
+                session_link(table, session);
+            }
+            index = next;
+        }
+    }
+}
+
+#endif // SESSION_TABLE_H
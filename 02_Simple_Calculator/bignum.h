@@ -0,0 +1,854 @@
+/*
+ * Module Name: Big Numbers
+ * Date: 19th October 2026
+ *
+ * Arbitrary-precision signed decimals for the exact mode of the calculator.
+ * A BigNum is an integer mantissa times 10^-scale. The mantissa is stored
+ * as little-endian limbs in base 10^9, so parsing and printing never need
+ * a base conversion and a scale change by 9 digits is a limb shift.
+ *
+ * Small-buffer optimization: up to BIG_SMALL_LIMBS limbs (36 digits) live
+ * inside the struct, so small numbers never touch the heap. Larger ones
+ * move to a heap block that grows geometrically.
+ *
+ * Multiplication switches from the schoolbook method to Karatsuba once both
+ * operands reach BIG_KARATSUBA_THRESHOLD limbs. Division is Knuth's
+ * algorithm D, with a single-limb fast path. Addition, subtraction,
+ * multiplication and modulus are exact. Division and negative powers stop
+ * after a given number of decimals and truncate toward zero.
+ *
+ * Every result argument may also be an operand. Out of memory ends the
+ * program, like the rest of the calculator's fatal errors.
+ *
+ * Usage:
+ *     BigNum a, b, sum;
+ *     big_init(&a); big_init(&b); big_init(&sum);
+ *     big_parse(&a, "0.1"); big_parse(&b, "0.2");
+ *     big_add(&sum, &a, &b);                         // exactly 0.3
+ *     char* text = malloc(big_format_size(&sum));
+ *     big_format(&sum, text);
+ *     big_free(&a); big_free(&b); big_free(&sum);
+ */
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*================= Constant =================*/
+#define BIG_BASE 1000000000u // 10^9 per limb
+#define BIG_BASE_DIGITS 9
+#define BIG_SMALL_LIMBS 4          // Limbs stored inline (36 digits).
+#define BIG_KARATSUBA_THRESHOLD 16 // Limbs (144 digits) where Karatsuba starts to win.
+#define BIG_MAX_EXPONENT 100000    // Largest |n| big_pow() accepts.
+#define BIG_MAX_SCALE 1000000      // Most decimals a number may carry; keeps scale sums inside an int.
+/*================= Type =================*/
+typedef struct
+{
+    uint32_t* heap; // NULL while the limbs fit in small[].
+    uint32_t small[BIG_SMALL_LIMBS];
+    int length;   // Limbs in use, without leading zero limbs; 0 means zero.
+    int capacity; // Limbs available in small[] or heap.
+    int negative;
+    int scale; // Decimal digits after the point.
+} BigNum;
+/*================= Global =================*/
+static const uint32_t big_powers_of_ten[BIG_BASE_DIGITS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+/*================= Function Definition =================*/
+/**
+ * @brief Returns the limb array of a number.
+ */
+static inline uint32_t* big_limbs(BigNum* number)
+{
+    return (number->heap != NULL) ? number->heap : number->small;
+}
+static inline const uint32_t* big_limbs_const(const BigNum* number)
+{
+    return (number->heap != NULL) ? number->heap : number->small;
+}
+/**
+ * @brief Sets up a number with the value 0.
+ */
+static inline void big_init(BigNum* number)
+{
+    number->heap = NULL;
+    number->length = 0;
+    number->capacity = BIG_SMALL_LIMBS;
+    number->negative = 0;
+    number->scale = 0;
+}
+/**
+ * @brief Releases a number's heap block, if any. The number must be initialized again before reuse.
+ */
+static inline void big_free(BigNum* number)
+{
+    free(number->heap);
+    number->heap = NULL;
+}
+/**
+ * @brief Allocates memory or ends the program.
+ */
+static inline void* big_allocate(size_t size)
+{
+    void* block = malloc(size);
+    if (block == NULL)
+    {
+        fprintf(stderr, "Out of memory.\n");
+        exit(1);
+    }
+    return block;
+}
+/**
+ * @brief Makes room for a number of limbs, keeping the current ones.
+ */
+static inline void big_reserve(BigNum* number, int limbs)
+{
+    if (limbs <= number->capacity)
+    {
+        return;
+    }
+    int capacity = (limbs > 2 * number->capacity) ? limbs : 2 * number->capacity;
+    uint32_t* heap = big_allocate(capacity * sizeof(uint32_t));
+    memcpy(heap, big_limbs(number), number->length * sizeof(uint32_t));
+    free(number->heap);
+    number->heap = heap;
+    number->capacity = capacity;
+}
+/**
+ * @brief Drops leading zero limbs; a zero result is never negative.
+ */
+static inline void big_normalize(BigNum* number)
+{
+    const uint32_t* limbs = big_limbs(number);
+    while (number->length > 0 && limbs[number->length - 1] == 0)
+    {
+        number->length--;
+    }
+    if (number->length == 0)
+    {
+        number->negative = 0;
+    }
+}
+/**
+ * @brief Exchanges two numbers without copying heap blocks.
+ */
+static inline void big_swap(BigNum* a, BigNum* b)
+{
+    BigNum swap = *a;
+    *a = *b;
+    *b = swap;
+}
+/**
+ * @brief dest = src.
+ */
+static inline void big_copy(BigNum* dest, const BigNum* src)
+{
+    if (dest == src)
+    {
+        return;
+    }
+    big_reserve(dest, src->length);
+    memcpy(big_limbs(dest), big_limbs_const(src), src->length * sizeof(uint32_t));
+    dest->length = src->length;
+    dest->negative = src->negative;
+    dest->scale = src->scale;
+}
+/**
+ * @brief Sets a number to a small integer.
+ */
+static inline void big_set_int(BigNum* number, long long value)
+{
+    unsigned long long magnitude = (value < 0) ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    number->length = 0;
+    number->negative = value < 0;
+    number->scale = 0;
+    uint32_t* limbs = big_limbs(number); // three limbs always fit in small[]
+    while (magnitude > 0)
+    {
+        limbs[number->length++] = (uint32_t)(magnitude % BIG_BASE);
+        magnitude /= BIG_BASE;
+    }
+}
+/**
+ * @brief Compares magnitudes.
+ * @return -1, 0 or 1.
+ */
+static inline int big_mag_compare(const uint32_t* a, int na, const uint32_t* b, int nb)
+{
+    if (na != nb)
+    {
+        return (na < nb) ? -1 : 1;
+    }
+    for (int i = na - 1; i >= 0; i--)
+    {
+        if (a[i] != b[i])
+        {
+            return (a[i] < b[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+/**
+ * @brief x += y, where x has room for nx limbs (nx >= ny) and the sum fits.
+ */
+static inline void big_mag_add_into(uint32_t* x, int nx, const uint32_t* y, int ny)
+{
+    uint32_t carry = 0;
+    int i = 0;
+    for (; i < ny; i++)
+    {
+        uint32_t sum = x[i] + y[i] + carry;
+        carry = sum >= BIG_BASE;
+        x[i] = carry ? sum - BIG_BASE : sum;
+    }
+    for (; carry && i < nx; i++)
+    {
+        x[i]++;
+        carry = x[i] == BIG_BASE;
+        if (carry)
+        {
+            x[i] = 0;
+        }
+    }
+}
+/**
+ * @brief x -= y, where x >= y as numbers.
+ */
+static inline void big_mag_subtract_from(uint32_t* x, int nx, const uint32_t* y, int ny)
+{
+    uint32_t borrow = 0;
+    int i = 0;
+    for (; i < ny; i++)
+    {
+        uint32_t subtrahend = y[i] + borrow;
+        borrow = x[i] < subtrahend;
+        x[i] = borrow ? x[i] + BIG_BASE - subtrahend : x[i] - subtrahend;
+    }
+    for (; borrow && i < nx; i++)
+    {
+        borrow = x[i] == 0;
+        x[i] = borrow ? BIG_BASE - 1 : x[i] - 1;
+    }
+}
+/**
+ * @brief r = a * m for one limb m; r has na + 1 limbs and may be a.
+ */
+static inline void big_mag_multiply_small(uint32_t* r, const uint32_t* a, int na, uint32_t m)
+{
+    uint64_t carry = 0;
+    for (int i = 0; i < na; i++)
+    {
+        uint64_t product = (uint64_t)a[i] * m + carry;
+        r[i] = (uint32_t)(product % BIG_BASE);
+        carry = product / BIG_BASE;
+    }
+    r[na] = (uint32_t)carry;
+}
+/**
+ * @brief q = a / m for one limb m; q may be a.
+ * @return The remainder.
+ */
+static inline uint32_t big_mag_divide_small(uint32_t* q, const uint32_t* a, int na, uint32_t m)
+{
+    uint64_t remainder = 0;
+    for (int i = na - 1; i >= 0; i--)
+    {
+        uint64_t current = remainder * BIG_BASE + a[i];
+        q[i] = (uint32_t)(current / m);
+        remainder = current % m;
+    }
+    return (uint32_t)remainder;
+}
+/**
+ * @brief Schoolbook product; r has na + nb limbs and must not overlap a or b.
+ */
+static inline void big_mag_multiply_basic(uint32_t* r, const uint32_t* a, int na, const uint32_t* b, int nb)
+{
+    memset(r, 0, (size_t)(na + nb) * sizeof(uint32_t));
+    for (int i = 0; i < na; i++)
+    {
+        uint64_t carry = 0;
+        uint64_t digit = a[i];
+        if (digit == 0)
+        {
+            continue;
+        }
+        for (int j = 0; j < nb; j++)
+        {
+            uint64_t current = r[i + j] + digit * b[j] + carry;
+            r[i + j] = (uint32_t)(current % BIG_BASE);
+            carry = current / BIG_BASE;
+        }
+        r[i + nb] = (uint32_t)carry;
+    }
+}
+/**
+ * @brief Trims leading zero limbs off a length.
+ */
+static inline int big_mag_trim(const uint32_t* a, int na)
+{
+    while (na > 0 && a[na - 1] == 0)
+    {
+        na--;
+    }
+    return na;
+}
+/**
+ * @brief Product with Karatsuba above the threshold; r has na + nb limbs and must not overlap a or b.
+ */
+static inline void big_mag_multiply(uint32_t* r, const uint32_t* a, int na, const uint32_t* b, int nb)
+{
+    if (na < nb)
+    {
+        const uint32_t* swap = a;
+        a = b;
+        b = swap;
+        int length = na;
+        na = nb;
+        nb = length;
+    }
+    if (nb < BIG_KARATSUBA_THRESHOLD)
+    {
+        big_mag_multiply_basic(r, a, na, b, nb);
+        return;
+    }
+    int m = na / 2; // a = a1 * BASE^m + a0, b likewise
+    if (nb <= m)
+    {
+        // b is short: a0 * b + (a1 * b) * BASE^m, both halves still large
+        uint32_t* high = big_allocate((size_t)(na - m + nb) * sizeof(uint32_t));
+        big_mag_multiply(r, a, m, b, nb);
+        memset(r + m + nb, 0, (size_t)(na - m) * sizeof(uint32_t));
+        big_mag_multiply(high, a + m, na - m, b, nb);
+        big_mag_add_into(r + m, na + nb - m, high, big_mag_trim(high, na - m + nb));
+        free(high);
+        return;
+    }
+    int na1 = na - m, nb1 = nb - m;
+    int sum_length = na1 + 1; // a1 is the longest half
+    uint32_t* buffer = big_allocate((size_t)(4 * sum_length) * sizeof(uint32_t));
+    uint32_t* sum_a = buffer;
+    uint32_t* sum_b = buffer + sum_length;
+    uint32_t* middle = buffer + 2 * sum_length; // 2 * sum_length limbs
+
+    // z0 = a0 * b0 in r[0, 2m), z2 = a1 * b1 in r[2m, na + nb)
+    big_mag_multiply(r, a, m, b, m);
+    big_mag_multiply(r + 2 * m, a + m, na1, b + m, nb1);
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    memset(sum_a, 0, (size_t)(2 * sum_length) * sizeof(uint32_t));
+    memcpy(sum_a, a + m, na1 * sizeof(uint32_t));
+    big_mag_add_into(sum_a, sum_length, a, m);
+    memcpy(sum_b, b + m, nb1 * sizeof(uint32_t));
+    big_mag_add_into(sum_b, sum_length, b, m);
+    int la = big_mag_trim(sum_a, sum_length), lb = big_mag_trim(sum_b, sum_length);
+    memset(middle, 0, (size_t)(2 * sum_length) * sizeof(uint32_t));
+    big_mag_multiply(middle, sum_a, la, sum_b, lb);
+    big_mag_subtract_from(middle, 2 * sum_length, r, big_mag_trim(r, 2 * m));
+    big_mag_subtract_from(middle, 2 * sum_length, r + 2 * m, big_mag_trim(r + 2 * m, na1 + nb1));
+    big_mag_add_into(r + m, na + nb - m, middle, big_mag_trim(middle, 2 * sum_length));
+    free(buffer);
+}
+/**
+ * @brief Knuth's algorithm D: q = a / b, rem = a % b, for nb >= 2 and na >= nb.
+ * @param q Receives na - nb + 1 limbs.
+ * @param rem Receives nb limbs.
+ */
+static inline void big_mag_divide(uint32_t* q, uint32_t* rem, const uint32_t* a, int na, const uint32_t* b, int nb)
+{
+    // Scale both so the divisor's top limb is at least BASE / 2; the
+    // two-limb quotient estimate is then at most one too large.
+    uint32_t d = BIG_BASE / (b[nb - 1] + 1);
+    uint32_t* u = big_allocate((size_t)(na + 1 + nb + 1) * sizeof(uint32_t));
+    uint32_t* v = u + na + 1;
+    big_mag_multiply_small(u, a, na, d);
+    big_mag_multiply_small(v, b, nb, d); // v[nb] is 0
+    uint64_t top = v[nb - 1], second = v[nb - 2];
+    for (int j = na - nb; j >= 0; j--)
+    {
+        uint64_t numerator = (uint64_t)u[j + nb] * BIG_BASE + u[j + nb - 1];
+        uint64_t qhat = numerator / top;
+        uint64_t rhat = numerator % top;
+        while (qhat >= BIG_BASE || qhat * second > rhat * BIG_BASE + u[j + nb - 2])
+        {
+            qhat--;
+            rhat += top;
+            if (rhat >= BIG_BASE)
+            {
+                break;
+            }
+        }
+        // u[j, j + nb] -= qhat * v
+        uint64_t carry = 0;
+        int64_t borrow = 0;
+        for (int i = 0; i < nb; i++)
+        {
+            uint64_t product = qhat * v[i] + carry;
+            carry = product / BIG_BASE;
+            int64_t difference = (int64_t)u[i + j] - (int64_t)(product % BIG_BASE) - borrow;
+            borrow = difference < 0;
+            u[i + j] = (uint32_t)(borrow ? difference + BIG_BASE : difference);
+        }
+        int64_t difference = (int64_t)u[j + nb] - (int64_t)carry - borrow;
+        if (difference < 0) // qhat was one too large: add v back
+        {
+            qhat--;
+            uint32_t add_carry = 0;
+            for (int i = 0; i < nb; i++)
+            {
+                uint32_t sum = u[i + j] + v[i] + add_carry;
+                add_carry = sum >= BIG_BASE;
+                u[i + j] = add_carry ? sum - BIG_BASE : sum;
+            }
+            difference += add_carry;
+        }
+        u[j + nb] = (uint32_t)difference;
+        q[j] = (uint32_t)qhat;
+    }
+    big_mag_divide_small(rem, u, nb, d);
+    free(u);
+}
+/**
+ * @brief Multiplies the mantissa by 10^digits and raises the scale to match (value unchanged).
+ * @return 0 if scale is above BIG_MAX_SCALE (number is left unchanged), 1 otherwise.
+ */
+static inline int big_raise_scale(BigNum* number, int scale)
+{
+    if (scale > BIG_MAX_SCALE)
+    {
+        return 0;
+    }
+    int digits = scale - number->scale;
+    number->scale = scale;
+    if (digits <= 0 || number->length == 0)
+    {
+        return 1;
+    }
+    int shift = digits / BIG_BASE_DIGITS;
+    big_reserve(number, number->length + shift + 1);
+    uint32_t* limbs = big_limbs(number);
+    if (shift > 0)
+    {
+        memmove(limbs + shift, limbs, number->length * sizeof(uint32_t));
+        memset(limbs, 0, shift * sizeof(uint32_t));
+        number->length += shift;
+    }
+    if (digits % BIG_BASE_DIGITS != 0)
+    {
+        big_mag_multiply_small(limbs, limbs, number->length, big_powers_of_ten[digits % BIG_BASE_DIGITS]);
+        number->length++;
+        big_normalize(number);
+    }
+    return 1;
+}
+/**
+ * @brief Parses "-12.50", "3e-4" or "1000".
+ * @return Characters consumed, 0 if the text does not start with a number.
+ */
+static inline int big_parse(BigNum* number, const char* text)
+{
+    const char* cursor = text;
+    int negative = (*cursor == '-');
+    if (*cursor == '-' || *cursor == '+')
+    {
+        cursor++;
+    }
+    const char* digits = cursor;
+    int count = 0, scale = 0, point = 0;
+    for (; isdigit((unsigned char)*cursor) || (*cursor == '.' && !point); cursor++)
+    {
+        if (*cursor == '.')
+        {
+            point = 1;
+            continue;
+        }
+        count++;
+        scale += point;
+    }
+    if (count == 0 || scale > BIG_MAX_SCALE - BIG_MAX_EXPONENT)
+    {
+        return 0;
+    }
+    const char* end = cursor;
+    long exponent = 0;
+    if ((*cursor == 'e' || *cursor == 'E') &&
+        (isdigit((unsigned char)cursor[1]) || ((cursor[1] == '-' || cursor[1] == '+') && isdigit((unsigned char)cursor[2]))))
+    {
+        exponent = strtol(cursor + 1, (char**)&cursor, 10);
+        if (exponent > BIG_MAX_EXPONENT || exponent < -BIG_MAX_EXPONENT)
+        {
+            return 0;
+        }
+    }
+
+    // Fill limbs from the last digit backwards, 9 digits per limb
+    big_reserve(number, count / BIG_BASE_DIGITS + 1);
+    uint32_t* limbs = big_limbs(number);
+    number->length = 0;
+    uint32_t limb = 0;
+    int in_limb = 0;
+    for (const char* p = end - 1; p >= digits; p--)
+    {
+        if (*p == '.')
+        {
+            continue;
+        }
+        limb += (uint32_t)(*p - '0') * big_powers_of_ten[in_limb++];
+        if (in_limb == BIG_BASE_DIGITS)
+        {
+            limbs[number->length++] = limb;
+            limb = 0;
+            in_limb = 0;
+        }
+    }
+    if (in_limb > 0)
+    {
+        limbs[number->length++] = limb;
+    }
+    number->negative = negative;
+    number->scale = 0;
+    big_normalize(number);
+    scale -= (int)exponent;
+    if (scale < 0)
+    {
+        big_raise_scale(number, -scale); // 12e3: scale the mantissa up instead
+        scale = 0;
+    }
+    number->scale = scale;
+    return (int)(cursor - text);
+}
+/**
+ * @brief Bytes big_format() needs, including the terminating '\0'.
+ */
+static inline size_t big_format_size(const BigNum* number)
+{
+    return (size_t)number->length * BIG_BASE_DIGITS + number->scale + 4;
+}
+/**
+ * @brief Writes the number in plain decimal notation, without trailing fractional zeros.
+ * @return Length of the text.
+ */
+static inline size_t big_format(const BigNum* number, char* buffer)
+{
+    const uint32_t* limbs = big_limbs_const(number);
+    char* out = buffer;
+    if (number->length == 0)
+    {
+        strcpy(buffer, "0");
+        return 1;
+    }
+    if (number->negative)
+    {
+        *out++ = '-';
+    }
+    // Mantissa digits first, then move the last `scale` of them behind a point
+    char* digits = out;
+    out += sprintf(out, "%u", limbs[number->length - 1]);
+    for (int i = number->length - 2; i >= 0; i--)
+    {
+        uint32_t limb = limbs[i];
+        for (int k = BIG_BASE_DIGITS - 1; k >= 0; k--)
+        {
+            out[k] = (char)('0' + limb % 10);
+            limb /= 10;
+        }
+        out += BIG_BASE_DIGITS;
+    }
+    int length = (int)(out - digits);
+    int scale = number->scale;
+    while (scale > 0 && digits[length - 1] == '0') // trailing fractional zeros
+    {
+        length--;
+        scale--;
+    }
+    if (scale > 0)
+    {
+        int whole = length - scale;
+        if (whole <= 0)
+        {
+            // 0.000ddd: shift the digits right to make room for "0." and zeros
+            memmove(digits + 2 - whole, digits, length);
+            digits[0] = '0';
+            digits[1] = '.';
+            memset(digits + 2, '0', -whole);
+            length += 2 - whole;
+        }
+        else
+        {
+            memmove(digits + whole + 1, digits + whole, scale);
+            digits[whole] = '.';
+            length++;
+        }
+    }
+    digits[length] = '\0';
+    return (size_t)(digits + length - buffer);
+}
+/**
+ * @brief r = a + b (subtract when negate_b), exact.
+ */
+static inline void big_add_signed(BigNum* r, const BigNum* a, const BigNum* b, int negate_b)
+{
+    BigNum x, y;
+    big_init(&x);
+    big_init(&y);
+    big_copy(&x, a);
+    big_copy(&y, b);
+    y.negative ^= negate_b && y.length > 0;
+    int scale = (x.scale > y.scale) ? x.scale : y.scale;
+    big_raise_scale(&x, scale);
+    big_raise_scale(&y, scale);
+    if (big_mag_compare(big_limbs(&x), x.length, big_limbs(&y), y.length) < 0)
+    {
+        big_swap(&x, &y); // |x| >= |y|
+    }
+    big_reserve(&x, x.length + 1);
+    uint32_t* limbs = big_limbs(&x);
+    if (x.negative == y.negative)
+    {
+        limbs[x.length] = 0;
+        big_mag_add_into(limbs, x.length + 1, big_limbs(&y), y.length);
+        x.length++;
+    }
+    else
+    {
+        big_mag_subtract_from(limbs, x.length, big_limbs(&y), y.length);
+    }
+    big_normalize(&x);
+    big_swap(r, &x);
+    big_free(&x);
+    big_free(&y);
+}
+static inline void big_add(BigNum* r, const BigNum* a, const BigNum* b)
+{
+    big_add_signed(r, a, b, 0);
+}
+static inline void big_subtract(BigNum* r, const BigNum* a, const BigNum* b)
+{
+    big_add_signed(r, a, b, 1);
+}
+/**
+ * @brief r = a * b, exact; the scales add up.
+ * @return 0 if the product would carry more than BIG_MAX_SCALE decimals (r is left unchanged), 1 otherwise.
+ */
+static inline int big_multiply(BigNum* r, const BigNum* a, const BigNum* b)
+{
+    if (a->scale > BIG_MAX_SCALE - b->scale)
+    {
+        return 0;
+    }
+    BigNum product;
+    big_init(&product);
+    product.negative = a->negative != b->negative;
+    product.scale = a->scale + b->scale;
+    if (a->length > 0 && b->length > 0)
+    {
+        big_reserve(&product, a->length + b->length);
+        big_mag_multiply(big_limbs(&product), big_limbs_const(a), a->length, big_limbs_const(b), b->length);
+        product.length = a->length + b->length;
+    }
+    big_normalize(&product);
+    big_swap(r, &product);
+    big_free(&product);
+    return 1;
+}
+/**
+ * @brief Integer division of mantissas, truncated: q = |n| / |d|, rem = |n| % |d| (either may be NULL).
+ */
+static inline void big_divide_magnitudes(BigNum* q, BigNum* rem, const BigNum* n, const BigNum* d)
+{
+    BigNum quotient, remainder;
+    big_init(&quotient);
+    big_init(&remainder);
+    if (big_mag_compare(big_limbs_const(n), n->length, big_limbs_const(d), d->length) < 0)
+    {
+        big_copy(&remainder, n); // quotient 0
+    }
+    else if (d->length == 1)
+    {
+        big_reserve(&quotient, n->length);
+        uint32_t rest = big_mag_divide_small(big_limbs(&quotient), big_limbs_const(n), n->length, big_limbs_const(d)[0]);
+        quotient.length = n->length;
+        big_set_int(&remainder, rest);
+    }
+    else
+    {
+        big_reserve(&quotient, n->length - d->length + 1);
+        big_reserve(&remainder, d->length);
+        big_mag_divide(big_limbs(&quotient), big_limbs(&remainder), big_limbs_const(n), n->length,
+                       big_limbs_const(d), d->length);
+        quotient.length = n->length - d->length + 1;
+        remainder.length = d->length;
+    }
+    quotient.negative = remainder.negative = 0;
+    quotient.scale = remainder.scale = 0;
+    big_normalize(&quotient);
+    big_normalize(&remainder);
+    if (q != NULL)
+    {
+        big_swap(q, &quotient);
+    }
+    if (rem != NULL)
+    {
+        big_swap(rem, &remainder);
+    }
+    big_free(&quotient);
+    big_free(&remainder);
+}
+/**
+ * @brief r = a / b with `digits` decimals, truncated toward zero.
+ * @return 0 if b is zero or the quotient needs more than BIG_MAX_SCALE digits of shift (r is left unchanged),
+ * 1 otherwise.
+ */
+static inline int big_divide(BigNum* r, const BigNum* a, const BigNum* b, int digits)
+{
+    if (b->length == 0 || digits - a->scale > BIG_MAX_SCALE - b->scale)
+    {
+        return 0;
+    }
+    // a / b = (A / 10^sa) / (B / 10^sb); scale A or B so that A' / B' has `digits` decimals
+    BigNum n, d;
+    big_init(&n);
+    big_init(&d);
+    big_copy(&n, a);
+    big_copy(&d, b);
+    int shift = digits - a->scale + b->scale;
+    n.scale = d.scale = 0;
+    if (shift >= 0)
+    {
+        big_raise_scale(&n, shift);
+    }
+    else
+    {
+        big_raise_scale(&d, -shift);
+    }
+    n.scale = d.scale = 0;
+    int negative = a->negative != b->negative;
+    big_divide_magnitudes(&n, NULL, &n, &d);
+    n.negative = negative && n.length > 0;
+    n.scale = digits;
+    big_swap(r, &n);
+    big_free(&n);
+    big_free(&d);
+    return 1;
+}
+/**
+ * @brief r = a - trunc(a / b) * b, exact; the sign follows a, like fmod().
+ * @return 0 if b is zero (r is left unchanged), 1 otherwise.
+ */
+static inline int big_modulus(BigNum* r, const BigNum* a, const BigNum* b)
+{
+    if (b->length == 0)
+    {
+        return 0;
+    }
+    BigNum n, d;
+    big_init(&n);
+    big_init(&d);
+    big_copy(&n, a);
+    big_copy(&d, b);
+    int scale = (n.scale > d.scale) ? n.scale : d.scale;
+    big_raise_scale(&n, scale);
+    big_raise_scale(&d, scale);
+    int negative = a->negative;
+    big_divide_magnitudes(NULL, &n, &n, &d);
+    n.negative = negative && n.length > 0;
+    n.scale = scale;
+    big_swap(r, &n);
+    big_free(&n);
+    big_free(&d);
+    return 1;
+}
+/**
+ * @brief r = a ^ exponent by repeated squaring; negative exponents divide with `digits` decimals.
+ * @return 0 for 0 ^ negative, |exponent| > BIG_MAX_EXPONENT or a power with more than BIG_MAX_SCALE
+ * decimals (r is left unchanged), 1 otherwise.
+ */
+static inline int big_pow(BigNum* r, const BigNum* a, long exponent, int digits)
+{
+    if (exponent > BIG_MAX_EXPONENT || exponent < -BIG_MAX_EXPONENT || (exponent < 0 && a->length == 0))
+    {
+        return 0;
+    }
+    long n = (exponent < 0) ? -exponent : exponent;
+    if ((long long)a->scale * n > BIG_MAX_SCALE) // the power's scale; squaring never passes it
+    {
+        return 0;
+    }
+    BigNum result, base;
+    big_init(&result);
+    big_init(&base);
+    big_set_int(&result, 1);
+    big_copy(&base, a);
+    for (; n > 0; n >>= 1)
+    {
+        if (n & 1)
+        {
+            big_multiply(&result, &result, &base);
+        }
+        if (n > 1)
+        {
+            big_multiply(&base, &base, &base);
+        }
+    }
+    int ok = 1;
+    if (exponent < 0)
+    {
+        big_set_int(&base, 1);
+        ok = big_divide(&result, &base, &result, digits);
+    }
+    if (ok)
+    {
+        big_swap(r, &result);
+    }
+    big_free(&result);
+    big_free(&base);
+    return ok;
+}
+/**
+ * @brief Compares two numbers.
+ * @return -1, 0 or 1.
+ */
+static inline int big_compare(const BigNum* a, const BigNum* b)
+{
+    BigNum difference;
+    big_init(&difference);
+    big_subtract(&difference, a, b);
+    int result = (difference.length == 0) ? 0 : difference.negative ? -1 : 1;
+    big_free(&difference);
+    return result;
+}
+/**
+ * @brief Converts an integer-valued number to a long long.
+ * @return 1 on success, 0 if it has a fraction or does not fit.
+ */
+static inline int big_to_long(const BigNum* number, long long* value)
+{
+    BigNum whole, rest, unit;
+    big_init(&whole);
+    big_init(&rest);
+    big_init(&unit);
+    big_set_int(&unit, 1);
+    // whole = mantissa / 10^scale, rest = the fraction digits
+    big_copy(&whole, number);
+    whole.scale = 0;
+    big_raise_scale(&unit, number->scale);
+    unit.scale = 0;
+    big_divide_magnitudes(&whole, &rest, &whole, &unit);
+    int ok = rest.length == 0 && whole.length <= 2;
+    if (ok)
+    {
+        const uint32_t* limbs = big_limbs(&whole);
+        long long magnitude = (whole.length > 0 ? limbs[0] : 0) + (whole.length > 1 ? (long long)limbs[1] * BIG_BASE : 0);
+        *value = number->negative ? -magnitude : magnitude;
+    }
+    big_free(&whole);
+    big_free(&rest);
+    big_free(&unit);
+    return ok;
+}
+
+#endif // BIGNUM_H
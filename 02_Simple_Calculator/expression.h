@@ -0,0 +1,1068 @@
+/*
+ * Module Name: Expression Engine
+ * Date: 19th October 2026
+ *
+ * Compiles arithmetic expressions such as "2 * (x + 3) ^ 2 - sqrt(y)" once
+ * and evaluates them many times. The tokenizer feeds a precedence-climbing
+ * parser that builds a small tree in a fixed array. Variable names are
+ * resolved to slots at compile time.
+ *
+ * expr_optimize() then rewrites the tree:
+ *     constant folding           2 * 3 + x      -> 6 + x
+ *     algebraic identities       x * 1, x - 0, x ^ 1, --x -> x;  x ^ 0 -> 1
+ *                                (unless x divides, so its error is not lost)
+ *     strength reduction         x * 2 -> x + x,  x ^ 2 -> x * x,
+ *                                x / 4 -> x * 0.25 (only when 1/c is exact)
+ *     common subexpressions      every node is hash-consed, so equal
+ *                                subtrees (also a+b and b+a) are one node
+ * Division by a constant zero is not folded, so the error is still reported.
+ * Every rule is exact in IEEE arithmetic, signed zeros and infinities included
+ * (x + 0 is not x when x is -0), so an optimized program returns exactly what
+ * the tree returns.
+ *
+ * The optimized tree is compiled to a flat array of three-address register
+ * instructions. Constants live in preloaded registers and each shared node
+ * is computed once. Registers are reused once their last reader is done.
+ *
+ * Grammar (lowest to highest precedence):
+ *     + -          left associative
+ *     * / %        left associative
+ *     unary - +
+ *     ^            right associative, binds tighter than unary minus (-2^2 = -4)
+ *     numbers, variables, pi, e, f(x), f(x, y), ( ... )
+ *
+ * expr_evaluate_batch() runs the same code over up to EXPR_LANES rows at
+ * once. Every register is then an array of lanes, and each instruction is
+ * one loop over contiguous doubles that the compiler turns into SIMD code.
+ * A zero divisor does not stop the batch: that lane becomes NaN and is
+ * marked in a per-lane mask with a select, not a branch.
+ *
+ * Usage:
+ *     ExprVariables variables = {0};
+ *     int x = expr_define_variable(&variables, "x");
+ *     ExprProgram program;
+ *     ExprError error;
+ *     if (expr_compile("x^2 + 1", &variables, &program, &error))
+ *     {
+ *         variables.values[x] = 3;
+ *         int status;
+ *         double result = expr_evaluate(&program, variables.values, &status); // 10
+ *     }
+ */
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*================= Constant =================*/
+#define EXPR_MAX_NODES 256     // Tree nodes, and so instructions, per expression.
+#define EXPR_MAX_DEPTH 100     // Nested parentheses, calls and powers (bounds the parser's recursion).
+#define EXPR_MAX_VARIABLES 64
+#define EXPR_NAME_LENGTH 32
+#define EXPR_MESSAGE_LENGTH 64
+#define EXPR_LANES 1024        // Rows per expr_evaluate_batch() call.
+/*================= Type =================*/
+typedef enum
+{
+    EXPR_OK = 0,
+    EXPR_DIVISION_BY_ZERO = 1 // Set by '/' or '%' with a zero divisor; the result is inf or nan.
+} ExprStatus;
+typedef enum
+{
+    EXPR_NUMBER,
+    EXPR_VARIABLE,
+    EXPR_NEGATE,
+    EXPR_ADD,
+    EXPR_SUBTRACT,
+    EXPR_MULTIPLY,
+    EXPR_DIVIDE,
+    EXPR_MODULUS,
+    EXPR_POWER,
+    EXPR_CALL
+} ExprNodeType;
+typedef enum
+{
+    EXPR_FN_SIN,
+    EXPR_FN_COS,
+    EXPR_FN_TAN,
+    EXPR_FN_SQRT,
+    EXPR_FN_ABS,
+    EXPR_FN_LOG,
+    EXPR_FN_LOG10,
+    EXPR_FN_EXP,
+    EXPR_FN_FLOOR,
+    EXPR_FN_CEIL,
+    EXPR_FN_ROUND,
+    EXPR_FN_MIN,
+    EXPR_FN_MAX,
+    EXPR_FN_POW,
+    EXPR_FUNCTION_COUNT
+} ExprFunction;
+typedef struct
+{
+    ExprNodeType type;
+    int left, right; // Child node indices, -1 when absent.
+    int index;       // Variable slot or ExprFunction.
+    double value;    // EXPR_NUMBER only.
+    int position;    // Where a number literal starts in the text, -1 for other nodes.
+} ExprNode;
+typedef struct
+{
+    ExprNode nodes[EXPR_MAX_NODES];
+    int count;
+    int root;
+} ExprTree;
+typedef enum
+{
+    EXPR_OP_LOAD,     // r[dest] = variables[a]
+    EXPR_OP_NEGATE,   // r[dest] = -r[a]
+    EXPR_OP_ADD,      // r[dest] = r[a] + r[b]
+    EXPR_OP_SUBTRACT, // r[dest] = r[a] - r[b]
+    EXPR_OP_MULTIPLY, // r[dest] = r[a] * r[b]
+    EXPR_OP_DIVIDE,   // r[dest] = r[a] / r[b]
+    EXPR_OP_MODULUS,  // r[dest] = fmod(r[a], r[b])
+    EXPR_OP_POWER,    // r[dest] = pow(r[a], r[b])
+    EXPR_OP_CALL1,    // r[dest] = function(r[a])
+    EXPR_OP_CALL2     // r[dest] = function(r[a], r[b])
+} ExprOpcode;
+typedef struct
+{
+    unsigned char opcode;   // ExprOpcode
+    unsigned char function; // ExprFunction of calls
+    short dest, a, b;       // Registers; a is a variable slot for EXPR_OP_LOAD.
+} ExprInstruction;
+typedef struct
+{
+    ExprInstruction code[EXPR_MAX_NODES];
+    int length;
+    double constants[EXPR_MAX_NODES]; // Preloaded into registers 0 .. constant_count - 1.
+    int constant_count;
+    int register_count;
+    int result; // Register holding the value of the expression.
+} ExprProgram;
+#if defined(__GNUC__)
+// GCC/Clang vector extensions: 4 doubles per operation (SSE2 pairs, or one AVX register).
+// may_alias and aligned(8) let them load straight from any double array.
+#define EXPR_VECTOR_LANES 4
+typedef double ExprVector __attribute__((vector_size(32), aligned(8), may_alias));
+typedef long long ExprMask __attribute__((vector_size(32), aligned(8), may_alias));
+#endif
+// Symbol table: names are bound to slots; values are read by the evaluator.
+typedef struct
+{
+    char names[EXPR_MAX_VARIABLES][EXPR_NAME_LENGTH];
+    double values[EXPR_MAX_VARIABLES];
+    int count;
+} ExprVariables;
+typedef struct
+{
+    int position; // Offset in the text where the problem was found.
+    char message[EXPR_MESSAGE_LENGTH];
+} ExprError;
+// Parser state; only used while compiling.
+typedef struct
+{
+    const char* text;
+    int position;
+    ExprVariables* variables;
+    ExprTree* tree;
+    ExprError* error;
+    int depth; // Nesting of expr_parse_unary() calls.
+} ExprParser;
+/*================= Global =================*/
+static const struct
+{
+    const char* name;
+    int arity;
+} expr_functions[EXPR_FUNCTION_COUNT] = {
+    {"sin", 1},   {"cos", 1},   {"tan", 1}, {"sqrt", 1}, {"abs", 1}, {"log", 1}, {"log10", 1},
+    {"exp", 1},   {"floor", 1}, {"ceil", 1}, {"round", 1}, {"min", 2}, {"max", 2}, {"pow", 2},
+};
+static const double expr_powers_of_ten[23] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+/*================= Function Definition =================*/
+/**
+ * @brief Finds a variable slot by name.
+ * @return The slot, or -1 if the name is not defined.
+ */
+static inline int expr_find_variable(const ExprVariables* variables, const char* name, int length)
+{
+    for (int i = 0; i < variables->count; i++)
+    {
+        if ((int)strlen(variables->names[i]) == length && strncmp(variables->names[i], name, length) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+/**
+ * @brief Defines a variable (value 0) or returns the slot it already has.
+ * @return The slot, or -1 if the table is full or the name is too long.
+ */
+static inline int expr_define_variable(ExprVariables* variables, const char* name)
+{
+    int length = (int)strlen(name);
+    int slot = expr_find_variable(variables, name, length);
+    if (slot >= 0)
+    {
+        return slot;
+    }
+    if (variables->count == EXPR_MAX_VARIABLES || length == 0 || length >= EXPR_NAME_LENGTH)
+    {
+        return -1;
+    }
+    slot = variables->count++;
+    strcpy(variables->names[slot], name);
+    variables->values[slot] = 0;
+    return slot;
+}
+/**
+ * @brief Applies a built-in function.
+ */
+static inline double expr_apply_function(int function, double a, double b)
+{
+    switch (function)
+    {
+    case EXPR_FN_SIN:
+        return sin(a);
+    case EXPR_FN_COS:
+        return cos(a);
+    case EXPR_FN_TAN:
+        return tan(a);
+    case EXPR_FN_SQRT:
+        return sqrt(a);
+    case EXPR_FN_ABS:
+        return fabs(a);
+    case EXPR_FN_LOG:
+        return log(a);
+    case EXPR_FN_LOG10:
+        return log10(a);
+    case EXPR_FN_EXP:
+        return exp(a);
+    case EXPR_FN_FLOOR:
+        return floor(a);
+    case EXPR_FN_CEIL:
+        return ceil(a);
+    case EXPR_FN_ROUND:
+        return round(a);
+    case EXPR_FN_MIN:
+        return (a < b) ? a : b;
+    case EXPR_FN_MAX:
+        return (a > b) ? a : b;
+    default: // EXPR_FN_POW
+        return pow(a, b);
+    }
+}
+/**
+ * @brief Records the first error and returns -1 so callers can bail out in one line.
+ */
+static inline int expr_fail(ExprParser* parser, const char* message)
+{
+    if (parser->error->message[0] == '\0')
+    {
+        parser->error->position = parser->position;
+        snprintf(parser->error->message, EXPR_MESSAGE_LENGTH, "%s", message);
+    }
+    return -1;
+}
+/**
+ * @brief Skips blanks and returns the next character without consuming it.
+ */
+static inline char expr_peek(ExprParser* parser)
+{
+    while (isspace((unsigned char)parser->text[parser->position]))
+    {
+        parser->position++;
+    }
+    return parser->text[parser->position];
+}
+/**
+ * @brief Appends a node to the tree.
+ * @return The node index, or -1 if the expression is too long.
+ */
+static inline int expr_add_node(ExprParser* parser, ExprNodeType type, int left, int right)
+{
+    if (left < 0 && type != EXPR_NUMBER && type != EXPR_VARIABLE)
+    {
+        return -1; // A child failed; the error is already recorded.
+    }
+    if (parser->tree->count == EXPR_MAX_NODES)
+    {
+        return expr_fail(parser, "expression too long");
+    }
+    int index = parser->tree->count++;
+    parser->tree->nodes[index] = (ExprNode){.type = type, .left = left, .right = right, .position = -1};
+    return index;
+}
+static inline int expr_parse_binary(ExprParser* parser, int min_precedence);
+/**
+ * @brief Reads a number literal like strtod(), with a fast path for plain decimals.
+ *
+ * Up to 15 digits and 22 decimals, m and 10^k are both exact doubles, so
+ * m / 10^k is one correctly rounded division: the same double strtod()
+ * returns. Longer literals, exponents and hex fall back to strtod().
+ */
+static inline double expr_read_number(const char* text, char** end)
+{
+    const char* cursor = text;
+    unsigned long long mantissa = 0;
+    int digits = 0, decimals = 0;
+    for (; isdigit((unsigned char)*cursor); cursor++, digits++)
+    {
+        mantissa = mantissa * 10 + (unsigned long long)(*cursor - '0');
+    }
+    if (*cursor == '.')
+    {
+        for (cursor++; isdigit((unsigned char)*cursor); cursor++, digits++, decimals++)
+        {
+            mantissa = mantissa * 10 + (unsigned long long)(*cursor - '0');
+        }
+    }
+    if (digits == 0 || digits > 15 || decimals > 22 || *cursor == 'e' || *cursor == 'E' || *cursor == 'x' ||
+        *cursor == 'X')
+    {
+        return strtod(text, end);
+    }
+    *end = (char*)cursor;
+    return (double)mantissa / expr_powers_of_ten[decimals];
+}
+/**
+ * @brief Parses a number, a name, a call or a parenthesised expression.
+ */
+static inline int expr_parse_primary(ExprParser* parser)
+{
+    char c = expr_peek(parser);
+    const char* start = parser->text + parser->position;
+    if (isdigit((unsigned char)c) || c == '.')
+    {
+        char* end;
+        double value = expr_read_number(start, &end);
+        if (end == start)
+        {
+            return expr_fail(parser, "invalid number");
+        }
+        int node = expr_add_node(parser, EXPR_NUMBER, -1, -1);
+        if (node >= 0)
+        {
+            parser->tree->nodes[node].value = value;
+            parser->tree->nodes[node].position = parser->position; // exact mode re-reads the digits
+        }
+        parser->position += (int)(end - start);
+        return node;
+    }
+    if (isalpha((unsigned char)c) || c == '_')
+    {
+        int length = 0;
+        while (isalnum((unsigned char)start[length]) || start[length] == '_')
+        {
+            length++;
+        }
+        parser->position += length;
+        if (expr_peek(parser) == '(')
+        {
+            int function = 0;
+            while (function < EXPR_FUNCTION_COUNT && !((int)strlen(expr_functions[function].name) == length &&
+                                                       strncmp(expr_functions[function].name, start, length) == 0))
+            {
+                function++;
+            }
+            if (function == EXPR_FUNCTION_COUNT)
+            {
+                parser->position -= length;
+                return expr_fail(parser, "unknown function");
+            }
+            parser->position++; // '('
+            int left = expr_parse_binary(parser, 1);
+            if (left < 0)
+            {
+                return -1; // The failure may sit on the terminator: consume nothing more
+            }
+            int right = -1;
+            if (expr_functions[function].arity == 2)
+            {
+                if (expr_peek(parser) != ',')
+                {
+                    return expr_fail(parser, "expected ','");
+                }
+                parser->position++;
+                right = expr_parse_binary(parser, 1);
+                if (right < 0)
+                {
+                    return -1;
+                }
+            }
+            if (expr_peek(parser) != ')')
+            {
+                return expr_fail(parser, "expected ')'");
+            }
+            parser->position++;
+            int node = expr_add_node(parser, EXPR_CALL, left, right);
+            if (node >= 0)
+            {
+                parser->tree->nodes[node].index = function;
+            }
+            return node;
+        }
+        int slot = expr_find_variable(parser->variables, start, length);
+        if (slot < 0 && ((length == 2 && strncmp(start, "pi", 2) == 0) || (length == 1 && start[0] == 'e')))
+        {
+            int node = expr_add_node(parser, EXPR_NUMBER, -1, -1);
+            if (node >= 0)
+            {
+                parser->tree->nodes[node].value = (length == 2) ? 3.14159265358979323846 : 2.71828182845904523536;
+            }
+            return node;
+        }
+        if (slot < 0)
+        {
+            parser->position -= length;
+            return expr_fail(parser, "unknown variable");
+        }
+        int node = expr_add_node(parser, EXPR_VARIABLE, -1, -1);
+        if (node >= 0)
+        {
+            parser->tree->nodes[node].index = slot;
+        }
+        return node;
+    }
+    if (c == '(')
+    {
+        parser->position++;
+        int node = expr_parse_binary(parser, 1);
+        if (node < 0)
+        {
+            return -1;
+        }
+        if (expr_peek(parser) != ')')
+        {
+            return expr_fail(parser, "expected ')'");
+        }
+        parser->position++;
+        return node;
+    }
+    return expr_fail(parser, (c == '\0') ? "unexpected end of expression" : "unexpected character");
+}
+/**
+ * @brief Parses unary signs. '^' binds tighter, so -2^2 is -(2^2).
+ * Every level of parentheses, call arguments and powers passes through here,
+ * so this is where the nesting depth is limited.
+ */
+static inline int expr_parse_unary(ExprParser* parser)
+{
+    if (parser->depth == EXPR_MAX_DEPTH)
+    {
+        return expr_fail(parser, "expression too deep");
+    }
+    parser->depth++;
+    // A run of signs is read in a loop; only its parity matters.
+    int negate = 0;
+    char c = expr_peek(parser);
+    while (c == '-' || c == '+')
+    {
+        negate ^= (c == '-');
+        parser->position++;
+        c = expr_peek(parser);
+    }
+    int node = expr_parse_primary(parser);
+    if (node >= 0 && expr_peek(parser) == '^')
+    {
+        parser->position++;
+        int exponent = expr_parse_unary(parser); // right associative; allows 2^-1
+        node = (exponent < 0) ? -1 : expr_add_node(parser, EXPR_POWER, node, exponent);
+    }
+    if (negate)
+    {
+        node = expr_add_node(parser, EXPR_NEGATE, node, -1);
+    }
+    parser->depth--;
+    return node;
+}
+/**
+ * @brief Precedence climbing over the binary operators + - * / %.
+ * @param min_precedence Lowest operator precedence this call may consume.
+ */
+static inline int expr_parse_binary(ExprParser* parser, int min_precedence)
+{
+    int left = expr_parse_unary(parser);
+    while (left >= 0)
+    {
+        char c = expr_peek(parser);
+        int precedence = (c == '+' || c == '-') ? 1 : (c == '*' || c == '/' || c == '%') ? 2 : 0;
+        if (precedence == 0 || precedence < min_precedence)
+        {
+            break;
+        }
+        parser->position++;
+        int right = expr_parse_binary(parser, precedence + 1); // left associative
+        if (right < 0)
+        {
+            return -1;
+        }
+        ExprNodeType type = (c == '+')   ? EXPR_ADD
+                            : (c == '-') ? EXPR_SUBTRACT
+                            : (c == '*') ? EXPR_MULTIPLY
+                            : (c == '/') ? EXPR_DIVIDE
+                                         : EXPR_MODULUS;
+        left = expr_add_node(parser, type, left, right);
+    }
+    return left;
+}
+/**
+ * @brief Parses an expression into a tree.
+ * @param text The expression.
+ * @param variables Names the expression may use.
+ * @param tree Receives the tree.
+ * @param error Receives the position and reason on failure.
+ * @return 1 on success, 0 on a syntax error.
+ */
+static inline int expr_parse(const char* text, ExprVariables* variables, ExprTree* tree, ExprError* error)
+{
+    ExprParser parser = {.text = text, .variables = variables, .tree = tree, .error = error};
+    error->position = 0;
+    error->message[0] = '\0';
+    tree->count = 0;
+    tree->root = expr_parse_binary(&parser, 1);
+    if (tree->root >= 0 && expr_peek(&parser) != '\0')
+    {
+        tree->root = expr_fail(&parser, "unexpected character");
+    }
+    return tree->root >= 0;
+}
+/**
+ * @brief Applies the operator of a node to operand values.
+ */
+static inline double expr_apply(ExprNodeType type, int function, double a, double b)
+{
+    switch (type)
+    {
+    case EXPR_NEGATE:
+        return -a;
+    case EXPR_ADD:
+        return a + b;
+    case EXPR_SUBTRACT:
+        return a - b;
+    case EXPR_MULTIPLY:
+        return a * b;
+    case EXPR_DIVIDE:
+        return a / b;
+    case EXPR_MODULUS:
+        return fmod(a, b);
+    case EXPR_POWER:
+        return pow(a, b);
+    default: // EXPR_CALL
+        return expr_apply_function(function, a, b);
+    }
+}
+/**
+ * @brief Evaluates a tree by walking it; the reference the compiled code must match.
+ * @param tree The tree.
+ * @param index Node to evaluate, usually tree->root.
+ * @param variables Values indexed by variable slot.
+ * @param flags EXPR_DIVISION_BY_ZERO is or-ed in when a divisor is zero.
+ */
+static inline double expr_evaluate_tree(const ExprTree* tree, int index, const double* variables, int* flags)
+{
+    const ExprNode* node = &tree->nodes[index];
+    if (node->type == EXPR_NUMBER)
+    {
+        return node->value;
+    }
+    if (node->type == EXPR_VARIABLE)
+    {
+        return variables[node->index];
+    }
+    double a = expr_evaluate_tree(tree, node->left, variables, flags);
+    double b = (node->right >= 0) ? expr_evaluate_tree(tree, node->right, variables, flags) : 0;
+    if (node->type == EXPR_DIVIDE || node->type == EXPR_MODULUS)
+    {
+        *flags |= (b == 0);
+    }
+    return expr_apply(node->type, node->index, a, b);
+}
+/**
+ * @brief Returns the node equal to the given one, appending it if it is new (hash-consing).
+ * @return The node index, or -1 if the tree is full.
+ */
+static inline int expr_intern(ExprTree* tree, ExprNode node)
+{
+    for (int i = 0; i < tree->count; i++)
+    {
+        const ExprNode* other = &tree->nodes[i];
+        if (other->type == node.type && other->left == node.left && other->right == node.right &&
+            other->index == node.index && memcmp(&other->value, &node.value, sizeof(double)) == 0)
+        {
+            return i;
+        }
+    }
+    if (tree->count == EXPR_MAX_NODES)
+    {
+        return -1;
+    }
+    tree->nodes[tree->count] = node;
+    return tree->count++;
+}
+static inline int expr_constant(ExprTree* tree, double value)
+{
+    return expr_intern(tree, (ExprNode){.type = EXPR_NUMBER, .left = -1, .right = -1, .value = value, .position = -1});
+}
+static inline int expr_operation(ExprTree* tree, ExprNodeType type, int left, int right)
+{
+    return (left < 0 || right < -1) ? -1 : expr_intern(tree, (ExprNode){.type = type, .left = left, .right = right, .position = -1});
+}
+/**
+ * @brief Tells whether a subtree contains '/' or '%', i.e. may report a zero divisor.
+ */
+static inline int expr_has_division(const ExprTree* tree, int index)
+{
+    const ExprNode* node = &tree->nodes[index];
+    if (node->type == EXPR_DIVIDE || node->type == EXPR_MODULUS)
+    {
+        return 1;
+    }
+    return (node->left >= 0 && expr_has_division(tree, node->left)) ||
+           (node->right >= 0 && expr_has_division(tree, node->right));
+}
+/**
+ * @brief Adds a node whose children are already simplified, applying the rewrite rules.
+ * @param tree The tree being built.
+ * @param node The node, with child indices into tree.
+ * @return Index of the equivalent node in tree, or -1 if the tree is full.
+ */
+static inline int expr_simplify(ExprTree* tree, ExprNode node)
+{
+    if (node.type == EXPR_NUMBER || node.type == EXPR_VARIABLE)
+    {
+        return expr_intern(tree, node);
+    }
+    const ExprNode* left = &tree->nodes[node.left];
+    const ExprNode* right = (node.right >= 0) ? &tree->nodes[node.right] : NULL;
+    int left_constant = left->type == EXPR_NUMBER;
+    int right_constant = right == NULL || right->type == EXPR_NUMBER;
+    double value = (right != NULL) ? right->value : 0;
+
+    // Constant folding; a zero divisor is left for run time so it is still reported.
+    if (left_constant && right_constant && !((node.type == EXPR_DIVIDE || node.type == EXPR_MODULUS) && value == 0))
+    {
+        return expr_constant(tree, expr_apply(node.type, node.index, left->value, value));
+    }
+    if ((node.type == EXPR_ADD || node.type == EXPR_MULTIPLY) && left_constant)
+    {
+        // Commutative: keep the constant on the right so one set of rules covers both sides.
+        int swap = node.left;
+        node.left = node.right;
+        node.right = swap;
+        left = &tree->nodes[node.left];
+        left_constant = 0;
+        right_constant = 1;
+        value = tree->nodes[node.right].value;
+    }
+    int x = node.left;
+    switch (node.type)
+    {
+    case EXPR_NEGATE:
+        if (left->type == EXPR_NEGATE)
+        {
+            return left->left; // --x
+        }
+        break;
+    case EXPR_ADD:
+    case EXPR_SUBTRACT:
+        // Only the forms that keep the sign of zero: x + (-0), x - (+0), (-0) - y
+        if (right_constant && value == 0 && (node.type == EXPR_ADD) == (signbit(value) != 0))
+        {
+            return x;
+        }
+        if (node.type == EXPR_SUBTRACT && left_constant && left->value == 0 && signbit(left->value))
+        {
+            return expr_operation(tree, EXPR_NEGATE, node.right, -1);
+        }
+        break;
+    case EXPR_MULTIPLY:
+        if (right_constant && (value == 1 || value == -1 || value == 2))
+        {
+            return (value == 1)    ? x                                          // x * 1
+                   : (value == -1) ? expr_operation(tree, EXPR_NEGATE, x, -1) // x * -1
+                                   : expr_operation(tree, EXPR_ADD, x, x);    // x * 2
+        }
+        break;
+    case EXPR_DIVIDE:
+        if (right_constant && value != 0 && isfinite(value))
+        {
+            int exponent;
+            double reciprocal = 1 / value;
+            if (value == 1)
+            {
+                return x;
+            }
+            // x / 2^k == x * 2^-k exactly, as long as 2^-k is a normal number
+            if (fabs(frexp(value, &exponent)) == 0.5 && isnormal(reciprocal))
+            {
+                int constant = expr_constant(tree, reciprocal);
+                return expr_operation(tree, EXPR_MULTIPLY, x, constant);
+            }
+        }
+        break;
+    case EXPR_POWER:
+        if (right_constant && ((value == 0 && !expr_has_division(tree, x)) || value == 1 || value == 2))
+        {
+            return (value == 0)   ? expr_constant(tree, 1)                   // x ^ 0, even for nan
+                   : (value == 1) ? x                                        // x ^ 1
+                                  : expr_operation(tree, EXPR_MULTIPLY, x, x); // x ^ 2
+        }
+        break;
+    default:
+        break;
+    }
+    if ((node.type == EXPR_ADD || node.type == EXPR_MULTIPLY) && node.left > node.right && !right_constant)
+    {
+        // Fixed operand order, so a + b and b + a become one node.
+        int swap = node.left;
+        node.left = node.right;
+        node.right = swap;
+    }
+    return expr_intern(tree, node);
+}
+/**
+ * @brief Folds constants, applies identities and strength reduction, and merges equal subtrees.
+ * @param tree A tree from expr_parse(); children always come before their parents.
+ * @return 1 if the tree was rewritten, 0 if it was left alone (the rewrite ran out of nodes).
+ */
+static inline int expr_optimize(ExprTree* tree)
+{
+    ExprTree result = {.count = 0};
+    int map[EXPR_MAX_NODES]; // Old node -> new node.
+    for (int i = 0; i < tree->count; i++)
+    {
+        ExprNode node = tree->nodes[i];
+        node.left = (node.left >= 0) ? map[node.left] : -1;
+        node.right = (node.right >= 0) ? map[node.right] : -1;
+        map[i] = expr_simplify(&result, node);
+        if (map[i] < 0)
+        {
+            return 0;
+        }
+    }
+    result.root = map[tree->root];
+    *tree = result;
+    return 1;
+}
+/**
+ * @brief Compiles a tree into register code.
+ * @param tree Children must come before their parents (true for parsed and optimized trees).
+ * @param program Receives the code.
+ */
+static inline void expr_generate(const ExprTree* tree, ExprProgram* program)
+{
+    int remaining[EXPR_MAX_NODES] = {0}; // Readers of each node not yet emitted.
+    int reachable[EXPR_MAX_NODES] = {0};
+    int registers[EXPR_MAX_NODES];
+    reachable[tree->root] = 1;
+    for (int i = tree->root; i >= 0; i--)
+    {
+        const ExprNode* node = &tree->nodes[i];
+        if (reachable[i] && node->left >= 0)
+        {
+            reachable[node->left] = 1;
+            remaining[node->left]++;
+            if (node->right >= 0)
+            {
+                reachable[node->right] = 1;
+                remaining[node->right]++;
+            }
+        }
+    }
+
+    program->constant_count = 0;
+    for (int i = 0; i <= tree->root; i++)
+    {
+        if (reachable[i] && tree->nodes[i].type == EXPR_NUMBER)
+        {
+            registers[i] = program->constant_count;
+            program->constants[program->constant_count++] = tree->nodes[i].value;
+        }
+    }
+
+    static const ExprOpcode opcodes[] = {
+        [EXPR_VARIABLE] = EXPR_OP_LOAD,     [EXPR_NEGATE] = EXPR_OP_NEGATE, [EXPR_ADD] = EXPR_OP_ADD,
+        [EXPR_SUBTRACT] = EXPR_OP_SUBTRACT, [EXPR_MULTIPLY] = EXPR_OP_MULTIPLY, [EXPR_DIVIDE] = EXPR_OP_DIVIDE,
+        [EXPR_MODULUS] = EXPR_OP_MODULUS,   [EXPR_POWER] = EXPR_OP_POWER,   [EXPR_CALL] = EXPR_OP_CALL1,
+    };
+    int free_registers[EXPR_MAX_NODES];
+    int free_count = 0;
+    int next_register = program->constant_count;
+    program->length = 0;
+    for (int i = 0; i <= tree->root; i++)
+    {
+        const ExprNode* node = &tree->nodes[i];
+        if (!reachable[i] || node->type == EXPR_NUMBER)
+        {
+            continue;
+        }
+        ExprInstruction instruction = {.opcode = opcodes[node->type], .function = (unsigned char)node->index};
+        if (node->type == EXPR_VARIABLE)
+        {
+            instruction.a = (short)node->index;
+        }
+        else
+        {
+            instruction.a = (short)registers[node->left];
+            instruction.b = (short)((node->right >= 0) ? registers[node->right] : 0);
+            if (node->type == EXPR_CALL && node->right >= 0)
+            {
+                instruction.opcode = EXPR_OP_CALL2;
+            }
+            // Operands read for the last time give their registers back; the
+            // result may reuse one because every instruction reads before it writes.
+            int children[2] = {node->left, node->right};
+            for (int k = 0; k < 2; k++)
+            {
+                int child = children[k];
+                if (child >= 0 && --remaining[child] == 0 && registers[child] >= program->constant_count)
+                {
+                    free_registers[free_count++] = registers[child];
+                }
+            }
+        }
+        registers[i] = (free_count > 0) ? free_registers[--free_count] : next_register++;
+        instruction.dest = (short)registers[i];
+        program->code[program->length++] = instruction;
+    }
+    program->register_count = next_register;
+    program->result = registers[tree->root];
+}
+/**
+ * @brief Parses, optimizes and compiles an expression.
+ * @param text The expression.
+ * @param variables Names the expression may use; they must be defined first.
+ * @param program Receives the register code.
+ * @param error Receives the position and reason on failure.
+ * @return 1 on success, 0 on a syntax error.
+ */
+static inline int expr_compile(const char* text, ExprVariables* variables, ExprProgram* program, ExprError* error)
+{
+    ExprTree tree;
+    if (!expr_parse(text, variables, &tree, error))
+    {
+        return 0;
+    }
+    expr_optimize(&tree);
+    expr_generate(&tree, program);
+    return 1;
+}
+/**
+ * @brief Runs compiled code.
+ * @param program The compiled expression.
+ * @param variables Values indexed by the slots the program was compiled with.
+ * @param status Receives EXPR_OK or EXPR_DIVISION_BY_ZERO.
+ * @return The value of the expression.
+ */
+static inline double expr_evaluate(const ExprProgram* program, const double* variables, int* status)
+{
+    double r[EXPR_MAX_NODES];
+    memcpy(r, program->constants, program->constant_count * sizeof(double));
+    int flags = EXPR_OK;
+    for (int i = 0; i < program->length; i++)
+    {
+        const ExprInstruction* instruction = &program->code[i];
+        double a = r[instruction->a];
+        double b = r[instruction->b];
+        double* dest = &r[instruction->dest];
+        switch (instruction->opcode)
+        {
+        case EXPR_OP_LOAD:
+            *dest = variables[instruction->a];
+            break;
+        case EXPR_OP_NEGATE:
+            *dest = -a;
+            break;
+        case EXPR_OP_ADD:
+            *dest = a + b;
+            break;
+        case EXPR_OP_SUBTRACT:
+            *dest = a - b;
+            break;
+        case EXPR_OP_MULTIPLY:
+            *dest = a * b;
+            break;
+        case EXPR_OP_DIVIDE:
+            flags |= (b == 0);
+            *dest = a / b;
+            break;
+        case EXPR_OP_MODULUS:
+            flags |= (b == 0);
+            *dest = fmod(a, b);
+            break;
+        case EXPR_OP_POWER:
+            *dest = pow(a, b);
+            break;
+        case EXPR_OP_CALL1:
+        case EXPR_OP_CALL2:
+            *dest = expr_apply_function(instruction->function, a, b);
+            break;
+        }
+    }
+    *status = flags;
+    return r[program->result];
+}
+/**
+ * @brief Fills a lane array with one value.
+ */
+static inline void expr_kernel_fill(double* a, double value, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        a[i] = value;
+    }
+}
+// d = a op b lane by lane. d may be a or b: each step loads before it stores.
+#ifdef EXPR_VECTOR_LANES
+#define EXPR_DEFINE_KERNEL(name, op)                                                                                  \
+    static inline void name(double* d, const double* a, const double* b, int count)                                    \
+    {                                                                                                                  \
+        int i = 0;                                                                                                     \
+        for (; i + EXPR_VECTOR_LANES <= count; i += EXPR_VECTOR_LANES)                                                 \
+        {                                                                                                              \
+            *(ExprVector*)(d + i) = *(const ExprVector*)(a + i) op * (const ExprVector*)(b + i);                       \
+        }                                                                                                              \
+        for (; i < count; i++)                                                                                         \
+        {                                                                                                              \
+            d[i] = a[i] op b[i];                                                                                       \
+        }                                                                                                              \
+    }
+#else
+#define EXPR_DEFINE_KERNEL(name, op)                                                                                  \
+    static inline void name(double* d, const double* a, const double* b, int count)                                    \
+    {                                                                                                                  \
+        for (int i = 0; i < count; i++)                                                                                \
+        {                                                                                                              \
+            d[i] = a[i] op b[i];                                                                                       \
+        }                                                                                                              \
+    }
+#endif
+EXPR_DEFINE_KERNEL(expr_kernel_add, +)
+EXPR_DEFINE_KERNEL(expr_kernel_subtract, -)
+EXPR_DEFINE_KERNEL(expr_kernel_multiply, *)
+/**
+ * @brief d = a / b lane by lane. Lanes with b == 0 become NaN and get all bits set in failed.
+ */
+static inline void expr_kernel_divide(double* d, const double* a, const double* b, long long* failed, int count)
+{
+    int i = 0;
+#ifdef EXPR_VECTOR_LANES
+    const ExprVector nan_lanes = {NAN, NAN, NAN, NAN};
+    for (; i + EXPR_VECTOR_LANES <= count; i += EXPR_VECTOR_LANES)
+    {
+        ExprVector divisor = *(const ExprVector*)(b + i);
+        ExprMask zero = (divisor == 0); // -1 in lanes with a zero divisor
+        ExprMask quotient = (ExprMask)(*(const ExprVector*)(a + i) / divisor);
+        *(ExprMask*)(failed + i) |= zero;
+        *(ExprMask*)(d + i) = (quotient & ~zero) | ((ExprMask)nan_lanes & zero); // select, no branch
+    }
+#endif
+    for (; i < count; i++)
+    {
+        long long zero = -(long long)(b[i] == 0);
+        failed[i] |= zero;
+        d[i] = zero ? NAN : a[i] / b[i];
+    }
+}
+/**
+ * @brief d = fmod(a, b) lane by lane, with the same zero handling as expr_kernel_divide().
+ * fmod() has no vector form, so this one stays scalar.
+ */
+static inline void expr_kernel_modulus(double* d, const double* a, const double* b, long long* failed, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        long long zero = -(long long)(b[i] == 0);
+        failed[i] |= zero;
+        d[i] = zero ? NAN : fmod(a[i], b[i]);
+    }
+}
+/**
+ * @brief Doubles of scratch space expr_evaluate_batch() needs for a program.
+ */
+static inline size_t expr_batch_scratch_size(const ExprProgram* program)
+{
+    return (size_t)program->register_count * EXPR_LANES;
+}
+/**
+ * @brief Runs compiled code over many rows.
+ * @param program The compiled expression.
+ * @param columns For each variable slot, the values of this batch's rows (NULL for unused slots).
+ * @param count Number of rows, at most EXPR_LANES.
+ * @param out Receives one result per row; NaN where a divisor was zero.
+ * @param scratch expr_batch_scratch_size(program) doubles.
+ * @return Number of rows that divided by zero.
+ */
+static inline int expr_evaluate_batch(const ExprProgram* program, const double* const columns[], int count,
+                                      double* out, double* scratch)
+{
+    long long failed[EXPR_LANES] = {0}; // Lane mask: nonzero once that row divided by zero.
+    for (int i = 0; i < program->constant_count; i++)
+    {
+        expr_kernel_fill(scratch + (size_t)i * EXPR_LANES, program->constants[i], count);
+    }
+    for (int i = 0; i < program->length; i++)
+    {
+        const ExprInstruction* instruction = &program->code[i];
+        double* d = scratch + (size_t)instruction->dest * EXPR_LANES;
+        const double* a = scratch + (size_t)instruction->a * EXPR_LANES;
+        const double* b = scratch + (size_t)instruction->b * EXPR_LANES;
+        switch (instruction->opcode)
+        {
+        case EXPR_OP_LOAD:
+            memcpy(d, columns[instruction->a], count * sizeof(double));
+            break;
+        case EXPR_OP_NEGATE:
+            for (int lane = 0; lane < count; lane++)
+            {
+                d[lane] = -a[lane];
+            }
+            break;
+        case EXPR_OP_ADD:
+            expr_kernel_add(d, a, b, count);
+            break;
+        case EXPR_OP_SUBTRACT:
+            expr_kernel_subtract(d, a, b, count);
+            break;
+        case EXPR_OP_MULTIPLY:
+            expr_kernel_multiply(d, a, b, count);
+            break;
+        case EXPR_OP_DIVIDE:
+            expr_kernel_divide(d, a, b, failed, count);
+            break;
+        case EXPR_OP_MODULUS:
+            expr_kernel_modulus(d, a, b, failed, count);
+            break;
+        case EXPR_OP_POWER:
+            for (int lane = 0; lane < count; lane++)
+            {
+                d[lane] = pow(a[lane], b[lane]);
+            }
+            break;
+        case EXPR_OP_CALL1:
+        case EXPR_OP_CALL2:
+            for (int lane = 0; lane < count; lane++)
+            {
+                d[lane] = expr_apply_function(instruction->function, a[lane], b[lane]);
+            }
+            break;
+        }
+    }
+    memcpy(out, scratch + (size_t)program->result * EXPR_LANES, count * sizeof(double));
+    int failures = 0;
+    for (int lane = 0; lane < count; lane++)
+    {
+        failures += (failed[lane] != 0);
+    }
+    return failures;
+}
+
+#endif // EXPRESSION_H
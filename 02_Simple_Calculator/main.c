@@ -5,19 +5,164 @@ __Date: 27th May 2025
 */
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../common/input.h"  // line input without scanf()
+#include "../common/random.h" // seeded generator for --exact-bench operands
+#include "bignum.h"     // arbitrary-precision numbers for exact mode
+#include "expression.h" // parser, optimizer and register-code evaluator
+#include "number_format.h" // shortest round-trip output for --stream and --batch
+#include "result_cache.h"  // memo table for --stream --cache
+/*=============== Constant ===============*/
+#define LINE_LENGTH 1024
+#define BENCH_EVALUATIONS 10000000 // default count for --bench
+#define CSV_LINE_LENGTH 8192
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+#define STREAM_BLOCK_SIZE (1 << 20) // bytes per read in --stream; also the longest line
+#define EXACT_LINE_LENGTH 16384 // exact mode takes long numbers
+#define EXACT_DIGITS 50          // decimals kept by division in exact mode
+#define EXACT_BENCH_DIGITS 1000  // default operand size for --exact-bench
+
+/*=============== Type ===============*/
+// Columns for --batch: one CSV file, or one raw double file per variable.
+typedef struct
+{
+    ExprVariables variables;
+    FILE* csv;
+    FILE* binaries[EXPR_MAX_VARIABLES];
+    int slots[EXPR_MAX_VARIABLES]; // variable slot of each input column
+    int column_count;
+    const char* output_name;       // NULL: text on stdout
+} BatchInput;
+// Variables of exact mode: names for the parser, values as big numbers.
+typedef struct
+{
+    ExprVariables names;
+    BigNum values[EXPR_MAX_VARIABLES];
+} ExactVariables;
 
 /*=============== Function Prototypes ===============*/
 int menu_selection();
-void number_input(double*, double*);
+int number_input(double*, double*); // 0 at the end of input
 void add();
 void subtract();
 void multiply();
 void divide();
 void modulus();
+void expression_mode(ExprVariables*);
+const char* split_assignment(const char*, char*);
+int evaluate_line(const char*, ExprVariables*);
+int run_stream(ExprVariables*, ResultCache*);
+size_t stream_line(const char*, ExprVariables*, char*, long*, ResultCache*);
+size_t cache_key(const char*, const ExprVariables*, char*);
+void exact_mode(ExactVariables*);
+int evaluate_exact_line(const char*, ExactVariables*);
+int evaluate_exact(const ExprTree*, int, const char*, const ExactVariables*, BigNum*, const char**);
+void print_big(const char*, const BigNum*);
+int run_exact_benchmark(int);
+int run_benchmark(const char*, long);
+int open_batch_inputs(int, char*[], BatchInput*);
+void close_batch_inputs(BatchInput*);
+int evaluate_batch(const char*, BatchInput*);
+int read_csv_rows(FILE*, int, double[][EXPR_LANES], long*);
+int read_binary_rows(FILE*[], int, double[][EXPR_LANES]);
+double seconds_now();
 
 /*======================= Main =======================*/
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0)
+    {
+        return run_benchmark(argv[2], (argc > 3) ? atol(argv[3]) : BENCH_EVALUATIONS);
+    }
+    if (argc > 1 && strcmp(argv[1], "--exact-bench") == 0)
+    {
+        return run_exact_benchmark((argc > 2) ? atoi(argv[2]) : EXACT_BENCH_DIGITS);
+    }
+    ExactVariables exact = {0}; // exact-mode variables, kept like the ones above
+    for (int i = 0; i < EXPR_MAX_VARIABLES; i++)
+    {
+        big_init(&exact.values[i]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--exact") == 0)
+    {
+        // main --exact "expression" [name=value ...]
+        for (int i = 3; i < argc; i++)
+        {
+            char* equals = strchr(argv[i], '=');
+            int slot = -1;
+            if (equals != NULL)
+            {
+                *equals = '\0';
+                slot = expr_define_variable(&exact.names, argv[i]);
+            }
+            if (slot < 0 || big_parse(&exact.values[slot], equals + 1) != (int)strlen(equals + 1))
+            {
+                printf("Error: invalid variable '%s'.\n", argv[i]);
+                return 1;
+            }
+        }
+        return evaluate_exact_line(argv[2], &exact) ? 0 : 1;
+    }
+    if (argc > 3 && strcmp(argv[1], "--batch") == 0)
+    {
+        BatchInput input = {0};
+        int status = open_batch_inputs(argc, argv, &input) ? evaluate_batch(argv[2], &input) : 1;
+        close_batch_inputs(&input);
+        return status;
+    }
+    ExprVariables variables = {0}; // kept across expressions in this session
+    if (argc > 1 && strcmp(argv[1], "--stream") == 0)
+    {
+        // main --stream [--cache entries]
+        ResultCache cache;
+        int cached = argc == 4 && strcmp(argv[2], "--cache") == 0 && atol(argv[3]) > 0;
+        if ((argc != 2 && !cached) || (cached && !result_cache_init(&cache, (size_t)atol(argv[3]))))
+        {
+            printf("Error: expected --stream [--cache entries], or out of memory.\n");
+            return 1;
+        }
+        int status = run_stream(&variables, cached ? &cache : NULL);
+        if (cached)
+        {
+            fprintf(stderr, "Cache: %ld hits, %ld misses (%.1f%% hit rate), %ld evictions.\n", cache.hits,
+                    cache.misses, 100.0 * cache.hits / (cache.hits + cache.misses > 0 ? cache.hits + cache.misses : 1),
+                    cache.evictions);
+            result_cache_free(&cache);
+        }
+        return status;
+    }
+    if (argc > 1)
+    {
+        // One-line mode: main "expression" [name=value ...]
+        for (int i = 2; i < argc; i++)
+        {
+            char* equals = strchr(argv[i], '=');
+            if (equals == NULL)
+            {
+                printf("Usage: %s \"expression\" [name=value ...]\n", argv[0]);
+                printf("       %s --bench \"expression in x\" [evaluations]\n", argv[0]);
+                printf("       %s --batch \"expression\" (data.csv | name=column.bin ...) [--output file[.bin]]\n",
+                       argv[0]);
+                printf("       %s --exact \"expression\" [name=value ...]\n", argv[0]);
+                printf("       %s --exact-bench [digits]\n", argv[0]);
+                printf("       %s --stream [--cache entries] < expressions.txt > results.txt\n", argv[0]);
+                return 1;
+            }
+            *equals = '\0';
+            int slot = expr_define_variable(&variables, argv[i]);
+            if (slot < 0)
+            {
+                printf("Error: invalid variable name '%s'.\n", argv[i]);
+                return 1;
+            }
+            variables.values[slot] = atof(equals + 1);
+        }
+        return evaluate_line(argv[1], &variables) ? 0 : 1;
+    }
+
     printf("\n-----------------------------------------\n");
     printf("Welcome to the Simple Calculator!");
     printf("\n-----------------------------------------\n");
@@ -25,10 +170,9 @@ int main()
     while (1)
     {
         int option = menu_selection();
-        while (getchar() != '\n') // Clear input buffer
-            ;
         switch (option)
         {
+        case -1: // end of input
         case 0:
             printf("\nBye bye :)\n");
             printf("***Developed by Shad Hossain Fardin.***\n");
@@ -50,15 +194,17 @@ int main()
         case 5:
             modulus();
             break;
+        case 6:
+            expression_mode(&variables);
+            break;
+        case 7:
+            exact_mode(&exact);
+            break;
         default:
             printf("Invalid option, try again.\n");
             break;
         }
         printf("\n-----------------------------------------\n");
-        printf("\nAgain, choose your option (0 - 5): ");
-        scanf("%d", &option);
-        while (getchar() != '\n') // Clear input buffer
-            ;
     }
     return 0;
 }
@@ -74,48 +220,70 @@ int menu_selection()
     printf("3. Multiplication\n");
     printf("4. Division\n");
     printf("5. Modulus\n");
-    printf("\nNow, please choose your option (0 - 5): ");
-    scanf("%d", &option);
+    printf("6. Expression (e.g. 2 * (x + 3) ^ 2, x = 4, sqrt(x))\n");
+    printf("7. Exact (big numbers, e.g. 2 ^ 200, 0.1 + 0.2, 1 / 3)\n");
+    printf("\nNow, please choose your option (0 - 7): ");
+    int status = input_int(input_stdin(), &option);
+    if (status < 0)
+    {
+        printf("\n");
+        return -1;
+    }
+    return (status == 1) ? option : 8; // 8: not an option
 }
-void number_input(double* a, double* b)
+int number_input(double* a, double* b)
 {
+    int status;
     printf("Enter first number: ");
-    while (scanf("%lf", a) != 1)
+    while ((status = input_double(input_stdin(), a)) == 0)
     {
         printf("Invalid input! Enter a number: ");
-        while (getchar() != '\n') // Clear input buffer
-            ;
+    }
+    if (status < 0)
+    {
+        return 0;
     }
     printf("Enter second number: ");
-    while (scanf("%lf", b) != 1)
+    while ((status = input_double(input_stdin(), b)) == 0)
     {
         printf("Invalid input! Enter a number: ");
-        while (getchar() != '\n') // Clear input buffer
-            ;
     }
+    return status > 0;
 }
 void add()
 {
     double a, b;
-    number_input(&a, &b);
-    printf("result = %.2f\n", a, b, a + b);
+    if (!number_input(&a, &b))
+    {
+        return;
+    }
+    printf("result = %.2f\n", a + b);
 }
 void subtract()
 {
     double a, b;
-    number_input(&a, &b);
-    printf("result = %.2f\n", a, b, a - b);
+    if (!number_input(&a, &b))
+    {
+        return;
+    }
+    printf("result = %.2f\n", a - b);
 }
 void multiply()
 {
     double a, b;
-    number_input(&a, &b);
-    printf("result = %.2f\n", a, b, a * b);
+    if (!number_input(&a, &b))
+    {
+        return;
+    }
+    printf("result = %.2f\n", a * b);
 }
 void divide()
 {
     double a, b;
-    number_input(&a, &b);
+    if (!number_input(&a, &b))
+    {
+        return;
+    }
     if (b == 0)
     {
         printf("Error: Division by zero is not allowed.\n");
@@ -128,13 +296,815 @@ void divide()
 void modulus()
 {
     double a, b;
-    number_input(&a, &b);
+    if (!number_input(&a, &b))
+    {
+        return;
+    }
     if (b == 0)
     {
         printf("Error: Division by zero is not allowed.\n");
     }
     else
     {
-        printf("result = %.2f\n", a, b, fmod(a, b));
+        printf("result = %.2f\n", fmod(a, b));
+    }
+}
+void expression_mode(ExprVariables* variables)
+{
+    char line[LINE_LENGTH];
+    printf("Enter expressions, one per line; 'name = expression' stores a variable.\n");
+    printf("Functions: sin cos tan sqrt abs log log10 exp floor ceil round min max pow. Empty line to go back.\n");
+    while (1)
+    {
+        printf("> ");
+        if (!input_line(input_stdin(), line, sizeof(line), 0, NULL, NULL) || line[strspn(line, " \t")] == '\0')
+        {
+            return;
+        }
+        evaluate_line(line, variables);
+    }
+}
+const char* split_assignment(const char* line, char* name)
+{
+    // "name = expression" stores the name and returns the expression;
+    // anything else is all expression
+    name[0] = '\0';
+    int start = strspn(line, " \t");
+    int length = 0;
+    while (isalnum((unsigned char)line[start + length]) || line[start + length] == '_')
+    {
+        length++;
+    }
+    int equals = start + length + strspn(line + start + length, " \t");
+    if (length == 0 || isdigit((unsigned char)line[start]) || line[equals] != '=')
+    {
+        return line;
+    }
+    if (length >= EXPR_NAME_LENGTH)
+    {
+        return NULL; // name too long
+    }
+    memcpy(name, line + start, length);
+    name[length] = '\0';
+    return line + equals + 1;
+}
+int evaluate_line(const char* line, ExprVariables* variables)
+{
+    char name[EXPR_NAME_LENGTH];
+    const char* text = split_assignment(line, name);
+    if (text == NULL)
+    {
+        printf("Error: variable name too long.\n");
+        return 0;
+    }
+
+    ExprProgram program;
+    ExprError error;
+    if (!expr_compile(text, variables, &program, &error))
+    {
+        printf("Error: %s at position %d.\n", error.message, (int)(text - line) + error.position + 1);
+        return 0;
+    }
+    int status;
+    double result = expr_evaluate(&program, variables->values, &status);
+    if (status == EXPR_DIVISION_BY_ZERO)
+    {
+        printf("Error: Division by zero is not allowed.\n");
+        return 0;
+    }
+    if (name[0] != '\0')
+    {
+        int slot = expr_define_variable(variables, name);
+        if (slot < 0)
+        {
+            printf("Error: too many variables.\n");
+            return 0;
+        }
+        variables->values[slot] = result;
+        printf("%s = %.15g\n", name, result);
+    }
+    else
+    {
+        printf("result = %.15g\n", result);
+    }
+    return 1;
+}
+int run_stream(ExprVariables* variables, ResultCache* cache)
+{
+    // One expression per line in, one result per line out. Input is read in
+    // large blocks and split in place; output is collected in a buffer and
+    // written when full, never per line.
+    static char input[STREAM_BLOCK_SIZE + 1]; // +1 for a final line without '\n'
+    static char output[OUTPUT_BUFFER_SIZE];
+    size_t filled = 0, used = 0;
+    long lines = 0, errors = 0;
+    int skipping = 0; // inside a line longer than the buffer
+    int write_failed = 0;
+    double start = seconds_now();
+    while (1)
+    {
+        size_t got = fread(input + filled, 1, STREAM_BLOCK_SIZE - filled, stdin);
+        filled += got;
+        if (got == 0 && filled > 0)
+        {
+            input[filled++] = '\n'; // last line without a newline
+        }
+        char* line = input;
+        char* limit = input + filled;
+        char* newline;
+        while ((newline = memchr(line, '\n', limit - line)) != NULL)
+        {
+            *newline = '\0';
+            if (newline > line && newline[-1] == '\r')
+            {
+                newline[-1] = '\0';
+            }
+            if (used > OUTPUT_BUFFER_SIZE - LINE_LENGTH)
+            {
+                if (fwrite(output, 1, used, stdout) != used)
+                {
+                    write_failed = 1; // nobody would see the remaining results
+                    break;
+                }
+                used = 0;
+            }
+            if (skipping)
+            {
+                used += sprintf(output + used, "Error: line too long.\n");
+                errors++;
+                skipping = 0;
+            }
+            else
+            {
+                used += stream_line(line, variables, output + used, &errors, cache);
+            }
+            lines++;
+            line = newline + 1;
+        }
+        filled = limit - line;
+        if (filled == STREAM_BLOCK_SIZE)
+        {
+            skipping = 1; // drop the rest of this line
+            filled = 0;
+        }
+        memmove(input, line, filled);
+        if (got == 0 || write_failed)
+        {
+            break;
+        }
+    }
+    // Like --batch: a full disk may only show when the buffer is flushed.
+    write_failed = write_failed || fwrite(output, 1, used, stdout) != used;
+    write_failed |= fflush(stdout) != 0 || ferror(stdout);
+    if (write_failed)
+    {
+        fprintf(stderr, "Error: cannot write the output.\n");
+    }
+    double elapsed = seconds_now() - start;
+    fprintf(stderr, "%ld lines in %.3f s (%.1f M lines/s), %ld errors.\n", lines, elapsed,
+            lines / (elapsed > 0 ? elapsed : 1e-9) / 1e6, errors);
+    return (ferror(stdin) || write_failed) ? 1 : 0;
+}
+size_t stream_line(const char* line, ExprVariables* variables, char* out, long* errors, ResultCache* cache)
+{
+    // Writes the result or error of one line, with its newline, and returns
+    // the length. Blank lines stay blank so output lines match input lines.
+    // With a cache, a repeated expression skips the parse and evaluation.
+    if (line[strspn(line, " \t")] == '\0')
+    {
+        out[0] = '\n';
+        return 1;
+    }
+    char name[EXPR_NAME_LENGTH];
+    const char* text = split_assignment(line, name);
+    if (text == NULL)
+    {
+        (*errors)++;
+        return sprintf(out, "Error: variable name too long.\n");
+    }
+    char key[RESULT_CACHE_KEY_LENGTH];
+    size_t key_length = (cache != NULL) ? cache_key(text, variables, key) : 0;
+    uint64_t hash = (key_length > 0) ? result_cache_hash(key, key_length) : 0;
+    const CachedResult* hit = (key_length > 0) ? result_cache_find(cache, key, key_length, hash) : NULL;
+    double result;
+    int flags = 0;
+    if (hit != NULL)
+    {
+        result = hit->value;
+        flags = hit->status;
+    }
+    else
+    {
+        // One evaluation per parse: walking the tree is cheaper than compiling
+        ExprTree tree;
+        ExprError error;
+        if (!expr_parse(text, variables, &tree, &error))
+        {
+            (*errors)++;
+            return sprintf(out, "Error: %s at position %d.\n", error.message, (int)(text - line) + error.position + 1);
+        }
+        result = expr_evaluate_tree(&tree, tree.root, variables->values, &flags);
+        if (key_length > 0)
+        {
+            result_cache_store(cache, key, key_length, hash, result, flags);
+        }
+    }
+    if (flags & EXPR_DIVISION_BY_ZERO)
+    {
+        (*errors)++;
+        return sprintf(out, "Error: Division by zero is not allowed.\n");
+    }
+    if (name[0] != '\0')
+    {
+        int slot = expr_define_variable(variables, name);
+        if (slot < 0)
+        {
+            (*errors)++;
+            return sprintf(out, "Error: too many variables.\n");
+        }
+        variables->values[slot] = result;
+    }
+    size_t length = number_format(result, out);
+    out[length] = '\n';
+    return length + 1;
+}
+size_t cache_key(const char* text, const ExprVariables* variables, char* key)
+{
+    // The key is the text without blanks, a '\0', then the value of every
+    // variable the text names, so a variable that changes makes a new key.
+    // A blank between two word characters stays ("1 2" is not "12").
+    // Returns 0 when the key does not fit.
+    size_t length = 0;
+    char previous = '\0';
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        if (isspace((unsigned char)*c))
+        {
+            continue;
+        }
+        int word = isalnum((unsigned char)*c) || *c == '_' || *c == '.';
+        int previous_word = isalnum((unsigned char)previous) || previous == '_' || previous == '.';
+        if (word && previous_word && isspace((unsigned char)c[-1]))
+        {
+            key[length++] = ' ';
+        }
+        if (length + 1 >= RESULT_CACHE_KEY_LENGTH)
+        {
+            return 0;
+        }
+        key[length++] = *c;
+        previous = *c;
+    }
+    key[length++] = '\0';
+    size_t text_length = length;
+    for (size_t i = 0; i < text_length; i++)
+    {
+        // A name starts with a letter or '_' not inside a number ("1e5", "0x1f")
+        int starts = (isalpha((unsigned char)key[i]) || key[i] == '_') &&
+                     (i == 0 || !(isalnum((unsigned char)key[i - 1]) || key[i - 1] == '_' || key[i - 1] == '.'));
+        if (!starts)
+        {
+            continue;
+        }
+        size_t end = i;
+        while (isalnum((unsigned char)key[end]) || key[end] == '_')
+        {
+            end++;
+        }
+        int slot = expr_find_variable(variables, key + i, (int)(end - i));
+        if (slot >= 0)
+        {
+            if (length + sizeof(double) > RESULT_CACHE_KEY_LENGTH)
+            {
+                return 0;
+            }
+            memcpy(key + length, &variables->values[slot], sizeof(double));
+            length += sizeof(double);
+        }
+        i = end;
+    }
+    return length;
+}
+void exact_mode(ExactVariables* variables)
+{
+    static char line[EXACT_LINE_LENGTH];
+    printf("Exact arithmetic on numbers of any length; 'name = expression' stores a variable.\n");
+    printf("+ - * and %% are exact, / keeps %d decimals, ^ takes integer exponents.\n", EXACT_DIGITS);
+    printf("Functions: abs min max pow. Empty line to go back.\n");
+    while (1)
+    {
+        printf("exact> ");
+        if (!input_line(input_stdin(), line, sizeof(line), 0, NULL, NULL) || line[strspn(line, " \t")] == '\0')
+        {
+            return;
+        }
+        evaluate_exact_line(line, variables);
+    }
+}
+int evaluate_exact_line(const char* line, ExactVariables* variables)
+{
+    char name[EXPR_NAME_LENGTH];
+    const char* text = split_assignment(line, name);
+    if (text == NULL)
+    {
+        printf("Error: variable name too long.\n");
+        return 0;
+    }
+    // The parser only builds the tree; its doubles are ignored and
+    // evaluate_exact() re-reads every literal from the text.
+    ExprTree tree;
+    ExprError error;
+    if (!expr_parse(text, &variables->names, &tree, &error))
+    {
+        printf("Error: %s at position %d.\n", error.message, (int)(text - line) + error.position + 1);
+        return 0;
+    }
+    BigNum result;
+    big_init(&result);
+    const char* message = NULL;
+    if (!evaluate_exact(&tree, tree.root, text, variables, &result, &message))
+    {
+        printf("Error: %s.\n", message);
+        big_free(&result);
+        return 0;
+    }
+    if (name[0] != '\0')
+    {
+        int slot = expr_define_variable(&variables->names, name);
+        if (slot < 0)
+        {
+            printf("Error: too many variables.\n");
+            big_free(&result);
+            return 0;
+        }
+        big_swap(&variables->values[slot], &result);
+        print_big(name, &variables->values[slot]);
+    }
+    else
+    {
+        print_big("result", &result);
+    }
+    big_free(&result);
+    return 1;
+}
+int evaluate_exact(const ExprTree* tree, int index, const char* text, const ExactVariables* variables,
+                   BigNum* result, const char** message)
+{
+    const ExprNode* node = &tree->nodes[index];
+    if (node->type == EXPR_NUMBER)
+    {
+        if (node->position < 0)
+        {
+            *message = "pi and e have no exact value";
+            return 0;
+        }
+        char* end;
+        strtod(text + node->position, &end); // the extent the parser accepted
+        if (big_parse(result, text + node->position) != (int)(end - (text + node->position)))
+        {
+            *message = "number not supported in exact mode";
+            return 0;
+        }
+        return 1;
+    }
+    if (node->type == EXPR_VARIABLE)
+    {
+        big_copy(result, &variables->values[node->index]);
+        return 1;
+    }
+    if (node->type == EXPR_CALL && node->index != EXPR_FN_ABS && node->index != EXPR_FN_MIN &&
+        node->index != EXPR_FN_MAX && node->index != EXPR_FN_POW)
+    {
+        *message = "function has no exact value";
+        return 0;
+    }
+
+    BigNum a, b;
+    big_init(&a);
+    big_init(&b);
+    int ok = evaluate_exact(tree, node->left, text, variables, &a, message) &&
+             (node->right < 0 || evaluate_exact(tree, node->right, text, variables, &b, message));
+    long long exponent;
+    if (ok)
+    {
+        int type = (node->type == EXPR_CALL && node->index == EXPR_FN_POW) ? EXPR_POWER : node->type;
+        switch (type)
+        {
+        case EXPR_NEGATE:
+            a.negative = !a.negative && a.length > 0;
+            big_swap(result, &a);
+            break;
+        case EXPR_ADD:
+            big_add(result, &a, &b);
+            break;
+        case EXPR_SUBTRACT:
+            big_subtract(result, &a, &b);
+            break;
+        case EXPR_MULTIPLY:
+            ok = big_multiply(result, &a, &b);
+            *message = "number too large";
+            break;
+        case EXPR_DIVIDE:
+        case EXPR_MODULUS:
+            ok = (type == EXPR_DIVIDE) ? big_divide(result, &a, &b, EXACT_DIGITS) : big_modulus(result, &a, &b);
+            *message = (b.length == 0) ? "Division by zero is not allowed" : "number too large";
+            break;
+        case EXPR_POWER:
+            ok = big_to_long(&b, &exponent);
+            *message = "exponent must be a whole number";
+            if (ok && !big_pow(result, &a, (long)exponent, EXACT_DIGITS))
+            {
+                ok = 0;
+                *message = (exponent < 0 && a.length == 0)                                ? "Division by zero is not allowed"
+                           : (exponent > BIG_MAX_EXPONENT || exponent < -BIG_MAX_EXPONENT) ? "exponent too large"
+                                                                                           : "number too large";
+            }
+            break;
+        default: // abs, min, max
+            if (node->index == EXPR_FN_ABS)
+            {
+                a.negative = 0;
+            }
+            else if ((big_compare(&a, &b) < 0) == (node->index == EXPR_FN_MAX))
+            {
+                big_swap(&a, &b);
+            }
+            big_swap(result, &a);
+            break;
+        }
+    }
+    big_free(&a);
+    big_free(&b);
+    return ok;
+}
+void print_big(const char* name, const BigNum* number)
+{
+    char* text = malloc(big_format_size(number));
+    if (text == NULL)
+    {
+        printf("Out of memory.\n");
+        return;
+    }
+    big_format(number, text);
+    printf("%s = %s\n", name, text);
+    free(text);
+}
+int run_exact_benchmark(int digits)
+{
+    if (digits < 1 || digits > 1000000)
+    {
+        printf("Error: invalid digit count.\n");
+        return 1;
+    }
+    // Random operands of the given size: a and b for + and *; a * b + c, with c = b - 1,
+    // divided by b for / and %
+    int limbs = (digits + BIG_BASE_DIGITS - 1) / BIG_BASE_DIGITS;
+    BigNum a, b, c, product, r;
+    BigNum* numbers[] = {&a, &b, &c, &product, &r};
+    for (int i = 0; i < 5; i++)
+    {
+        big_init(numbers[i]);
+    }
+    Random random;
+    random_seed(&random, 1); // same operands every run
+    for (int i = 0; i < 2; i++)
+    {
+        big_reserve(numbers[i], limbs);
+        uint32_t* digits_out = big_limbs(numbers[i]);
+        random_fill_below(&random, digits_out, limbs, BIG_BASE);
+        digits_out[limbs - 1] = digits_out[limbs - 1] % 999999999 + 1;
+        numbers[i]->length = limbs;
+    }
+    big_set_int(&r, 1);
+    big_subtract(&c, &b, &r);
+    big_multiply(&product, &a, &b);
+    big_add(&product, &product, &c);
+
+    // Karatsuba against schoolbook on the same limbs; they must agree
+    uint32_t* basic = malloc(2 * limbs * sizeof(uint32_t));
+    if (basic == NULL)
+    {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    big_mag_multiply_basic(basic, big_limbs(&a), limbs, big_limbs(&b), limbs);
+    big_multiply(&r, &a, &b);
+    int agree = memcmp(basic, big_limbs(&r), r.length * sizeof(uint32_t)) == 0;
+
+    const char* names[] = {"Add", "Multiply (basic)", "Multiply", "Divide", "Modulus"};
+    printf("Operands: %d digits (%d limbs), Karatsuba from %d limbs\n", limbs * BIG_BASE_DIGITS, limbs,
+           BIG_KARATSUBA_THRESHOLD);
+    for (int operation = 0; operation < 5; operation++)
+    {
+        long count = 0;
+        double start = seconds_now(), elapsed;
+        do // repeat for at least 0.2 s
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                switch (operation)
+                {
+                case 0:
+                    big_add(&r, &a, &b);
+                    break;
+                case 1:
+                    big_mag_multiply_basic(basic, big_limbs(&a), limbs, big_limbs(&b), limbs);
+                    break;
+                case 2:
+                    big_multiply(&r, &a, &b);
+                    break;
+                case 3:
+                    big_divide(&r, &product, &b, 0);
+                    break;
+                default:
+                    big_modulus(&r, &product, &b);
+                    break;
+                }
+            }
+            count += 64;
+            elapsed = seconds_now() - start;
+        } while (elapsed < 0.2);
+        printf("%-18s %10.0f operations/s (%.2f us each)\n", names[operation], count / elapsed,
+               elapsed / count * 1e6);
+    }
+    printf("Karatsuba matches schoolbook: %s; remainder check: %s\n", agree ? "yes" : "NO",
+           (big_compare(&r, &c) == 0) ? "yes" : "NO");
+    free(basic);
+    for (int i = 0; i < 5; i++)
+    {
+        big_free(numbers[i]);
+    }
+    return 0;
+}
+int run_benchmark(const char* text, long count)
+{
+    ExprVariables variables = {0};
+    int x = expr_define_variable(&variables, "x");
+    ExprTree tree, optimized;
+    ExprError error;
+    if (count < 1)
+    {
+        printf("Error: invalid count.\n");
+        return 1;
+    }
+    if (!expr_parse(text, &variables, &tree, &error))
+    {
+        printf("Error: %s at position %d.\n", error.message, error.position + 1);
+        return 1;
+    }
+    optimized = tree;
+    expr_optimize(&optimized);
+    ExprProgram plain, program;
+    expr_generate(&tree, &plain);
+    expr_generate(&optimized, &program);
+
+    // Same expression four ways, for x = 0, 1, 2, ...; the parse-every-time
+    // baseline runs a tenth of the count
+    const char* names[] = {"Parse every time", "Tree walking", "Register code", "Optimized code"};
+    double sums[4] = {0};
+    for (int method = 0; method < 4; method++)
+    {
+        long evaluations = (method == 0 && count >= 10) ? count / 10 : count;
+        int status = 0;
+        double start = seconds_now();
+        for (long i = 0; i < evaluations; i++)
+        {
+            variables.values[x] = (double)i;
+            switch (method)
+            {
+            case 0:
+                expr_compile(text, &variables, &program, &error);
+                sums[method] += expr_evaluate(&program, variables.values, &status);
+                break;
+            case 1:
+                sums[method] += expr_evaluate_tree(&tree, tree.root, variables.values, &status);
+                break;
+            case 2:
+                sums[method] += expr_evaluate(&plain, variables.values, &status);
+                break;
+            default:
+                sums[method] += expr_evaluate(&program, variables.values, &status);
+                break;
+            }
+        }
+        double elapsed = seconds_now() - start;
+        printf("%-18s %7.1f M evaluations/s (%.1f ns each)\n", names[method], evaluations / elapsed / 1e6,
+               elapsed / evaluations * 1e9);
+    }
+    printf("Instructions: %d -> %d after optimization; checksums %g %g\n", plain.length, program.length, sums[2],
+           sums[3]);
+    return 0;
+}
+int open_batch_inputs(int argc, char* argv[], BatchInput* input)
+{
+    for (int i = 3; i < argc; i++)
+    {
+        char* equals = strchr(argv[i], '=');
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            input->output_name = argv[++i];
+        }
+        else if (equals != NULL && input->csv == NULL && input->column_count < EXPR_MAX_VARIABLES)
+        {
+            *equals = '\0';
+            int slot = expr_define_variable(&input->variables, argv[i]);
+            FILE* file = fopen(equals + 1, "rb");
+            if (slot < 0 || file == NULL)
+            {
+                fprintf(stderr, "Error: cannot use column %s=%s.\n", argv[i], equals + 1);
+                if (file != NULL)
+                {
+                    fclose(file);
+                }
+                return 0;
+            }
+            input->binaries[input->column_count] = file;
+            input->slots[input->column_count++] = slot;
+        }
+        else if (equals == NULL && input->csv == NULL && input->column_count == 0)
+        {
+            char header[CSV_LINE_LENGTH];
+            input->csv = fopen(argv[i], "r");
+            if (input->csv == NULL || fgets(header, sizeof(header), input->csv) == NULL)
+            {
+                fprintf(stderr, "Error: cannot read %s.\n", argv[i]);
+                return 0;
+            }
+            for (char* name = strtok(header, ", \t\r\n"); name != NULL; name = strtok(NULL, ", \t\r\n"))
+            {
+                int slot = expr_define_variable(&input->variables, name);
+                if (input->column_count == EXPR_MAX_VARIABLES || slot < 0)
+                {
+                    fprintf(stderr, "Error: invalid or too many columns in the header of %s.\n", argv[i]);
+                    return 0;
+                }
+                input->slots[input->column_count++] = slot;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Error: unexpected argument '%s'.\n", argv[i]);
+            return 0;
+        }
+    }
+    if (input->csv == NULL && input->column_count == 0)
+    {
+        fprintf(stderr, "Error: no input columns.\n");
+        return 0;
+    }
+    return 1;
+}
+void close_batch_inputs(BatchInput* input)
+{
+    if (input->csv != NULL)
+    {
+        fclose(input->csv);
+        return;
+    }
+    for (int i = 0; i < input->column_count; i++)
+    {
+        fclose(input->binaries[i]);
     }
 }
+int evaluate_batch(const char* text, BatchInput* input)
+{
+    static double columns[EXPR_MAX_VARIABLES][EXPR_LANES];
+    static double results[EXPR_LANES];
+    ExprProgram program;
+    ExprError error;
+    if (!expr_compile(text, &input->variables, &program, &error))
+    {
+        fprintf(stderr, "Error: %s at position %d.\n", error.message, error.position + 1);
+        return 1;
+    }
+    const double* inputs[EXPR_MAX_VARIABLES];
+    for (int i = 0; i < input->column_count; i++)
+    {
+        inputs[input->slots[i]] = columns[i];
+    }
+    const char* name = input->output_name;
+    int binary_output = name != NULL && strlen(name) > 4 && strcmp(name + strlen(name) - 4, ".bin") == 0;
+    FILE* output = (name != NULL) ? fopen(name, binary_output ? "wb" : "w") : stdout;
+    if (output == NULL)
+    {
+        fprintf(stderr, "Error: cannot write %s.\n", name);
+        return 1;
+    }
+    double* scratch = malloc(expr_batch_scratch_size(&program) * sizeof(double));
+    if (scratch == NULL)
+    {
+        fprintf(stderr, "Out of memory.\n");
+        if (output != stdout)
+        {
+            fclose(output);
+        }
+        return 1;
+    }
+    setvbuf(output, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    long rows = 0, failures = 0, line_number = 1;
+    int status = 0;
+    double start = seconds_now();
+    while (1)
+    {
+        int count = (input->csv != NULL) ? read_csv_rows(input->csv, input->column_count, columns, &line_number)
+                                         : read_binary_rows(input->binaries, input->column_count, columns);
+        if (count < 0 && input->csv != NULL)
+        {
+            fprintf(stderr, "Error: bad number or column count on line %ld.\n", line_number);
+            status = 1;
+            break;
+        }
+        if (count < 0)
+        {
+            fprintf(stderr, "Error: binary columns differ in length or cannot be read (after %ld rows).\n", rows);
+            status = 1;
+            break;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        failures += expr_evaluate_batch(&program, inputs, count, results, scratch);
+        if (binary_output)
+        {
+            fwrite(results, sizeof(double), count, output);
+        }
+        else
+        {
+            char text[NUMBER_FORMAT_LENGTH];
+            for (int i = 0; i < count; i++)
+            {
+                size_t length = number_format(results[i], text); // reads back as exactly results[i]
+                text[length] = '\n';
+                fwrite(text, 1, length + 1, output);
+            }
+        }
+        if (ferror(output))
+        {
+            break; // reported below
+        }
+        rows += count;
+    }
+    // A full disk may only show when the buffer is flushed, so check the close too.
+    int write_failed = ferror(output);
+    write_failed |= (output != stdout) ? fclose(output) != 0 : fflush(stdout) != 0;
+    if (write_failed)
+    {
+        fprintf(stderr, "Error: cannot write %s.\n", (name != NULL) ? name : "the output");
+        status = 1;
+    }
+    free(scratch);
+    double elapsed = seconds_now() - start;
+    fprintf(stderr, "%ld rows in %.3f s (%.1f M rows/s), %ld divisions by zero (written as nan).\n", rows, elapsed,
+            rows / (elapsed > 0 ? elapsed : 1e-9) / 1e6, failures);
+    return status;
+}
+int read_csv_rows(FILE* file, int column_count, double columns[][EXPR_LANES], long* line_number)
+{
+    char line[CSV_LINE_LENGTH];
+    int count = 0;
+    while (count < EXPR_LANES && fgets(line, sizeof(line), file) != NULL)
+    {
+        (*line_number)++;
+        char* cursor = line;
+        if (line[strspn(line, " \t\r\n")] == '\0')
+        {
+            continue; // blank line
+        }
+        for (int column = 0; column < column_count; column++)
+        {
+            char* end;
+            columns[column][count] = strtod(cursor, &end);
+            end += strspn(end, " \t");
+            if (end == cursor || (*end != ',' && column < column_count - 1) ||
+                (column == column_count - 1 && *end != '\0' && *end != '\r' && *end != '\n'))
+            {
+                return -1;
+            }
+            cursor = end + 1;
+        }
+        count++;
+    }
+    return count;
+}
+int read_binary_rows(FILE* files[], int column_count, double columns[][EXPR_LANES])
+{
+    size_t count = 0;
+    for (int column = 0; column < column_count; column++)
+    {
+        size_t read = fread(columns[column], sizeof(double), EXPR_LANES, files[column]);
+        if (ferror(files[column]) || (column > 0 && read != count))
+        {
+            return -1; // a read error, or one column ended before the others
+        }
+        count = read;
+    }
+    return (int)count;
+}
+double seconds_now()
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
\ No newline at end of file
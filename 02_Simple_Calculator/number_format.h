@@ -0,0 +1,271 @@
+/*
+ * Module Name: Number Format
+ * Date: 19th October 2026
+ *
+ * Writes a double with the fewest significant digits that read back as the
+ * same double, e.g. 0.1 -> "0.1" and 1/3 -> "0.3333333333333333". This
+ * replaces printf("%.17g"), which prints 0.10000000000000001, and
+ * printf("%.15g"), which loses the last digits of many numbers.
+ *
+ * Fast path: the value is rounded to 15 significant digits with one
+ * multiplication. If that 15-digit integer m and 10^k are both exact doubles
+ * (m < 2^53, |k| <= 22), then m * 10^k or m / 10^k is a single correctly
+ * rounded operation. It gives exactly what strtod() would read, so one
+ * comparison proves the round trip. Doubles are at least 15 digits
+ * precise, so only one 15-digit decimal can round-trip, and dropping its
+ * trailing zeros gives the shortest form.
+ *
+ * Values that need 16 or 17 digits are checked exactly with 128-bit
+ * integers where the compiler has them. The value is f * 2^e, and the
+ * nearest P-digit decimal m * 10^-s round-trips exactly when
+ * |m * 2^-e - f * 10^s| is within half a binary ulp. This works for values
+ * from about 4e-6 to 2^53. Everything else falls back to snprintf() and
+ * strtod().
+ *
+ * The layout is like %g: plain notation for exponents -5 .. 16, otherwise
+ * "1.5e+300".
+ *
+ * Usage:
+ *     char text[NUMBER_FORMAT_LENGTH];
+ *     size_t length = number_format(0.1 + 0.2, text); // "0.30000000000000004"
+ */
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*================= Constant =================*/
+#define NUMBER_FORMAT_LENGTH 32 // "-1.2345678901234567e-308" plus '\0', rounded up.
+#define NUMBER_MAX_DIGITS 17    // Enough for any double.
+/*================= Global =================*/
+static const double number_powers_of_ten[23] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+/*================= Function Definition =================*/
+/**
+ * @brief Finds the 15 significant digits of a positive value through the exact fast path.
+ * @param value Positive and finite.
+ * @param digits Receives 15 ASCII digits.
+ * @param exponent Receives the decimal exponent of the first digit.
+ * @return 1 if the digits round-trip, 0 if 16 or 17 digits are needed, -1 if the value is out of range.
+ */
+static inline int number_fast_digits(double value, char* digits, int* exponent)
+{
+    int binary_exponent;
+    frexp(value, &binary_exponent);
+    int e10 = ((binary_exponent - 1) * 78913) >> 18; // floor(log10(2) * e); exact or one too small
+    for (int attempt = 0; attempt < 2; attempt++, e10++)
+    {
+        int scale = 14 - e10; // m = value * 10^scale has 15 digits
+        if (scale > 22 || scale < -22)
+        {
+            return -1;
+        }
+        double scaled = (scale >= 0) ? value * number_powers_of_ten[scale] : value / number_powers_of_ten[-scale];
+        double m = floor(scaled + 0.5);
+        if (m >= 1e15)
+        {
+            continue; // e10 was one too small
+        }
+        if (m < 1e14)
+        {
+            return -1;
+        }
+        double back = (scale >= 0) ? m / number_powers_of_ten[scale] : m * number_powers_of_ten[-scale];
+        if (back != value)
+        {
+            return 0;
+        }
+        long long integer = (long long)m;
+        for (int i = 14; i >= 0; i--)
+        {
+            digits[i] = (char)('0' + integer % 10);
+            integer /= 10;
+        }
+        *exponent = e10;
+        return 1;
+    }
+    return -1;
+}
+#if defined(__SIZEOF_INT128__)
+/**
+ * @brief Finds the nearest `precision`-digit decimal of a positive value and checks its round trip exactly.
+ * @param precision 16 or 17.
+ * @return 1 if the digits round-trip, 0 if they do not, -1 if the value is out of range.
+ */
+static inline int number_exact_digits(double value, int precision, char* digits, int* exponent)
+{
+    int binary_exponent;
+    double fraction = frexp(value, &binary_exponent);
+    unsigned long long f = (unsigned long long)ldexp(fraction, 53); // value = f * 2^-k
+    int k = 53 - binary_exponent;
+    if (k < 1 || k > 70) // f * 10^s and m * 2^k must fit in 128 bits
+    {
+        return -1;
+    }
+    int e10 = ((binary_exponent - 1) * 78913) >> 18;
+    unsigned __int128 limit = 1;
+    for (int i = 0; i < precision; i++)
+    {
+        limit *= 10;
+    }
+    for (int attempt = 0; attempt < 2; attempt++, e10++)
+    {
+        int scale = precision - 1 - e10;
+        if (scale < 0 || scale > 22)
+        {
+            return -1;
+        }
+        unsigned __int128 power = (unsigned __int128)number_powers_of_ten[scale];
+        unsigned __int128 scaled = (unsigned __int128)f * power; // value * 10^s * 2^k
+        unsigned __int128 m = (scaled + ((unsigned __int128)1 << (k - 1))) >> k;
+        if (m >= limit)
+        {
+            continue; // e10 was one too small
+        }
+        // Distance to the value against half an ulp, all scaled by 10^s * 2^k;
+        // the ulp below a power of two is half as wide, and ties go to even f
+        unsigned __int128 decimal = m << k;
+        int above = decimal > scaled;
+        unsigned __int128 distance = above ? decimal - scaled : scaled - decimal;
+        distance *= (!above && f == (1ULL << 52)) ? 4 : 2;
+        if (distance > power || (distance == power && (f & 1)))
+        {
+            return 0;
+        }
+        for (int i = precision - 1; i >= 0; i--)
+        {
+            digits[i] = (char)('0' + (int)(m % 10));
+            m /= 10;
+        }
+        *exponent = e10;
+        return 1;
+    }
+    return -1;
+}
+#endif
+/**
+ * @brief Finds the shortest round-trip digits with snprintf() and strtod().
+ * @param precision The first digit count to try.
+ * @return The digit count.
+ */
+static inline int number_slow_digits(double value, int precision, char* digits, int* exponent)
+{
+    char text[NUMBER_FORMAT_LENGTH];
+    for (; precision < NUMBER_MAX_DIGITS; precision++)
+    {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+        if (strtod(text, NULL) == value)
+        {
+            break;
+        }
+    }
+    if (precision == NUMBER_MAX_DIGITS)
+    {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+    }
+    // "d.ddde+XX"
+    int count = 0;
+    char* cursor = text;
+    for (; *cursor != 'e'; cursor++)
+    {
+        if (*cursor != '.')
+        {
+            digits[count++] = *cursor;
+        }
+    }
+    *exponent = atoi(cursor + 1);
+    return count;
+}
+/**
+ * @brief Writes a double in its shortest round-trip form.
+ * @param value Any double; nan and infinities become "nan", "inf", "-inf".
+ * @param out At least NUMBER_FORMAT_LENGTH bytes.
+ * @return Length of the text.
+ */
+static inline size_t number_format(double value, char* out)
+{
+    char* cursor = out;
+    if (isnan(value))
+    {
+        memcpy(out, "nan", 4);
+        return 3;
+    }
+    if (signbit(value))
+    {
+        *cursor++ = '-';
+        value = -value;
+    }
+    if (isinf(value) || value == 0)
+    {
+        strcpy(cursor, (value == 0) ? "0" : "inf");
+        return strlen(out);
+    }
+
+    char digits[NUMBER_MAX_DIGITS];
+    int exponent;
+    int count = 15;
+    int fast = number_fast_digits(value, digits, &exponent);
+    int first = (fast == 0) ? 16 : 1; // 15 digits were too few
+#if defined(__SIZEOF_INT128__)
+    for (int precision = 16; fast == 0 && precision <= NUMBER_MAX_DIGITS; precision++)
+    {
+        fast = number_exact_digits(value, precision, digits, &exponent);
+        count = precision;
+    }
+#endif
+    if (fast != 1)
+    {
+        count = number_slow_digits(value, first, digits, &exponent);
+    }
+    while (count > 1 && digits[count - 1] == '0')
+    {
+        count--;
+    }
+
+    if (exponent < -5 || exponent > 16)
+    {
+        // d.ddde+XX
+        *cursor++ = digits[0];
+        if (count > 1)
+        {
+            *cursor++ = '.';
+            memcpy(cursor, digits + 1, count - 1);
+            cursor += count - 1;
+        }
+        cursor += sprintf(cursor, "e%c%02d", (exponent < 0) ? '-' : '+', abs(exponent));
+    }
+    else if (exponent < 0)
+    {
+        // 0.000ddd
+        *cursor++ = '0';
+        *cursor++ = '.';
+        memset(cursor, '0', -exponent - 1);
+        cursor += -exponent - 1;
+        memcpy(cursor, digits, count);
+        cursor += count;
+    }
+    else
+    {
+        // ddd000 or ddd.ddd
+        int whole = exponent + 1;
+        int copied = (count < whole) ? count : whole;
+        memcpy(cursor, digits, copied);
+        cursor += copied;
+        memset(cursor, '0', whole - copied);
+        cursor += whole - copied;
+        if (count > whole)
+        {
+            *cursor++ = '.';
+            memcpy(cursor, digits + whole, count - whole);
+            cursor += count - whole;
+        }
+    }
+    *cursor = '\0';
+    return (size_t)(cursor - out);
+}
+
+#endif // NUMBER_FORMAT_H
@@ -0,0 +1,195 @@
+/*
+ * Module Name: Result Cache
+ * Date: 19th October 2026
+ *
+ * A bounded memo table from keys (a normalized expression plus the values
+ * of its variables, built by the caller) to evaluation results. A repeated
+ * expression then costs one hash and one probe instead of a parse and an
+ * evaluation.
+ *
+ * The table is open addressing with linear probing over a power-of-two
+ * slot array at most half full, so a lookup usually touches one slot.
+ * Keys are stored inline up to RESULT_CACHE_KEY_LENGTH bytes; longer ones
+ * are simply not cached.
+ *
+ * Once the cache holds its limit, CLOCK picks the entry to evict. Every hit
+ * sets the entry's reference bit. A hand sweeps the slots, clears set bits
+ * and evicts the first entry whose bit is already clear. An entry used
+ * since the last sweep survives, so hot expressions stay cached at the
+ * cost of one bit. Removal shifts later entries of the probe chain back,
+ * so no tombstones build up.
+ *
+ * Usage:
+ *     ResultCache cache;
+ *     result_cache_init(&cache, 65536);
+ *     uint64_t hash = result_cache_hash(key, length);
+ *     const CachedResult* hit = result_cache_find(&cache, key, length, hash);
+ *     if (hit == NULL)
+ *         result_cache_store(&cache, key, length, hash, value, status);
+ *     result_cache_free(&cache);
+ */
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+/*================= Constant =================*/
+#define RESULT_CACHE_KEY_LENGTH 112 // Longest key stored; keeps a slot at 136 bytes.
+/*================= Type =================*/
+typedef struct
+{
+    uint64_t hash;
+    unsigned short length;    // Key length; 0 marks a free slot.
+    unsigned char referenced; // CLOCK bit: set by hits, cleared by the passing hand.
+    unsigned char status;     // Status the evaluation returned.
+    double value;
+    char key[RESULT_CACHE_KEY_LENGTH];
+} CachedResult;
+typedef struct
+{
+    CachedResult* slots;
+    size_t capacity; // Slots, a power of two and at least twice the limit.
+    size_t limit;    // Entries kept before eviction starts.
+    size_t count;
+    size_t hand;     // CLOCK position.
+    long hits, misses, evictions;
+} ResultCache;
+/*================= Function Definition =================*/
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a key.
+ */
+static inline uint64_t result_cache_hash(const char* key, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+/**
+ * @brief Sets up an empty cache.
+ * @param cache The cache.
+ * @param entries Entries kept before eviction starts (at least 1).
+ * @return 1 on success, 0 if out of memory or the limit is too large.
+ */
+static inline int result_cache_init(ResultCache* cache, size_t entries)
+{
+    memset(cache, 0, sizeof(*cache));
+    if (entries > SIZE_MAX / 4)
+    {
+        return 0; // Doubling the capacity past 2 * entries would overflow.
+    }
+    cache->limit = (entries > 0) ? entries : 1;
+    cache->capacity = 2;
+    while (cache->capacity < 2 * cache->limit)
+    {
+        cache->capacity *= 2;
+    }
+    cache->slots = calloc(cache->capacity, sizeof(CachedResult));
+    return cache->slots != NULL;
+}
+/**
+ * @brief Releases the cache's memory.
+ */
+static inline void result_cache_free(ResultCache* cache)
+{
+    free(cache->slots);
+    cache->slots = NULL;
+}
+/**
+ * @brief Looks up a key and counts a hit or a miss.
+ * @return The cached result, or NULL.
+ */
+static inline const CachedResult* result_cache_find(ResultCache* cache, const char* key, size_t length,
+                                                    uint64_t hash)
+{
+    size_t mask = cache->capacity - 1;
+    for (size_t slot = hash & mask; cache->slots[slot].length != 0; slot = (slot + 1) & mask)
+    {
+        CachedResult* entry = &cache->slots[slot];
+        if (entry->hash == hash && entry->length == length && memcmp(entry->key, key, length) == 0)
+        {
+            entry->referenced = 1;
+            cache->hits++;
+            return entry;
+        }
+    }
+    cache->misses++;
+    return NULL;
+}
+/**
+ * @brief Empties a slot and moves later entries of its probe chain back into the gap.
+ */
+static inline void result_cache_remove(ResultCache* cache, size_t slot)
+{
+    size_t mask = cache->capacity - 1;
+    size_t gap = slot;
+    for (size_t next = (gap + 1) & mask; cache->slots[next].length != 0; next = (next + 1) & mask)
+    {
+        size_t home = cache->slots[next].hash & mask;
+        if (((next - home) & mask) >= ((next - gap) & mask)) // its chain passes the gap
+        {
+            cache->slots[gap] = cache->slots[next];
+            gap = next;
+        }
+    }
+    cache->slots[gap].length = 0;
+    cache->count--;
+}
+/**
+ * @brief Evicts one entry, chosen by the CLOCK hand.
+ */
+static inline void result_cache_evict(ResultCache* cache)
+{
+    while (1)
+    {
+        CachedResult* entry = &cache->slots[cache->hand];
+        if (entry->length != 0)
+        {
+            if (!entry->referenced)
+            {
+                result_cache_remove(cache, cache->hand);
+                cache->evictions++;
+                return;
+            }
+            entry->referenced = 0; // second chance
+        }
+        cache->hand = (cache->hand + 1) & (cache->capacity - 1);
+    }
+}
+/**
+ * @brief Stores a result for a key that result_cache_find() just missed.
+ * @return 1 if stored, 0 if the key is too long to cache.
+ */
+static inline int result_cache_store(ResultCache* cache, const char* key, size_t length, uint64_t hash,
+                                     double value, int status)
+{
+    if (length == 0 || length > RESULT_CACHE_KEY_LENGTH)
+    {
+        return 0;
+    }
+    if (cache->count >= cache->limit)
+    {
+        result_cache_evict(cache);
+    }
+    size_t mask = cache->capacity - 1;
+    size_t slot = hash & mask;
+    while (cache->slots[slot].length != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    CachedResult* entry = &cache->slots[slot];
+    entry->hash = hash;
+    entry->length = (unsigned short)length;
+    entry->referenced = 0; // earns its bit on the first hit
+    entry->status = (unsigned char)status;
+    entry->value = value;
+    memcpy(entry->key, key, length);
+    cache->count++;
+    return 1;
+}
+
+#endif // RESULT_CACHE_H
@@ -3,67 +3,392 @@ __Project Name: Digital Clock
 __Author: Shad Hossain Fardin
 __Date: 27th May 2025
 */
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L // For setenv(), localtime_r(), clock_nanosleep()
+#endif
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
-#include <stdlib.h> // for system function
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
-#include <unistd.h> // for sleep function
+#ifdef _WIN32
+    #include <windows.h> // For Sleep()
+#endif
+
+#include "../common/input.h"  // keys while the clock runs, line input
+#include "../common/screen.h" // incremental terminal renderer
+#include "time_formatter.h"    // cached local time/date formatting
+/*=============== Constant ===============*/
+#define MAX_ZONES 12
+#define SCREEN_ROWS (10 + MAX_ZONES)
+#define SCREEN_COLS 80
+#define ZONE_LINE_LENGTH 1024
+#define DEFAULT_ZONES "UTC America/New_York Europe/London Asia/Dhaka Asia/Tokyo"
+#define MAX_REFRESH_RATE 1000      // stopwatch/countdown redraws per second
+#define MAX_COUNTDOWN 359999       // 99:59:59, in seconds
+#define NANOSECONDS 1000000000LL
+#define BENCH_TIMESTAMPS 10000000 // default count for --bench
+/*=============== Type ===============*/
+typedef enum
+{
+    MODE_LOCAL_CLOCK = 1,
+    MODE_WORLD_CLOCK,
+    MODE_STOPWATCH,
+    MODE_COUNTDOWN
+} ClockMode;
+// How late each tick woke up compared to its deadline.
+typedef struct
+{
+    double last, max, total; // milliseconds
+    long ticks, skipped;     // skipped: ticks lost to a stall or a clock jump
+} TickJitter;
+/*=============== Global ===============*/
+volatile sig_atomic_t interrupted = 0; // set by Ctrl+C in the stopwatch and countdown
 /*=============== Function Prototypes ===============*/
+int input_number(const char*, int, int);
 int input_format();
-void fill_current_time_date(char*, char*, int);
-void clear_screen();
+int input_zones(TimeFormatter[], TimeFormat);
+void run_clock(Screen*, TimeFormatter[], int);
+void run_timer(Screen*, long long, int);
+void format_duration(char*, size_t, long long);
+int run_formatter_bench(long);
+long long clock_now_ns(int);
+void sleep_until_ns(int, long long);
+int wait_until_ns(int, long long);
+void record_jitter(TickJitter*, long long);
+void handle_interrupt(int);
 /*======================= Main =======================*/
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        return run_formatter_bench((argc > 2) ? atol(argv[2]) : BENCH_TIMESTAMPS);
+    }
     printf("\n--------------------------------------------------------------\n");
     printf("\t\tWelcome to the Digital Clock Program!");
     printf("\n--------------------------------------------------------------\n");
 
-    int format_choice = input_format();
-    char time_string[50], date_string[100]; // to hold the formatted time and date string
-    while (1)
+    printf("\n1. Local clock");
+    printf("\n2. World clock");
+    printf("\n3. Stopwatch");
+    printf("\n4. Countdown");
+    ClockMode mode = input_number("\nChoose a mode (1-4): ", MODE_LOCAL_CLOCK, MODE_COUNTDOWN);
+
+    // caches the broken-down time of each zone; dates are formatted once a day
+    static TimeFormatter formatters[MAX_ZONES + 1];
+    int zone_count = 0;
+    long long countdown_ms = 0;
+    int refresh_rate = 1;
+    if (mode == MODE_LOCAL_CLOCK || mode == MODE_WORLD_CLOCK)
+    {
+        TimeFormat format = (input_format() == 1) ? TIME_FORMAT_24H : TIME_FORMAT_12H;
+        time_formatter_init(&formatters[0], format);
+        if (mode == MODE_WORLD_CLOCK)
+        {
+            zone_count = input_zones(formatters + 1, format);
+        }
+    }
+    else
     {
-        clear_screen(); // clear the console screen
-        fill_current_time_date(time_string, date_string, format_choice);
-        printf("\n--------------------------------------------------------------\n");
-        printf("\t\t\tDigital Clock");
-        printf("\n--------------------------------------------------------------\n");
-        printf("Current time: %s\n", time_string);
-        printf("Date: %s\n", date_string);
-        sleep(1); // sleep for 1 second
+        if (mode == MODE_COUNTDOWN)
+        {
+            countdown_ms = input_number("\nCountdown length in seconds: ", 1, MAX_COUNTDOWN) * 1000LL;
+        }
+        refresh_rate = input_number("\nRefresh rate in Hz (1-1000, e.g. 20): ", 1, MAX_REFRESH_RATE);
     }
+
+    Screen screen;
+    if (!screen_init(&screen, SCREEN_ROWS, SCREEN_COLS))
+    {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    input_raw(input_stdin(), 1); // keys arrive without Enter and are not echoed over the display
+    if (mode == MODE_LOCAL_CLOCK || mode == MODE_WORLD_CLOCK)
+    {
+        run_clock(&screen, formatters, zone_count);
+    }
+    else
+    {
+        run_timer(&screen, countdown_ms, refresh_rate);
+    }
+    input_raw(input_stdin(), 0);
+    screen_free(&screen);
     return 0;
 }
 /*================= Function Definition =================*/
+int input_number(const char* prompt, int min, int max)
+{
+    int value;
+    while (1)
+    {
+        printf("%s", prompt);
+        int result = input_int(input_stdin(), &value);
+        if (result < 0)
+        {
+            exit(0); // no more input
+        }
+        if (result == 1 && value >= min && value <= max)
+        {
+            return value;
+        }
+        printf("Please enter a number from %d to %d.", min, max);
+    }
+}
 int input_format()
 {
-    int format;
     printf("\nChoose the time format: ");
     printf("\n1. 24 Hour format");
     printf("\n2. 12 Hour format (default)");
-    printf("\nMake a choice (1/2): ");
-    scanf("%d", &format);
-    return format;
+    return input_number("\nMake a choice (1/2): ", 1, 2);
+}
+int input_zones(TimeFormatter formatters[], TimeFormat format)
+{
+    char line[ZONE_LINE_LENGTH];
+    printf("\nEnter up to %d time zones separated by spaces (e.g. Asia/Dhaka Europe/London),", MAX_ZONES);
+    printf("\nor press Enter for %s: ", DEFAULT_ZONES);
+    if (!input_line(input_stdin(), line, sizeof(line), 0, NULL, NULL) || strspn(line, " \t") == strlen(line))
+    {
+        strcpy(line, DEFAULT_ZONES);
+    }
+    int count = 0;
+    for (char* zone = strtok(line, " \t\r\n"); zone != NULL && count < MAX_ZONES; zone = strtok(NULL, " \t\r\n"))
+    {
+        time_formatter_init(&formatters[count], format);
+        time_formatter_set_zone(&formatters[count], zone);
+        count++;
+    }
+    return count;
+}
+void run_clock(Screen* screen, TimeFormatter formatters[], int zone_count)
+{
+    TickJitter jitter = {0};
+    long long now = clock_now_ns(0);
+    long long deadline = now - now % NANOSECONDS; // show the current second right away
+    while (1)
+    {
+        // Compose the frame; only the characters that changed reach the terminal.
+        // The frame shows the deadline's second, so no second is shown twice or skipped.
+        time_t second = (time_t)(deadline / NANOSECONDS);
+        screen_begin_frame(screen);
+        screen_printf(screen, "\n--------------------------------------------------------------\n");
+        screen_printf(screen, (zone_count > 0) ? "\t\t\tWorld Clock" : "\t\t\tDigital Clock");
+        screen_printf(screen, "\n--------------------------------------------------------------\n");
+        screen_printf(screen, "Current time: %s\n", time_formatter_time(&formatters[0], second));
+        screen_printf(screen, "Date: %s\n", time_formatter_date(&formatters[0], second));
+        if (zone_count > 0)
+        {
+            screen_printf(screen, "\n%-24.24s %-12s %s\n", "Zone", "Time", "Date");
+        }
+        for (int i = 1; i <= zone_count; i++)
+        {
+            TimeFormatter* zone = &formatters[i];
+            const char* time_text = time_formatter_time(zone, second);
+            screen_printf(screen, "%-24.24s %-12s %s\n", zone->zone, time_text, time_formatter_date(zone, second));
+        }
+        screen_printf(screen, "Tick jitter: %.3f ms (avg %.3f ms, max %.3f ms, %ld skipped)\n", jitter.last,
+                      jitter.ticks ? jitter.total / jitter.ticks : 0.0, jitter.max, jitter.skipped);
+        screen_printf(screen, "Press q to quit.\n");
+        screen_present(screen);
+
+        // Sleep until the next absolute second boundary. The deadline does not
+        // depend on how long this iteration took, so the clock never drifts.
+        deadline += NANOSECONDS;
+        now = clock_now_ns(0);
+        if (now >= deadline + NANOSECONDS) // stalled or the clock jumped ahead
+        {
+            jitter.skipped += (now - deadline) / NANOSECONDS;
+            deadline = now - now % NANOSECONDS;
+        }
+        else if (now < deadline - 2 * NANOSECONDS) // the clock was set back
+        {
+            deadline = now - now % NANOSECONDS + NANOSECONDS;
+        }
+        if (wait_until_ns(0, deadline))
+        {
+            return; // q pressed
+        }
+        record_jitter(&jitter, clock_now_ns(0) - deadline);
+    }
+}
+void run_timer(Screen* screen, long long countdown_ms, int refresh_rate)
+{
+    // CLOCK_MONOTONIC: setting the wall clock does not disturb a running timer
+    long long period = NANOSECONDS / refresh_rate;
+    long long start = clock_now_ns(1);
+    long long deadline = start;
+    TickJitter jitter = {0};
+    char text[32];
+    interrupted = 0;
+    signal(SIGINT, handle_interrupt);
+    while (1)
+    {
+        long long elapsed_ms = (clock_now_ns(1) - start) / 1000000;
+        int finished = interrupted || (countdown_ms > 0 && elapsed_ms >= countdown_ms);
+        if (countdown_ms > 0)
+        {
+            format_duration(text, sizeof(text), (elapsed_ms < countdown_ms) ? countdown_ms - elapsed_ms : 0);
+        }
+        else
+        {
+            format_duration(text, sizeof(text), elapsed_ms);
+        }
+
+        screen_begin_frame(screen);
+        screen_printf(screen, "\n--------------------------------------------------------------\n");
+        screen_printf(screen, (countdown_ms > 0) ? "\t\t\tCountdown" : "\t\t\tStopwatch");
+        screen_printf(screen, "\n--------------------------------------------------------------\n");
+        screen_printf(screen, "%s: %s\n", (countdown_ms > 0) ? "Remaining" : "Elapsed", text);
+        screen_printf(screen, "Refresh: %d Hz, jitter %.3f ms (max %.3f ms, %ld frames skipped)\n", refresh_rate,
+                      jitter.last, jitter.max, jitter.skipped);
+        if (!finished)
+        {
+            screen_printf(screen, "Press q or Ctrl+C to stop.\n");
+        }
+        else if (interrupted)
+        {
+            screen_printf(screen, "Stopped.\n");
+        }
+        else
+        {
+            screen_printf(screen, "Time is up!\a\n");
+        }
+        screen_present(screen);
+        if (finished)
+        {
+            break;
+        }
+
+        deadline += period;
+        long long now = clock_now_ns(1);
+        if (now >= deadline + period) // fell behind: drop frames rather than catch up
+        {
+            jitter.skipped += (now - deadline) / period;
+            deadline += (now - deadline) / period * period;
+        }
+        if (wait_until_ns(1, deadline))
+        {
+            interrupted = 1; // q stops like Ctrl+C
+        }
+        if (!interrupted)
+        {
+            record_jitter(&jitter, clock_now_ns(1) - deadline);
+        }
+    }
+    signal(SIGINT, SIG_DFL);
+}
+void format_duration(char* buffer, size_t size, long long ms)
+{
+    snprintf(buffer, size, "%02lld:%02lld:%02lld.%03lld", ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
 }
-void fill_current_time_date(char* buffer_time, char* buffer_date, int format)
+int run_formatter_bench(long count)
 {
-    time_t raw_time = time(NULL);
-    struct tm* current_time = localtime(&raw_time);            // get the current local time
-    strftime(buffer_date, 100, "%A, %B %d, %Y", current_time); // format the date
-    if (format == 1)                                           // 24-hour format
+    if (count < 1)
     {
-        strftime(buffer_time, 50, "%H:%M:%S", current_time);
+        printf("Usage: --bench [timestamps]\n");
+        return 1;
     }
-    else // 12-hour format (default)
+    TimeFormatter formatter;
+    time_formatter_init(&formatter, TIME_FORMAT_24H);
+    char buffer[TIME_TIMESTAMP_LENGTH];
+    unsigned checksum = 0;
+    struct timespec stamp;
+    timespec_get(&stamp, TIME_UTC);
+
+    // Cached formatter, one timestamp per simulated microsecond
+    long long start = clock_now_ns(1);
+    for (long i = 0; i < count; i++)
+    {
+        time_formatter_timestamp(&formatter, &stamp, buffer);
+        checksum += (unsigned char)buffer[22];
+        stamp.tv_nsec += 1000;
+        if (stamp.tv_nsec >= NANOSECONDS)
+        {
+            stamp.tv_sec++;
+            stamp.tv_nsec -= NANOSECONDS;
+        }
+    }
+    double cached_seconds = (clock_now_ns(1) - start) / 1e9;
+
+    // Baseline: localtime() + strftime() for every timestamp, on a tenth of the count
+    long baseline_count = (count >= 10) ? count / 10 : 1;
+    start = clock_now_ns(1);
+    for (long i = 0; i < baseline_count; i++)
     {
-        strftime(buffer_time, 50, "%I:%M:%S %p", current_time);
+        time_t seconds = stamp.tv_sec + i / 1000000;
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&seconds));
+        checksum += (unsigned char)buffer[18];
     }
+    double baseline_seconds = (clock_now_ns(1) - start) / 1e9;
+
+    printf("Cached formatter:   %.1f M timestamps/s (%ld localtime calls)\n", count / cached_seconds / 1e6,
+           formatter.refreshes);
+    printf("localtime+strftime: %.1f M timestamps/s\n", baseline_count / baseline_seconds / 1e6);
+    printf("Checksum: %u\n", checksum);
+    return 0;
 }
-void clear_screen()
+long long clock_now_ns(int monotonic)
 {
-// OS based command
+    struct timespec now;
 #ifdef _WIN32
-    system("cls"); // clear screen for Windows
+    (void)monotonic;
+    timespec_get(&now, TIME_UTC);
 #else
-    system("clear"); // clear screen for Unix/Linux
+    clock_gettime(monotonic ? CLOCK_MONOTONIC : CLOCK_REALTIME, &now);
 #endif
+    return now.tv_sec * NANOSECONDS + now.tv_nsec;
 }
+void sleep_until_ns(int monotonic, long long deadline)
+{
+#ifdef _WIN32
+    long long remaining = (deadline - clock_now_ns(monotonic)) / 1000000;
+    if (remaining > 0)
+    {
+        Sleep((DWORD)remaining);
+    }
+#else
+    // TIMER_ABSTIME: a signal or a slow iteration cannot push the wake-up later
+    struct timespec until = {.tv_sec = deadline / NANOSECONDS, .tv_nsec = deadline % NANOSECONDS};
+    while (clock_nanosleep(monotonic ? CLOCK_MONOTONIC : CLOCK_REALTIME, TIMER_ABSTIME, &until, NULL) == EINTR &&
+           !interrupted)
+    {
+    }
+#endif
+}
+int wait_until_ns(int monotonic, long long deadline)
+{
+    // Watch the keyboard until the last millisecond, then sleep the exact rest
+    Input* input = input_stdin();
+    long long remaining_ms;
+    while (!interrupted && (remaining_ms = (deadline - clock_now_ns(monotonic)) / 1000000 - 1) > 0)
+    {
+        int key = input_key(input, (int)remaining_ms);
+        if (key == 'q' || key == 'Q')
+        {
+            return 1;
+        }
+        if (key == INPUT_EOF)
+        {
+            break; // no keyboard: just sleep
+        }
+    }
+    sleep_until_ns(monotonic, deadline);
+    return 0;
+}
+void record_jitter(TickJitter* jitter, long long late_ns)
+{
+    jitter->last = late_ns / 1e6;
+    if (jitter->last > jitter->max)
+    {
+        jitter->max = jitter->last;
+    }
+    jitter->total += jitter->last;
+    jitter->ticks++;
+}
+void handle_interrupt(int signal_number)
+{
+    (void)signal_number;
+    interrupted = 1;
+}
\ No newline at end of file
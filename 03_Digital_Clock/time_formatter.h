@@ -0,0 +1,391 @@
+/*
+ * Module Name: Time Formatter
+ * Date: 19th October 2026
+ *
+ * Formats wall-clock times without calling localtime() and strftime() for
+ * every timestamp. The broken-down local time is cached for a window of
+ * TIME_WINDOW_SECONDS (15 minutes of UTC). UTC offsets are whole quarter
+ * hours, so neither a minute, an hour, a day nor a DST change can start
+ * inside a window. Inside the window the minutes and seconds follow from
+ * the distance to the window start. The hour, the AM/PM suffix and the
+ * date are copied from strings prepared when the window was entered. The
+ * long date is reformatted with strftime() only when the day changes.
+ *
+ * The TZ variable is compared with its last value at most once per second,
+ * and tzset() runs only when it changed.
+ *
+ * A formatter can be pinned to a zone with time_formatter_set_zone(), e.g.
+ * for a world clock. The zone's UTC offsets and their changes over the next
+ * TIME_ZONE_SPAN_DAYS are tabulated once, by switching TZ for a moment, and
+ * local time is gmtime() of the time plus the offset. Only
+ * time_formatter_set_zone(), and a pinned formatter whose table has run out,
+ * touch TZ. Call it before starting other threads that use local time.
+ *
+ * One formatter per thread; the formatter itself takes no locks.
+ *
+ * Usage:
+ *     TimeFormatter formatter;
+ *     time_formatter_init(&formatter, TIME_FORMAT_24H);
+ *     printf("%s\n", time_formatter_time(&formatter, time(NULL)));   // "17:42:05"
+ *     time_formatter_timestamp(&formatter, &now, buffer);             // "2026-10-19 17:42:05.123"
+ */
+#ifndef TIME_FORMATTER_H
+#define TIME_FORMATTER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*================= Constant =================*/
+#define TIME_WINDOW_SECONDS 900       // Cache window; every UTC offset is a multiple of it.
+#define TIME_DATE_LENGTH 100
+#define TIME_TZ_LENGTH 128
+#define TIME_TIMESTAMP_LENGTH 24      // "YYYY-MM-DD HH:MM:SS.mmm" plus '\0'.
+#define TIME_ZONE_SPAN_DAYS 400       // Pinned zones are tabulated this far ahead.
+#define TIME_MAX_TRANSITIONS 16       // Offset changes kept per pinned zone (DST: 2 a year).
+/*================= Type =================*/
+typedef enum
+{
+    TIME_FORMAT_24H = 1, // "17:42:05"
+    TIME_FORMAT_12H = 2  // "05:42:05 PM"
+} TimeFormat;
+// UTC offset of a pinned zone from a moment on.
+typedef struct
+{
+    time_t start;
+    long offset; // Seconds east of UTC.
+} TimeTransition;
+typedef struct
+{
+    TimeFormat format;
+    time_t window_start, window_end; // The cache is valid for [window_start, window_end).
+    int window_minute, window_second; // Local minute and second at window_start.
+    int day_key;                     // year * 400 + day of year of the cached date.
+    char date[TIME_DATE_LENGTH];     // "Monday, October 19, 2026"
+    char time[12];                   // "HH:MM:SS" or "hh:MM:SS AM"; only MM:SS changes inside a window.
+    char timestamp[TIME_TIMESTAMP_LENGTH]; // "YYYY-MM-DD HH:" prefix, rest filled per call.
+    time_t last_tz_check;
+    char tz[TIME_TZ_LENGTH];         // TZ as seen at the last check, "" when unset.
+    char zone[TIME_TZ_LENGTH];       // Pinned zone, "" to follow the process TZ.
+    TimeTransition transitions[TIME_MAX_TRANSITIONS]; // Offsets of the pinned zone, oldest first.
+    int transition_count;
+    time_t zone_start, zone_end;     // The table covers [zone_start, zone_end).
+    long refreshes;                  // localtime() calls, for statistics.
+} TimeFormatter;
+/*================= Function Definition =================*/
+/**
+ * @brief Writes a number 0-99 as two digits.
+ */
+static inline void time_put_2digits(char* out, int value)
+{
+    out[0] = (char)('0' + value / 10);
+    out[1] = (char)('0' + value % 10);
+}
+/**
+ * @brief Calls tzset() if the TZ variable changed since the last check.
+ */
+static inline void time_formatter_check_tz(TimeFormatter* formatter)
+{
+    const char* tz = getenv("TZ");
+    if (tz == NULL)
+    {
+        tz = "";
+    }
+    if (strncmp(tz, formatter->tz, TIME_TZ_LENGTH) != 0)
+    {
+        strncpy(formatter->tz, tz, TIME_TZ_LENGTH - 1);
+        formatter->tz[TIME_TZ_LENGTH - 1] = '\0';
+#ifdef _WIN32
+        _tzset();
+#else
+        tzset();
+#endif
+        formatter->window_end = formatter->window_start; // Offsets may differ now.
+    }
+}
+/**
+ * @brief Sets or restores the TZ variable; NULL unsets it.
+ */
+static inline void time_set_tz(const char* tz)
+{
+#ifdef _WIN32
+    _putenv_s("TZ", (tz != NULL) ? tz : "");
+    _tzset();
+#else
+    if (tz != NULL)
+    {
+        setenv("TZ", tz, 1);
+    }
+    else
+    {
+        unsetenv("TZ");
+    }
+    tzset();
+#endif
+}
+/**
+ * @brief Returns the offset from UTC of a broken-down local time, in seconds.
+ */
+static inline long time_utc_offset(const struct tm* local, time_t now)
+{
+    // Days since 1970-01-01 of the local date (proleptic Gregorian calendar).
+    long year = local->tm_year + 1900L - (local->tm_mon < 2);
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long year_of_era = year - era * 400;
+    long day_of_year = (153 * (local->tm_mon + (local->tm_mon < 2 ? 10 : -2)) + 2) / 5 + local->tm_mday - 1;
+    long days = era * 146097 + year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year - 719468;
+    return (long)(days * 86400 + local->tm_hour * 3600 + local->tm_min * 60 + local->tm_sec - now);
+}
+/**
+ * @brief Returns the offset from UTC of the current TZ at a time.
+ */
+static inline long time_offset_at(time_t now)
+{
+    struct tm local;
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return time_utc_offset(&local, now);
+}
+/**
+ * @brief Tabulates the pinned zone's offsets for TIME_ZONE_SPAN_DAYS from a time.
+ * Sets TZ to the zone for the duration, so no other thread may use local time meanwhile.
+ * @param formatter The formatter.
+ * @param now Start of the table.
+ */
+static inline void time_formatter_load_zone(TimeFormatter* formatter, time_t now)
+{
+    char saved[TIME_TZ_LENGTH];
+    const char* previous = getenv("TZ");
+    if (previous != NULL)
+    {
+        strncpy(saved, previous, TIME_TZ_LENGTH - 1);
+        saved[TIME_TZ_LENGTH - 1] = '\0';
+        previous = saved;
+    }
+    time_set_tz(formatter->zone);
+
+    time_t start = now - now % TIME_WINDOW_SECONDS; // Tables end on a window boundary too.
+    long offset = time_offset_at(start);
+    formatter->transitions[0] = (TimeTransition){.start = start, .offset = offset};
+    formatter->transition_count = 1;
+    time_t day = start;
+    for (int i = 0; i < TIME_ZONE_SPAN_DAYS && formatter->transition_count < TIME_MAX_TRANSITIONS; i++)
+    {
+        time_t next_day = day + 86400;
+        long next_offset = time_offset_at(next_day);
+        if (next_offset != offset)
+        {
+            // Binary search for the first second with the new offset.
+            time_t before = day, after = next_day;
+            while (after - before > 1)
+            {
+                time_t middle = before + (after - before) / 2;
+                if (time_offset_at(middle) == offset)
+                {
+                    before = middle;
+                }
+                else
+                {
+                    after = middle;
+                }
+            }
+            formatter->transitions[formatter->transition_count++] = (TimeTransition){.start = after, .offset = next_offset};
+            offset = next_offset;
+        }
+        day = next_day;
+    }
+    formatter->zone_start = start;
+    formatter->zone_end = day;
+    time_set_tz(previous);
+}
+/**
+ * @brief Converts a time to the formatter's zone.
+ */
+static inline void time_formatter_localtime(TimeFormatter* formatter, time_t now, struct tm* local)
+{
+    if (formatter->zone[0] == '\0')
+    {
+#ifdef _WIN32
+        localtime_s(local, &now);
+#else
+        localtime_r(&now, local);
+#endif
+        return;
+    }
+    if (now < formatter->zone_start || now >= formatter->zone_end)
+    {
+        time_formatter_load_zone(formatter, now);
+    }
+    long offset = formatter->transitions[0].offset;
+    for (int i = 1; i < formatter->transition_count && formatter->transitions[i].start <= now; i++)
+    {
+        offset = formatter->transitions[i].offset;
+    }
+    time_t shifted = now + offset; // gmtime() reads no environment, unlike a TZ switch.
+#ifdef _WIN32
+    gmtime_s(local, &shifted);
+#else
+    gmtime_r(&shifted, local);
+#endif
+}
+/**
+ * @brief Re-reads the local time for the window that contains a time.
+ * @param formatter The formatter.
+ * @param now The time that fell outside the cached window.
+ */
+static inline void time_formatter_refresh(TimeFormatter* formatter, time_t now)
+{
+    struct tm local;
+    time_formatter_localtime(formatter, now, &local);
+    formatter->refreshes++;
+    time_t offset = now % TIME_WINDOW_SECONDS;
+    if (offset < 0)
+    {
+        offset += TIME_WINDOW_SECONDS;
+    }
+    if (local.tm_sec != offset % 60 || local.tm_min % 15 != offset / 60)
+    {
+        // Not a quarter-hour offset (historical local mean time): cache one second only.
+        formatter->window_start = now;
+        formatter->window_end = now + 1;
+        formatter->window_minute = local.tm_min;
+        formatter->window_second = local.tm_sec;
+    }
+    else
+    {
+        formatter->window_start = now - offset;
+        formatter->window_end = formatter->window_start + TIME_WINDOW_SECONDS;
+        formatter->window_minute = local.tm_min - (int)(offset / 60);
+        formatter->window_second = 0;
+    }
+
+    int day_key = (local.tm_year + 1900) * 400 + local.tm_yday;
+    if (day_key != formatter->day_key) // Day rollover: the only strftime() call.
+    {
+        strftime(formatter->date, TIME_DATE_LENGTH, "%A, %B %d, %Y", &local);
+        formatter->day_key = day_key;
+    }
+
+    int hour = local.tm_hour;
+    if (formatter->format == TIME_FORMAT_12H)
+    {
+        strcpy(formatter->time, "hh:MM:SS AM");
+        formatter->time[9] = (hour >= 12) ? 'P' : 'A';
+        hour = (hour % 12 == 0) ? 12 : hour % 12;
+    }
+    else
+    {
+        strcpy(formatter->time, "hh:MM:SS");
+    }
+    time_put_2digits(formatter->time, hour);
+
+    char* stamp = formatter->timestamp; // "YYYY-MM-DD HH:"
+    int year = local.tm_year + 1900;
+    time_put_2digits(stamp, (year / 100) % 100);
+    time_put_2digits(stamp + 2, year % 100);
+    stamp[4] = '-';
+    time_put_2digits(stamp + 5, local.tm_mon + 1);
+    stamp[7] = '-';
+    time_put_2digits(stamp + 8, local.tm_mday);
+    stamp[10] = ' ';
+    time_put_2digits(stamp + 11, local.tm_hour);
+    stamp[13] = ':';
+}
+/**
+ * @brief Makes sure the cache covers a time.
+ * @param formatter The formatter.
+ * @param now Seconds since the epoch.
+ */
+static inline void time_formatter_update(TimeFormatter* formatter, time_t now)
+{
+    if (now != formatter->last_tz_check && formatter->zone[0] == '\0') // At most once per second.
+    {
+        formatter->last_tz_check = now;
+        time_formatter_check_tz(formatter);
+    }
+    if (now < formatter->window_start || now >= formatter->window_end)
+    {
+        time_formatter_refresh(formatter, now);
+    }
+}
+/**
+ * @brief Sets up a formatter.
+ * @param formatter The formatter.
+ * @param format 12 or 24 hour clock for time_formatter_time().
+ */
+static inline void time_formatter_init(TimeFormatter* formatter, TimeFormat format)
+{
+    memset(formatter, 0, sizeof(*formatter));
+    formatter->format = format;
+    formatter->day_key = -1;
+    formatter->last_tz_check = (time_t)-1;
+    formatter->tz[0] = '\x01'; // Never equal to a real TZ: the first check calls tzset().
+}
+/**
+ * @brief Pins a formatter to a zone instead of the process TZ.
+ * Switches TZ briefly to tabulate the zone; call it before other threads use local time.
+ * @param formatter The formatter.
+ * @param zone A TZ value such as "Asia/Dhaka", or NULL to follow TZ again.
+ */
+static inline void time_formatter_set_zone(TimeFormatter* formatter, const char* zone)
+{
+    snprintf(formatter->zone, TIME_TZ_LENGTH, "%s", (zone != NULL) ? zone : "");
+    formatter->window_end = formatter->window_start; // Refresh on the next call.
+    formatter->day_key = -1;
+    if (formatter->zone[0] != '\0')
+    {
+        time_formatter_load_zone(formatter, time(NULL));
+    }
+}
+/**
+ * @brief Formats the time of day.
+ * @param formatter The formatter.
+ * @param now Seconds since the epoch.
+ * @return "HH:MM:SS" or "hh:MM:SS AM", valid until the next call.
+ */
+static inline const char* time_formatter_time(TimeFormatter* formatter, time_t now)
+{
+    time_formatter_update(formatter, now);
+    int elapsed = formatter->window_second + (int)(now - formatter->window_start);
+    time_put_2digits(formatter->time + 3, formatter->window_minute + elapsed / 60);
+    time_put_2digits(formatter->time + 6, elapsed % 60);
+    return formatter->time;
+}
+/**
+ * @brief Formats the date, e.g. "Monday, October 19, 2026".
+ * @param formatter The formatter.
+ * @param now Seconds since the epoch.
+ * @return The date, valid until the day changes.
+ */
+static inline const char* time_formatter_date(TimeFormatter* formatter, time_t now)
+{
+    time_formatter_update(formatter, now);
+    return formatter->date;
+}
+/**
+ * @brief Formats a log timestamp with milliseconds.
+ * @param formatter The formatter.
+ * @param now Wall-clock time, e.g. from timespec_get().
+ * @param out At least TIME_TIMESTAMP_LENGTH bytes; receives "YYYY-MM-DD HH:MM:SS.mmm".
+ * @return Length of the timestamp (23).
+ */
+static inline size_t time_formatter_timestamp(TimeFormatter* formatter, const struct timespec* now, char* out)
+{
+    time_formatter_update(formatter, now->tv_sec);
+    int elapsed = formatter->window_second + (int)(now->tv_sec - formatter->window_start);
+    int millisecond = (int)(now->tv_nsec / 1000000);
+    memcpy(out, formatter->timestamp, 14);
+    time_put_2digits(out + 14, formatter->window_minute + elapsed / 60);
+    out[16] = ':';
+    time_put_2digits(out + 17, elapsed % 60);
+    out[19] = '.';
+    out[20] = (char)('0' + millisecond / 100);
+    time_put_2digits(out + 21, millisecond % 100);
+    out[23] = '\0';
+    return 23;
+}
+
+#endif // TIME_FORMATTER_H
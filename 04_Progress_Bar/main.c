@@ -3,93 +3,563 @@ __Project Name: Progress Bar
 __Author: Shad Hossain Fardin
 __Date: 28th May 2025
 */
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
+
+#include "../common/input.h"   // q to cancel while the bars run
+#include "../common/random.h"  // per-thread xoshiro256** generator
+#include "progress_tracker.h" // lock-free progress reporting + renderer thread
 /*================= Constant =================*/
-#define MAX_BAR_LENGTH 100
-#define TASK_NUMBER 5
+#define TASK_NUMBER 5                // default number of tasks
+#define REFRESH_RATE 10              // default redraws per second
+#define MIN_TASK_UNITS 50            // default smallest task, in work units
+#define MAX_TASK_UNITS 2000          // default largest task, in work units
+#define TASK_SKEW 2                  // default skew: 0 is uniform, higher means few large tasks
+#define MAX_TASK_SKEW 10
+#define WORK_UNIT_ITERATIONS 2000000 // arithmetic steps per work unit (a few ms)
+#define GRAIN_UNITS 16               // ranges larger than this are split in half
+#define MAX_WORKERS 64
+#define PIPE_BUFFER_SIZE (1 << 17)   // bytes moved per read() in --pipe mode
+#define IDLE_WAIT_MS 10              // longest nap of an idle worker; new ranges wake it sooner
 /*================= Type =================*/
 typedef struct
 {
     int id;
-    int bar_step; // progress speed
-    int progress; // progress in percentage
+    uint64_t work_units; // task size
 } Task;
+// A slice [begin, end) of one task's work units.
+typedef struct
+{
+    int task;
+    uint64_t begin, end;
+} WorkRange;
+// Per-worker double-ended queue. The owner pushes and pops at the tail
+// (newest, smallest ranges, still warm in cache); thieves take from the
+// head, where the oldest and largest ranges are.
+typedef struct
+{
+    pthread_mutex_t lock;
+    WorkRange* items;
+    int head, tail, capacity;
+} WorkDeque;
+typedef struct WorkPool WorkPool;
+typedef struct
+{
+    int id;
+    WorkPool* pool;
+    WorkDeque deque;
+    Random victims; // picks where to start looking for work to steal
+    // statistics, written by this worker only
+    uint64_t units, ranges, steals;
+    double busy_seconds;
+} Worker;
+struct WorkPool
+{
+    Task* tasks;
+    Worker workers[MAX_WORKERS];
+    int worker_count;
+    atomic_uint_fast64_t remaining_units; // 0 once every task is finished
+    atomic_int cancelled;                 // set when the user presses q
+    ProgressTracker* tracker;
+    // Workers without work sleep here instead of spinning
+    pthread_mutex_t idle_lock;
+    pthread_cond_t work_ready; // signalled when ranges are pushed and when all work ends
+    atomic_int idle_workers;   // workers inside wait_for_work()
+};
+// Command line settings of the simulator.
+typedef struct
+{
+    int task_count, refresh_rate, worker_count, skew;
+    uint64_t min_units, max_units;
+    uint64_t seed; // same seed, same task sizes
+    ProgressStyle style;
+} SimulationSettings;
+/*================= Global =================*/
+volatile uint64_t work_sink; // keeps the compiler from removing the work
 /*================= Function Prototypes =================*/
-void print_pogress_bar(Task tasks);
-void input_structure(Task tasks[]);
-void clear_screen();
-void run_progress_simulation(Task tasks[]);
+int parse_arguments(int argc, char* argv[], SimulationSettings* settings);
+void input_structure(Task tasks[], const SimulationSettings* settings);
+uint64_t do_work_unit(uint64_t seed);
+int deque_push(WorkDeque* deque, WorkRange range);
+int deque_pop(WorkDeque* deque, WorkRange* range);
+int deque_steal(WorkDeque* deque, WorkRange* range);
+int steal_work(Worker* self, WorkRange* range);
+uint64_t execute_range(Worker* self, WorkRange range, uint64_t seed);
+void wake_idle_workers(WorkPool* pool, int all);
+void wait_for_work(WorkPool* pool);
+void* worker_thread(void* arg);
+int get_worker_count();
+void print_worker_report(const WorkPool* pool, double elapsed);
+void run_progress_simulation(Task tasks[], const SimulationSettings* settings);
+int run_pipe_mode(uint64_t expected_bytes, int refresh_rate);
 /*================= Main =================*/
-int main()
+int main(int argc, char* argv[])
 {
-    srand(time(NULL)); // seed generator
-    Task tasks[TASK_NUMBER];
-    input_structure(tasks);
-    run_progress_simulation(tasks);
+    // pv-style: copy stdin to stdout and report the bytes on stderr
+    if (argc > 1 && strcmp(argv[1], "--pipe") == 0)
+    {
+        uint64_t expected_bytes = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0;
+        int refresh_rate = (argc > 3) ? atoi(argv[3]) : REFRESH_RATE;
+        return run_pipe_mode(expected_bytes, refresh_rate);
+    }
+
+    SimulationSettings settings;
+    if (!parse_arguments(argc, argv, &settings))
+    {
+        printf("Usage: %s [tasks] [refresh rate in Hz] [ascii|unicode]\n", argv[0]);
+        printf("          [--workers N] [--min UNITS] [--max UNITS] [--skew 0-%d] [--seed N]\n", MAX_TASK_SKEW);
+        printf("       %s --pipe [expected bytes] [refresh rate in Hz]\n", argv[0]);
+        return 1;
+    }
+
+    Task* tasks = malloc(settings.task_count * sizeof(Task));
+    if (tasks == NULL)
+    {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    input_structure(tasks, &settings);
+    run_progress_simulation(tasks, &settings);
+    free(tasks);
 
     return 0;
 }
 /*================= Function Definition =================*/
-void print_pogress_bar(Task tasks)
+int parse_arguments(int argc, char* argv[], SimulationSettings* settings)
 {
-    int bar_to_show = (tasks.progress * MAX_BAR_LENGTH) / 100;
-    printf("Task %d: [", tasks.id);
-    for (int i = 0; i < MAX_BAR_LENGTH; i++)
+    *settings = (SimulationSettings){
+        .task_count = TASK_NUMBER,
+        .refresh_rate = REFRESH_RATE,
+        .worker_count = get_worker_count(),
+        .skew = TASK_SKEW,
+        .min_units = MIN_TASK_UNITS,
+        .max_units = MAX_TASK_UNITS,
+        .seed = random_entropy(),
+        .style = PROGRESS_STYLE_ASCII,
+    };
+    int position = 0; // index of the next positional argument
+    for (int i = 1; i < argc; i++)
     {
-        if (i < bar_to_show)
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                return 0; // every option takes a value
+            }
+            const char* value = argv[++i];
+            if (strcmp(argv[i - 1], "--workers") == 0)
+            {
+                settings->worker_count = atoi(value);
+            }
+            else if (strcmp(argv[i - 1], "--min") == 0)
+            {
+                settings->min_units = strtoull(value, NULL, 10);
+            }
+            else if (strcmp(argv[i - 1], "--max") == 0)
+            {
+                settings->max_units = strtoull(value, NULL, 10);
+            }
+            else if (strcmp(argv[i - 1], "--skew") == 0)
+            {
+                settings->skew = atoi(value);
+            }
+            else if (strcmp(argv[i - 1], "--seed") == 0)
+            {
+                settings->seed = strtoull(value, NULL, 10);
+            }
+            else
+            {
+                return 0;
+            }
+        }
+        else if (position == 0)
+        {
+            settings->task_count = atoi(argv[i]);
+            position++;
+        }
+        else if (position == 1)
+        {
+            settings->refresh_rate = atoi(argv[i]);
+            position++;
+        }
+        else if (position == 2 && (strcmp(argv[i], "ascii") == 0 || strcmp(argv[i], "unicode") == 0))
         {
-            printf("=");
+            settings->style = (argv[i][0] == 'u') ? PROGRESS_STYLE_BLOCKS : PROGRESS_STYLE_ASCII;
+            position++;
         }
         else
         {
-            printf(" ");
+            return 0;
         }
     }
-    printf("] %3d%%\n", tasks.progress);
+    return settings->task_count >= 1 && settings->refresh_rate >= 1 && settings->worker_count >= 1 &&
+           settings->worker_count <= MAX_WORKERS && settings->skew >= 0 && settings->skew <= MAX_TASK_SKEW &&
+           settings->min_units >= 1 && settings->min_units <= settings->max_units;
 }
-void input_structure(Task tasks[])
+void input_structure(Task tasks[], const SimulationSettings* settings)
 {
-    for (int i = 0; i < TASK_NUMBER; i++)
+    Random random;
+    random_seed(&random, settings->seed);
+    for (int i = 0; i < settings->task_count; i++)
     {
+        // u^(skew+1) piles most tasks near the minimum and leaves a few large ones
+        double u = random_double(&random);
+        double size = u;
+        for (int k = 0; k < settings->skew; k++)
+        {
+            size *= u;
+        }
         tasks[i].id = i + 1;
-        tasks[i].bar_step = rand() % 5 + 1;
-        tasks[i].progress = 0;
+        tasks[i].work_units = settings->min_units + (uint64_t)(size * (settings->max_units - settings->min_units + 1));
+    }
+}
+uint64_t do_work_unit(uint64_t seed)
+{
+    for (int i = 0; i < WORK_UNIT_ITERATIONS; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL; // LCG step
+    }
+    return seed;
+}
+int deque_push(WorkDeque* deque, WorkRange range)
+{
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail == deque->capacity)
+    {
+        int count = deque->tail - deque->head;
+        if (deque->head > 0)
+        {
+            // slide the live items back to the start before growing
+            memmove(deque->items, deque->items + deque->head, count * sizeof(WorkRange));
+        }
+        else
+        {
+            int capacity = deque->capacity ? deque->capacity * 2 : 64;
+            WorkRange* items = realloc(deque->items, capacity * sizeof(WorkRange));
+            if (items == NULL)
+            {
+                pthread_mutex_unlock(&deque->lock);
+                return 0;
+            }
+            deque->items = items;
+            deque->capacity = capacity;
+        }
+        deque->head = 0;
+        deque->tail = count;
+    }
+    deque->items[deque->tail++] = range;
+    pthread_mutex_unlock(&deque->lock);
+    return 1;
+}
+int deque_pop(WorkDeque* deque, WorkRange* range)
+{
+    pthread_mutex_lock(&deque->lock);
+    int found = deque->tail > deque->head;
+    if (found)
+    {
+        *range = deque->items[--deque->tail];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+int deque_steal(WorkDeque* deque, WorkRange* range)
+{
+    pthread_mutex_lock(&deque->lock);
+    int found = deque->tail > deque->head;
+    if (found)
+    {
+        *range = deque->items[deque->head++];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+int steal_work(Worker* self, WorkRange* range)
+{
+    WorkPool* pool = self->pool;
+    if (pool->worker_count < 2)
+    {
+        return 0;
+    }
+    // start at a random victim so thieves spread out
+    int start = (int)random_below(&self->victims, pool->worker_count);
+    for (int i = 0; i < pool->worker_count; i++)
+    {
+        int victim = (start + i) % pool->worker_count;
+        if (victim != self->id && deque_steal(&pool->workers[victim].deque, range))
+        {
+            self->steals++;
+            return 1;
+        }
+    }
+    return 0;
+}
+uint64_t execute_range(Worker* self, WorkRange range, uint64_t seed)
+{
+    WorkPool* pool = self->pool;
+    // split until the range is small, leaving the halves for us or for thieves
+    while (range.end - range.begin > GRAIN_UNITS)
+    {
+        uint64_t middle = range.begin + (range.end - range.begin) / 2;
+        if (!deque_push(&self->deque, (WorkRange){range.task, middle, range.end}))
+        {
+            break; // out of memory: just do the whole range here
+        }
+        wake_idle_workers(pool, 0); // one sleeping worker can steal the new half
+        range.end = middle;
+    }
+    for (uint64_t unit = range.begin; unit < range.end; unit++)
+    {
+        seed = do_work_unit(seed);
+        progress_add(pool->tracker, range.task, 1); // never waits for the display
+    }
+    self->units += range.end - range.begin;
+    self->ranges++;
+    if (atomic_fetch_sub(&pool->remaining_units, range.end - range.begin) == range.end - range.begin)
+    {
+        wake_idle_workers(pool, 1); // last range done: let everyone exit
+    }
+    return seed;
+}
+void wake_idle_workers(WorkPool* pool, int all)
+{
+    if (atomic_load(&pool->idle_workers) == 0)
+    {
+        return; // nobody sleeps: the common case costs one load
+    }
+    pthread_mutex_lock(&pool->idle_lock);
+    if (all)
+    {
+        pthread_cond_broadcast(&pool->work_ready);
+    }
+    else
+    {
+        pthread_cond_signal(&pool->work_ready);
+    }
+    pthread_mutex_unlock(&pool->idle_lock);
+}
+void wait_for_work(WorkPool* pool)
+{
+    struct timespec deadline;
+    timespec_get(&deadline, TIME_UTC); // the clock pthread_cond_timedwait() uses
+    deadline.tv_nsec += IDLE_WAIT_MS * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
     }
+    pthread_mutex_lock(&pool->idle_lock);
+    atomic_fetch_add(&pool->idle_workers, 1);
+    // Registered before this check, so the end of the work always wakes us. A range
+    // pushed between our failed steal and the wait is only caught by the timeout.
+    if (atomic_load(&pool->remaining_units) > 0 && !atomic_load(&pool->cancelled))
+    {
+        pthread_cond_timedwait(&pool->work_ready, &pool->idle_lock, &deadline);
+    }
+    atomic_fetch_sub(&pool->idle_workers, 1);
+    pthread_mutex_unlock(&pool->idle_lock);
 }
-void clear_screen()
+void* worker_thread(void* arg)
+{
+    Worker* self = arg;
+    uint64_t seed = (uint64_t)(uintptr_t)&seed;
+    while (atomic_load(&self->pool->remaining_units) > 0 && !atomic_load(&self->pool->cancelled))
+    {
+        WorkRange range;
+        if (deque_pop(&self->deque, &range) || steal_work(self, &range))
+        {
+            double start = progress_now();
+            seed = execute_range(self, range, seed);
+            self->busy_seconds += progress_now() - start;
+        }
+        else
+        {
+            wait_for_work(self->pool); // someone is still working on the last ranges
+        }
+    }
+    work_sink = seed;
+    return NULL;
+}
+int get_worker_count()
 {
 #ifdef _WIN32
-    system("cls"); // clear screen for Windows
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long cores = info.dwNumberOfProcessors;
 #else
-    system("clear"); // clear screen for Unix/Linux
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
 #endif
+    if (cores < 1)
+    {
+        return 1;
+    }
+    return (cores > MAX_WORKERS) ? MAX_WORKERS : (int)cores;
 }
-void run_progress_simulation(Task tasks[])
+void print_worker_report(const WorkPool* pool, double elapsed)
 {
-    int task_incomplete = 1;
-    while (task_incomplete)
+    printf("\nWorker  Utilization       Units   Ranges   Steals\n");
+    for (int i = 0; i < pool->worker_count; i++)
     {
-        task_incomplete = 0;
-        clear_screen();
-        for (int i = 0; i < TASK_NUMBER; i++)
-        {
-            tasks[i].progress += tasks[i].bar_step;
+        const Worker* worker = &pool->workers[i];
+        double utilization = (elapsed > 0) ? 100.0 * worker->busy_seconds / elapsed : 0;
+        printf("%6d  %10.1f%%  %10llu  %7llu  %7llu\n", i + 1, utilization, (unsigned long long)worker->units,
+               (unsigned long long)worker->ranges, (unsigned long long)worker->steals);
+    }
+    printf("Elapsed: %.2f s\n", elapsed);
+}
+void run_progress_simulation(Task tasks[], const SimulationSettings* settings)
+{
+    ProgressTracker tracker;
+    if (!progress_init(&tracker, settings->task_count, settings->refresh_rate, settings->style))
+    {
+        printf("Out of memory.\n");
+        return;
+    }
+    static WorkPool pool; // too large for the stack with MAX_WORKERS deques
+    pool.tasks = tasks;
+    pool.worker_count = settings->worker_count;
+    pool.tracker = &tracker;
+    uint64_t total_units = 0;
+    for (int i = 0; i < pool.worker_count; i++)
+    {
+        pool.workers[i] = (Worker){.id = i, .pool = &pool};
+        random_seed_stream(&pool.workers[i].victims, settings->seed, (unsigned)i);
+        pthread_mutex_init(&pool.workers[i].deque.lock, NULL);
+    }
+    // deal the tasks out round-robin; skewed sizes leave some workers with far more
+    int dealt = 1;
+    for (int i = 0; i < settings->task_count; i++)
+    {
+        progress_set_item(&tracker, i, NULL, tasks[i].work_units);
+        total_units += tasks[i].work_units;
+        dealt &= deque_push(&pool.workers[i % pool.worker_count].deque, (WorkRange){i, 0, tasks[i].work_units});
+    }
+    atomic_init(&pool.remaining_units, total_units);
+    atomic_init(&pool.cancelled, 0);
+    atomic_init(&pool.idle_workers, 0);
+    pthread_mutex_init(&pool.idle_lock, NULL);
+    pthread_cond_init(&pool.work_ready, NULL);
 
-            if (tasks[i].progress > 100)
+    pthread_t threads[MAX_WORKERS];
+    int started = 0;
+    double start = progress_now();
+    Input* input = input_stdin();
+    if (dealt)
+    {
+        if (input_raw(input, 1))
+        {
+            printf("Press q to cancel.\n");
+        }
+        progress_start(&tracker);
+        for (; started < pool.worker_count; started++)
+        {
+            if (pthread_create(&threads[started], NULL, worker_thread, &pool.workers[started]) != 0)
             {
-                tasks[i].progress = 100;
+                break; // the running workers steal the rest
             }
-
-            if (tasks[i].progress < 100)
+        }
+        if (started == 0)
+        {
+            worker_thread(&pool.workers[0]); // no threads available: work on this one
+        }
+        // Watch the keyboard while the workers run; the renderer thread keeps drawing
+        while (input->raw && atomic_load(&pool.remaining_units) > 0)
+        {
+            int key = input_key(input, 100);
+            if (key == 'q' || key == 'Q')
             {
-                task_incomplete = 1;
+                atomic_store(&pool.cancelled, 1);
+                wake_idle_workers(&pool, 1);
+                break;
+            }
+            if (key == INPUT_EOF)
+            {
+                break;
             }
-            print_pogress_bar(tasks[i]);
         }
-        sleep(1); // sleep for 1 second
+        for (int i = 0; i < started; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        progress_stop(&tracker);
+        input_raw(input, 0);
+    }
+    double elapsed = progress_now() - start;
+
+    pthread_cond_destroy(&pool.work_ready);
+    pthread_mutex_destroy(&pool.idle_lock);
+    for (int i = 0; i < pool.worker_count; i++)
+    {
+        pthread_mutex_destroy(&pool.workers[i].deque.lock);
+        free(pool.workers[i].deque.items);
     }
-    printf("All task completed!!");
+    if (!dealt)
+    {
+        screen_free(&tracker.screen);
+        progress_free_items(tracker.items);
+        printf("Out of memory.\n");
+        return;
+    }
+    print_worker_report(&pool, elapsed);
+    printf(atomic_load(&pool.cancelled) ? "Cancelled." : "All task completed!!");
 }
+int run_pipe_mode(uint64_t expected_bytes, int refresh_rate)
+{
+    ProgressTracker tracker;
+    if (refresh_rate < 1 || !progress_init(&tracker, 1, refresh_rate, PROGRESS_STYLE_ASCII))
+    {
+        fprintf(stderr, "Invalid refresh rate or out of memory.\n");
+        return 1;
+    }
+    progress_set_output(&tracker, stderr); // stdout carries the data
+    progress_set_inline(&tracker, 1);      // keep what is already on the terminal
+    progress_set_item(&tracker, 0, "stdin (bytes)", expected_bytes);
+
+    static char buffer[PIPE_BUFFER_SIZE];
+    int status = 0;
+    progress_start(&tracker);
+    while (1)
+    {
+        ssize_t length = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (length == 0)
+        {
+            break; // end of input
+        }
+        if (length < 0 && errno == EINTR)
+        {
+            continue; // interrupted by a signal (e.g. SIGWINCH), nothing was read
+        }
+        if (length < 0)
+        {
+            status = 1;
+            break;
+        }
+        for (ssize_t written = 0; written < length;)
+        {
+            ssize_t result = write(STDOUT_FILENO, buffer + written, length - written);
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (result <= 0)
+            {
+                status = 1;
+                break;
+            }
+            written += result;
+        }
+        if (status)
+        {
+            break;
+        }
+        progress_add(&tracker, 0, length); // one relaxed atomic add per block
+    }
+    progress_stop(&tracker);
+    return status;
+}
\ No newline at end of file
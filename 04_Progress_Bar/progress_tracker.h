@@ -0,0 +1,499 @@
+/*
+ * Module Name: Progress Tracker
+ * Date: 19th October 2026
+ *
+ * Worker threads report progress with progress_add(), a relaxed atomic
+ * add on a counter in its own cache line, so they never wait for the
+ * display. A single renderer thread samples every counter at a fixed
+ * refresh rate, computes throughput and ETA, and draws the bars through
+ * the incremental renderer, so only bars that changed reach the terminal.
+ * Bars are block copies of precomputed fill/blank cells; with
+ * PROGRESS_STYLE_BLOCKS the last cell shows eighths using Unicode partial
+ * blocks.
+ *
+ * With progress_set_inline(), only the overall bar is drawn, on the current
+ * terminal line, and redrawn in place; the rest of the terminal is left alone.
+ *
+ * When the output is not a terminal (a log file, a pipe), no bars are drawn.
+ * Instead one compact line (percentage, rate, ETA) is printed when the
+ * overall percentage or the number of finished tasks changes, at most once
+ * per PROGRESS_LOG_INTERVAL seconds. A total of 0 means "unknown".
+ *
+ * Usage:
+ *     progress_init(&tracker, task_count, 10, PROGRESS_STYLE_ASCII); // 10 redraws per second
+ *     progress_set_item(&tracker, i, "Task 1", total);
+ *     progress_start(&tracker);
+ *     ... workers call progress_add(&tracker, i, n) ...
+ *     progress_stop(&tracker);                        // final frame
+ */
+#ifndef PROGRESS_TRACKER_H
+#define PROGRESS_TRACKER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+    #include <io.h>     // For _isatty()
+    #include <malloc.h> // For _aligned_malloc(); MSVC has no aligned_alloc()
+    #define isatty _isatty
+#endif
+
+#include "../common/screen.h"
+/*================= Constant =================*/
+#define PROGRESS_LABEL_LENGTH 24
+#define PROGRESS_BAR_WIDTH 50     // Characters between '[' and ']'.
+#define PROGRESS_VISIBLE_ITEMS 20 // Bars shown; the rest are summed in the total line.
+#define PROGRESS_LINE_WIDTH (PROGRESS_LABEL_LENGTH + PROGRESS_BAR_WIDTH + 48)
+#define PROGRESS_RATE_SMOOTHING 0.3 // Weight of the newest sample in the throughput average.
+#define PROGRESS_LOG_INTERVAL 1.0   // Shortest gap between two log lines, in seconds.
+/*================= Type =================*/
+typedef enum
+{
+    PROGRESS_STYLE_ASCII = 0, // "=====     "
+    PROGRESS_STYLE_BLOCKS     // "█████▍    ", 1/8 character precision
+} ProgressStyle;
+// One tracked task. The counter sits alone in its cache line so workers on
+// different tasks do not slow each other down.
+typedef struct
+{
+    _Alignas(64) atomic_uint_fast64_t done; // Written by workers only.
+    uint64_t total;
+    char label[PROGRESS_LABEL_LENGTH];
+    // Renderer thread only:
+    uint64_t last_done;
+    double rate; // Smoothed units per second.
+} ProgressItem;
+typedef struct
+{
+    ProgressItem* items;
+    int count;
+    int refresh_hz;
+    ProgressStyle style;
+    uint32_t fill[PROGRESS_BAR_WIDTH];  // Precomputed filled cells.
+    uint32_t blank[PROGRESS_BAR_WIDTH]; // Precomputed empty cells.
+    uint32_t partial[8];                // Partial block glyphs, index = eighths filled.
+    Screen screen;
+    int log_mode;                       // Output is not a terminal: print lines, not bars.
+    int inline_mode;                    // One bar redrawn in place on the current line.
+    double last_log_time;
+    int last_log_percent;
+    int last_log_finished;
+    pthread_t thread;
+    atomic_int running;
+    double start_time;
+    double last_sample_time;
+} ProgressTracker;
+/*================= Function Definition =================*/
+/**
+ * @brief Returns a monotonic time in seconds.
+ */
+static inline double progress_now()
+{
+    struct timespec now;
+#ifdef _WIN32
+    timespec_get(&now, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+/**
+ * @brief Sleeps for a number of seconds.
+ */
+static inline void progress_sleep(double seconds)
+{
+#ifdef _WIN32
+    Sleep((DWORD)(seconds * 1000));
+#else
+    struct timespec duration = {.tv_sec = (time_t)seconds, .tv_nsec = (long)((seconds - (time_t)seconds) * 1e9)};
+    nanosleep(&duration, NULL);
+#endif
+}
+/**
+ * @brief Allocates the items of a tracker, each on its own cache line.
+ * @param count Number of items.
+ * @return The items, or NULL if memory allocation failed. Free with progress_free_items().
+ */
+static inline ProgressItem* progress_alloc_items(int count)
+{
+    size_t size = ((count * sizeof(ProgressItem) + 63) / 64) * 64; // aligned_alloc() needs a multiple of 64
+    if (size == 0)
+    {
+        size = 64;
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size, 64);
+#else
+    return aligned_alloc(64, size);
+#endif
+}
+static inline void progress_free_items(ProgressItem* items)
+{
+#ifdef _WIN32
+    _aligned_free(items);
+#else
+    free(items);
+#endif
+}
+/**
+ * @brief Allocates a tracker for a number of tasks.
+ * @param tracker The tracker to set up.
+ * @param count Number of tasks.
+ * @param refresh_hz Redraws per second.
+ * @param style ASCII bars or Unicode block bars.
+ * @return 1 on success, 0 if memory allocation failed.
+ */
+static inline int progress_init(ProgressTracker* tracker, int count, int refresh_hz, ProgressStyle style)
+{
+    static const char* partial_blocks[8] = {" ", "▏", "▎", "▍", "▌", "▋", "▊", "▉"};
+    tracker->count = count;
+    tracker->refresh_hz = (refresh_hz > 0) ? refresh_hz : 1;
+    tracker->style = style;
+    uint32_t fill_glyph = screen_glyph((style == PROGRESS_STYLE_BLOCKS) ? "█" : "=", NULL);
+    for (int i = 0; i < PROGRESS_BAR_WIDTH; i++)
+    {
+        tracker->fill[i] = fill_glyph;
+        tracker->blank[i] = SCREEN_BLANK;
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        tracker->partial[i] = screen_glyph(partial_blocks[i], NULL);
+    }
+    tracker->items = progress_alloc_items(count);
+    if (tracker->items == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        atomic_init(&tracker->items[i].done, 0);
+        tracker->items[i].total = 0;
+        snprintf(tracker->items[i].label, PROGRESS_LABEL_LENGTH, "Task %d", i + 1);
+        tracker->items[i].last_done = 0;
+        tracker->items[i].rate = 0;
+    }
+    atomic_init(&tracker->running, 0);
+    tracker->log_mode = !isatty(fileno(stdout));
+    tracker->inline_mode = 0;
+    tracker->last_log_time = -PROGRESS_LOG_INTERVAL;
+    tracker->last_log_percent = -1;
+    tracker->last_log_finished = -1;
+    int visible = (count < PROGRESS_VISIBLE_ITEMS) ? count : PROGRESS_VISIBLE_ITEMS;
+    if (!screen_init(&tracker->screen, visible + 3, PROGRESS_LINE_WIDTH))
+    {
+        progress_free_items(tracker->items);
+        return 0;
+    }
+    return 1;
+}
+/**
+ * @brief Sends the display to another stream, e.g. stderr when stdout carries data.
+ * Bars are drawn if the stream is a terminal, log lines otherwise.
+ * @param tracker The tracker.
+ * @param stream Output stream.
+ */
+static inline void progress_set_output(ProgressTracker* tracker, FILE* stream)
+{
+    tracker->screen.stream = stream;
+    tracker->log_mode = !isatty(fileno(stream));
+}
+/**
+ * @brief Draws a single overall bar on the current terminal line instead of a full
+ * screen. The terminal is not cleared, so output shown before the bar stays.
+ * @param tracker The tracker.
+ * @param enabled 1 for the single line, 0 for the full display.
+ */
+static inline void progress_set_inline(ProgressTracker* tracker, int enabled)
+{
+    tracker->inline_mode = enabled;
+}
+/**
+ * @brief Names a task and sets how many units of work it has.
+ * @param tracker The tracker.
+ * @param index Task index.
+ * @param label Text shown before the bar (NULL keeps "Task N").
+ * @param total Units of work; progress_add() calls should sum to this. 0 if unknown.
+ */
+static inline void progress_set_item(ProgressTracker* tracker, int index, const char* label, uint64_t total)
+{
+    ProgressItem* item = &tracker->items[index];
+    item->total = total;
+    if (label != NULL)
+    {
+        snprintf(item->label, PROGRESS_LABEL_LENGTH, "%s", label);
+    }
+}
+/**
+ * @brief Reports finished work. Lock-free; safe to call from any thread at any rate.
+ * @param tracker The tracker.
+ * @param index Task index.
+ * @param amount Units of work just finished.
+ */
+static inline void progress_add(ProgressTracker* tracker, int index, uint64_t amount)
+{
+    atomic_fetch_add_explicit(&tracker->items[index].done, amount, memory_order_relaxed);
+}
+/**
+ * @brief Formats seconds as "mm:ss" (or "h:mm:ss"), "--:--" when unknown.
+ */
+static inline void progress_format_eta(char* buffer, size_t size, double seconds)
+{
+    if (seconds < 0 || seconds > 359999)
+    {
+        snprintf(buffer, size, "--:--");
+        return;
+    }
+    int total = (int)(seconds + 0.5);
+    if (total >= 3600)
+        snprintf(buffer, size, "%d:%02d:%02d", total / 3600, total / 60 % 60, total % 60);
+    else
+        snprintf(buffer, size, "%02d:%02d", total / 60, total % 60);
+}
+/**
+ * @brief Composes one bar: label, filled part, percentage, throughput and ETA.
+ * The bar itself is at most three block copies: filled, partial cell, blank.
+ * @param tracker The tracker (screen, style and precomputed cells).
+ * @param label Text before the bar.
+ * @param done Finished units.
+ * @param total Total units, 0 if unknown.
+ * @param rate Units per second.
+ */
+static inline void progress_draw_bar(ProgressTracker* tracker, const char* label, uint64_t done, uint64_t total,
+                                     double rate)
+{
+    Screen* screen = &tracker->screen;
+    int label_width = tracker->inline_mode ? 0 : PROGRESS_LABEL_LENGTH - 1; // A lone bar needs no column.
+    if (total == 0)
+    {
+        // Unknown size: show the amount so far instead of a bar.
+        screen_printf(screen, "%-*s [", label_width, label);
+        screen_cells(screen, tracker->blank, PROGRESS_BAR_WIDTH);
+        screen_printf(screen, "] %llu %10.0f/s\n", (unsigned long long)done, rate);
+        return;
+    }
+    if (done > total)
+        done = total;
+    int percent = (int)(done * 100 / total);
+    char eta[16];
+    progress_format_eta(eta, sizeof(eta), (done == total) ? 0 : (rate > 0) ? (total - done) / rate : -1);
+
+    screen_printf(screen, "%-*s [", label_width, label);
+    if (tracker->style == PROGRESS_STYLE_BLOCKS)
+    {
+        int eighths = (int)((double)done * PROGRESS_BAR_WIDTH * 8 / total);
+        int full = eighths / 8;
+        screen_cells(screen, tracker->fill, full);
+        if (full < PROGRESS_BAR_WIDTH)
+        {
+            screen_cells(screen, &tracker->partial[eighths % 8], 1);
+            screen_cells(screen, tracker->blank, PROGRESS_BAR_WIDTH - full - 1);
+        }
+    }
+    else
+    {
+        int bar_to_show = (int)(done * PROGRESS_BAR_WIDTH / total);
+        screen_cells(screen, tracker->fill, bar_to_show);
+        screen_cells(screen, tracker->blank, PROGRESS_BAR_WIDTH - bar_to_show);
+    }
+    screen_printf(screen, "] %3d%% %10.0f/s  ETA %s\n", percent, rate, eta);
+}
+/**
+ * @brief Formats a count with a k/M/G suffix, e.g. "12.3M".
+ */
+static inline void progress_format_count(char* buffer, size_t size, double value)
+{
+    const char* suffixes = " kMGTP";
+    int i = 0;
+    while (value >= 1000 && i < 5)
+    {
+        value /= 1000;
+        i++;
+    }
+    if (i == 0)
+        snprintf(buffer, size, "%.0f", value);
+    else
+        snprintf(buffer, size, "%.1f%c", value, suffixes[i]);
+}
+/**
+ * @brief Log mode: prints one compact line if progress changed meaningfully.
+ * @param tracker The tracker.
+ * @param done Finished units over all tasks.
+ * @param total Total units over all tasks, 0 if unknown.
+ * @param rate Units per second over all tasks.
+ * @param finished Number of finished tasks.
+ * @param now Current time from progress_now().
+ * @param final Print even if nothing changed (last line).
+ */
+static inline void progress_log(ProgressTracker* tracker, uint64_t done, uint64_t total, double rate, int finished,
+                                double now, int final)
+{
+    int percent = total ? (int)((done < total ? done : total) * 100 / total) : -1;
+    int changed = (percent != tracker->last_log_percent) || (finished != tracker->last_log_finished) ||
+                  (total == 0 && rate > 0);
+    if (!final && (!changed || now - tracker->last_log_time < PROGRESS_LOG_INTERVAL))
+    {
+        return;
+    }
+    tracker->last_log_time = now;
+    tracker->last_log_percent = percent;
+    tracker->last_log_finished = finished;
+
+    char done_text[16], rate_text[16], eta[16];
+    progress_format_count(done_text, sizeof(done_text), (double)done);
+    progress_format_count(rate_text, sizeof(rate_text), rate);
+    if (total)
+    {
+        progress_format_eta(eta, sizeof(eta), (done >= total) ? 0 : (rate > 0) ? (total - done) / rate : -1);
+        fprintf(tracker->screen.stream, "[%7.1fs] %3d%% %s  %s/s  ETA %s", now - tracker->start_time, percent,
+                done_text, rate_text, eta);
+    }
+    else
+    {
+        fprintf(tracker->screen.stream, "[%7.1fs] %s  %s/s", now - tracker->start_time, done_text, rate_text);
+    }
+    if (tracker->count > 1)
+    {
+        fprintf(tracker->screen.stream, "  %d/%d tasks done", finished, tracker->count);
+    }
+    fprintf(tracker->screen.stream, "\n");
+    fflush(tracker->screen.stream);
+}
+/**
+ * @brief Samples all counters once and redraws (or logs). Called by the renderer thread.
+ * @param tracker The tracker.
+ * @param final 1 for the last frame, which is always shown.
+ */
+static inline void progress_render(ProgressTracker* tracker, int final)
+{
+    double now = progress_now();
+    double elapsed = now - tracker->last_sample_time;
+    tracker->last_sample_time = now;
+
+    uint64_t all_done = 0, all_total = 0;
+    double all_rate = 0;
+    int finished = 0;
+    int unknown_total = 0;
+    if (!tracker->log_mode)
+    {
+        screen_begin_frame(&tracker->screen);
+    }
+    for (int i = 0; i < tracker->count; i++)
+    {
+        ProgressItem* item = &tracker->items[i];
+        uint64_t done = atomic_load_explicit(&item->done, memory_order_relaxed);
+        if (elapsed > 0)
+        {
+            double sample = (done - item->last_done) / elapsed;
+            item->rate = (item->last_done == 0 && item->rate == 0)
+                             ? sample
+                             : item->rate + PROGRESS_RATE_SMOOTHING * (sample - item->rate);
+        }
+        item->last_done = done;
+        all_done += (item->total && done > item->total) ? item->total : done;
+        all_total += item->total;
+        all_rate += item->rate;
+        unknown_total |= (item->total == 0);
+        finished += (item->total && done >= item->total);
+        if (i < PROGRESS_VISIBLE_ITEMS && !tracker->log_mode && !tracker->inline_mode)
+        {
+            progress_draw_bar(tracker, item->label, done, item->total, item->rate);
+        }
+    }
+    if (unknown_total)
+    {
+        all_total = 0;
+    }
+    if (final)
+    {
+        all_rate = (now > tracker->start_time) ? all_done / (now - tracker->start_time) : 0; // Average.
+    }
+
+    if (tracker->log_mode)
+    {
+        progress_log(tracker, all_done, all_total, all_rate, finished, now, final);
+        return;
+    }
+    if (tracker->inline_mode)
+    {
+        progress_draw_bar(tracker, (tracker->count == 1) ? tracker->items[0].label : "All tasks", all_done, all_total,
+                          all_rate);
+        screen_present_line(&tracker->screen);
+        if (final)
+        {
+            fprintf(tracker->screen.stream, "\n");
+            fflush(tracker->screen.stream);
+        }
+        return;
+    }
+    if (tracker->count > PROGRESS_VISIBLE_ITEMS)
+    {
+        screen_printf(&tracker->screen, "... and %d more tasks\n", tracker->count - PROGRESS_VISIBLE_ITEMS);
+    }
+    progress_draw_bar(tracker, "All tasks", all_done, all_total, all_rate);
+    screen_printf(&tracker->screen, "%d/%d tasks done, %.1f s elapsed\n", finished, tracker->count,
+                  now - tracker->start_time);
+    screen_present(&tracker->screen);
+}
+/**
+ * @brief Renderer thread: redraws at the refresh rate until progress_stop().
+ * @param arg Pointer to the ProgressTracker.
+ * @return NULL.
+ */
+static inline void* progress_render_loop(void* arg)
+{
+    ProgressTracker* tracker = arg;
+    double period = 1.0 / tracker->refresh_hz;
+    double next_frame = progress_now();
+    while (atomic_load(&tracker->running))
+    {
+        progress_render(tracker, 0);
+        next_frame += period;
+        double wait = next_frame - progress_now();
+        if (wait > 0)
+        {
+            progress_sleep(wait);
+        }
+        else
+        {
+            next_frame = progress_now(); // Fell behind; do not try to catch up.
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief Starts the renderer thread.
+ * @param tracker The tracker.
+ * @return 1 on success, 0 if the thread could not be created.
+ */
+static inline int progress_start(ProgressTracker* tracker)
+{
+    tracker->start_time = tracker->last_sample_time = progress_now();
+    atomic_store(&tracker->running, 1);
+    if (pthread_create(&tracker->thread, NULL, progress_render_loop, tracker) != 0)
+    {
+        atomic_store(&tracker->running, 0);
+        return 0;
+    }
+    return 1;
+}
+/**
+ * @brief Stops the renderer thread, draws the final frame and frees the tracker.
+ * @param tracker The tracker.
+ */
+static inline void progress_stop(ProgressTracker* tracker)
+{
+    if (atomic_exchange(&tracker->running, 0))
+    {
+        pthread_join(tracker->thread, NULL);
+    }
+    progress_render(tracker, 1);
+    screen_free(&tracker->screen);
+    progress_free_items(tracker->items);
+    tracker->items = NULL;
+}
+
+#endif // PROGRESS_TRACKER_H
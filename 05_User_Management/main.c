@@ -3,45 +3,66 @@ __Project Name: User Management
 __Author: Shad Hossain Fardin
 __Date: 15th June 2025
 */
+#ifdef _WIN32
+    #define _CRT_RAND_S // For rand_s() in password_hash.h
+#endif
+#include <pthread.h> // For parallel CSV parsing
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-// Platform-specific headers for console I/O
-#ifdef _WIN32            // For Windows
-    #include <conio.h>   // For _getch()
-    #include <windows.h> // Console API for Windows
-    #define ENTER_KEY '\r'
-#else                    // For Linux/macOS
-    #include <termios.h> // For terminal control
-    #include <unistd.h>  // For read(), STDIN_FILENO
-    #define ENTER_KEY '\n'
+#ifdef _WIN32
+    #include <windows.h> // For GetSystemInfo()
+#else
+    #include <unistd.h> // For sysconf()
 #endif
+
+#include "../common/input.h" // line input and the masked password editor
+#include "password_hash.h"   // salted PBKDF2-HMAC-SHA256
 /*================= Constant =================*/
 #define CREDENTIAL_LENGTH 30
-#define MAX_USER 10
+#define MIN_TABLE_CAPACITY 16   // Must be a power of two
+#define MAX_IMPORT_THREADS 16   // Upper bound on CSV parser threads
+#define CSV_HEADER "username,salt,password_hash"
+#define CSV_MIN_ROW (1 + 1 + PASSWORD_SALT_HEX + PASSWORD_HASH_HEX) // "a,<salt>,<hash>\n"
 /*================= Type =================*/
 typedef struct
 {
     char username[CREDENTIAL_LENGTH];
-    char password[CREDENTIAL_LENGTH];
+    char salt[PASSWORD_SALT_HEX];          // Random per user, hex encoded
+    char password_hash[PASSWORD_HASH_HEX]; // PBKDF2 of password and salt, never the plain password
+    uint64_t key;                    // Cached hash of username
 } User;
+// One slice of the CSV buffer, parsed by its own thread.
+typedef struct
+{
+    char* begin;
+    char* end;
+    User* rows;      // Parsed rows of this slice
+    size_t row_count;
+    size_t invalid;  // Malformed lines skipped
+    int failed;      // Out of memory: no rows parsed
+} ImportChunk;
 /*================= Global =================*/
-User users[MAX_USER];
-int user_count = 0;
-// Global variables to store original terminal attributes for restoration
-#ifdef _WIN32
-static HANDLE h_console_input;
-static DWORD dw_original_mode;
-#else
-static struct termios old_termios_settings;
-#endif
+// Open addressing hash table keyed by username. An empty username marks a free slot.
+User* users = NULL;
+size_t user_capacity = 0;
+size_t user_count = 0;
 /*================= Function Prototype =================*/
 int menu_selection(void);
-void set_terminal_attributes();
-void reset_terminal_attributes();
-void input_masked_password(char*);
-void input_credential(char*, char*); // Input username and password
+int input_masked_password(char*);
+int input_credential(char*, char*); // Input username and password
+uint64_t hash_string(const char*);
+int reserve_users(size_t);
+User* find_user(const char*, uint64_t);
+int insert_user(const User*);
 void register_user();
 void login_user();
+void* parse_import_chunk(void*);
+int get_thread_count();
+void import_users();
+void export_users();
+void input_file_name(char*, int);
 /*================= Main =================*/
 int main()
 {
@@ -62,6 +83,13 @@ int main()
             login_user();
             break;
         case 3:
+            import_users();
+            break;
+        case 4:
+            export_users();
+            break;
+        case 5:
+            free(users);
             printf("\nExiting program.\n");
             return 0;
         default:
@@ -81,125 +109,189 @@ int menu_selection(void)
     int option;
     printf("01. Register\n");
     printf("02. Login\n");
-    printf("03. Exit\n");
-    printf("Select your option ( 1 - 3): ");
-    scanf("%d", &option);
-    getchar(); // Consume newline
-    return option;
+    printf("03. Import users (CSV)\n");
+    printf("04. Export users (CSV)\n");
+    printf("05. Exit\n");
+    printf("Select your option ( 1 - 5): ");
+    int status = input_int(input_stdin(), &option);
+    if (status < 0)
+    {
+        return 5; // No more input: exit
+    }
+    return (status == 1) ? option : 0;
 }
 /**
- * @brief Configures terminal for masked password input.
+ * @brief Reads a non-empty password, echoing '*' for each character.
+ * @param password Buffer of CREDENTIAL_LENGTH bytes to store the password.
+ * @return 1 on success, 0 at the end of input.
  */
-void set_terminal_attributes()
+int input_masked_password(char* password)
 {
-#ifdef _WIN32 // Windows-specific
-    h_console_input = GetStdHandle(STD_INPUT_HANDLE);
-    if (!GetConsoleMode(h_console_input, &dw_original_mode))
+    Input* input = input_stdin();
+    input_raw(input, 1); // No echo; the line editor prints the stars
+    input->mask = 1;
+
+    int status;
+    printf("Enter password: ");
+    while ((status = input_line(input, password, CREDENTIAL_LENGTH, 0, NULL, NULL)) && password[0] == '\0')
     {
-        perror("Failed to get console mode");
-        return;
+        printf("Password cannot be empty. Enter a password: ");
     }
-    DWORD new_mode = dw_original_mode & (~ENABLE_ECHO_INPUT);
-    new_mode |= ENABLE_PROCESSED_INPUT;
-    if (!SetConsoleMode(h_console_input, new_mode))
+
+    input->mask = 0;
+    input_raw(input, 0);
+    return status;
+}
+/**
+ * @brief Prompts for username and masked password.
+ * @param username Pointer to store username.
+ * @param password Pointer to store password.
+ * @return 1 on success, 0 at the end of input.
+ */
+int input_credential(char* username, char* password)
+{
+    printf("\nEnter username: ");
+    if (!input_line(input_stdin(), username, CREDENTIAL_LENGTH, 0, NULL, NULL))
     {
-        perror("Failed to set console mode");
-        return;
+        return 0;
     }
-#else // Linux/macOS-specific
-    tcgetattr(STDIN_FILENO, &old_termios_settings);
-    struct termios new_termios_settings = old_termios_settings;
-    new_termios_settings.c_lflag &= (~ECHO & ~ICANON); // Disable echo and canonical mode
-    tcsetattr(STDIN_FILENO, TCSANOW, &new_termios_settings);
-#endif
+    return input_masked_password(password);
 }
 /**
- * @brief Resets terminal attributes to original state.
+ * @brief Computes the 64-bit FNV-1a hash of a string.
+ * @param text Null terminated string to hash.
+ * @return The hash value.
  */
-void reset_terminal_attributes()
+uint64_t hash_string(const char* text)
 {
-#ifdef _WIN32 // Windows-specific
-    SetConsoleMode(h_console_input, dw_original_mode);
-#else // Linux/macOS-specific
-    tcsetattr(STDIN_FILENO, TCSANOW, &old_termios_settings);
-#endif
+    uint64_t hash = 14695981039346656037ULL;
+    while (*text)
+    {
+        hash ^= (unsigned char)*text++;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
 }
 /**
- * @brief Reads password input with masking ('*').
- * @param password Pointer to store the masked password.
+ * @brief Grows the user table so it can hold at least 'needed' users at half load.
+ * @param needed Number of users the table must hold.
+ * @return 1 on success, 0 if memory allocation failed.
  */
-void input_masked_password(char* password)
+int reserve_users(size_t needed)
 {
-    set_terminal_attributes(); // Enable masking
-
-    int i = 0;
-    char ch;
-    printf("Enter password: ");
-    fflush(stdout);
+    size_t capacity = user_capacity ? user_capacity : MIN_TABLE_CAPACITY;
+    while (capacity < needed * 2)
+    {
+        capacity *= 2;
+    }
+    if (capacity == user_capacity)
+    {
+        return 1;
+    }
 
-    while (i < CREDENTIAL_LENGTH - 1)
+    User* old_users = users;
+    size_t old_capacity = user_capacity;
+    users = calloc(capacity, sizeof(User));
+    if (users == NULL)
     {
-#ifdef _WIN32
-        ch = _getch();
-#else
-        ch = getchar();
-#endif
-        if (ch == ENTER_KEY)
-        {
-            if (i == 0)
-            {
-                printf("\nPassword cannot be empty. Enter a password: ");
-                fflush(stdout);
-                continue;
-            }
-            break;
-        }
-        else if (ch == '\b' || ch == 127) // Backspace or DEL
+        users = old_users;
+        return 0;
+    }
+    user_capacity = capacity;
+    // Re-insert existing users into the bigger table.
+    for (size_t i = 0; i < old_capacity; i++)
+    {
+        if (old_users[i].username[0] != '\0')
         {
-            if (i > 0)
+            size_t slot = old_users[i].key & (user_capacity - 1);
+            while (users[slot].username[0] != '\0')
             {
-                i--;
-                printf("\b \b"); // Erase character from console
-                fflush(stdout);
+                slot = (slot + 1) & (user_capacity - 1);
             }
+            users[slot] = old_users[i];
         }
-        else
+    }
+    free(old_users);
+    return 1;
+}
+/**
+ * @brief Looks up a user by name.
+ * @param username Username to search for.
+ * @param key Precomputed hash_string(username).
+ * @return Pointer to the user, or NULL if not registered.
+ */
+User* find_user(const char* username, uint64_t key)
+{
+    if (user_capacity == 0)
+    {
+        return NULL;
+    }
+    size_t slot = key & (user_capacity - 1);
+    while (users[slot].username[0] != '\0')
+    {
+        if (users[slot].key == key && strcmp(users[slot].username, username) == 0)
         {
-            password[i++] = ch;
-            printf("*");
-            fflush(stdout);
+            return &users[slot];
         }
+        slot = (slot + 1) & (user_capacity - 1);
     }
-    password[i] = '\0';
-
-    reset_terminal_attributes(); // Disable masking
-    printf("\n");
+    return NULL;
 }
 /**
- * @brief Prompts for username and masked password.
- * @param username Pointer to store username.
- * @param password Pointer to store password.
+ * @brief Adds a user to the table. The caller must have reserved space.
+ * @param user User with username, password hash and key filled in.
+ * @return 1 if inserted, 0 if the username already exists.
  */
-void input_credential(char* username, char* password)
+int insert_user(const User* user)
 {
-    printf("\nEnter username: ");
-    fgets(username, CREDENTIAL_LENGTH, stdin);
-    username[strcspn(username, "\n")] = 0; // Remove newline
-    input_masked_password(password);
+    size_t slot = user->key & (user_capacity - 1);
+    while (users[slot].username[0] != '\0')
+    {
+        if (users[slot].key == user->key && strcmp(users[slot].username, user->username) == 0)
+        {
+            return 0; // Duplicate username.
+        }
+        slot = (slot + 1) & (user_capacity - 1);
+    }
+    users[slot] = *user;
+    user_count++;
+    return 1;
 }
 /**
  * @brief Registers a new user.
  */
 void register_user()
 {
-    if (user_count == MAX_USER)
+    User user;
+    char password[CREDENTIAL_LENGTH];
+    if (!input_credential(user.username, password))
     {
-        printf("Maximum %d users supported. No more registration allowed!!\n", MAX_USER);
         return;
     }
 
-    input_credential(users[user_count].username, users[user_count].password);
-    user_count++;
+    if (user.username[0] == '\0' || strchr(user.username, ',') != NULL)
+    {
+        printf("Username must be non-empty and must not contain ','.\n\n");
+        return;
+    }
+    user.key = hash_string(user.username);
+    if (find_user(user.username, user.key) != NULL)
+    {
+        printf("Username '%s' is already taken!!\n\n", user.username);
+        return;
+    }
+    if (!reserve_users(user_count + 1))
+    {
+        printf("Out of memory. Registration failed!!\n\n");
+        return;
+    }
+    if (!password_new_salt(user.salt))
+    {
+        printf("No secure random source. Registration failed!!\n\n");
+        return;
+    }
+    password_hash(password, user.salt, user.password_hash);
+    insert_user(&user);
 
     printf("Registration successful!\n\n");
 }
@@ -210,15 +302,249 @@ void login_user()
 {
     char username[CREDENTIAL_LENGTH];
     char password[CREDENTIAL_LENGTH];
-    input_credential(username, password);
+    if (!input_credential(username, password))
+    {
+        return;
+    }
+
+    User* user = find_user(username, hash_string(username));
+    // Hash even for an unknown user, so the reply time does not tell which usernames exist.
+    User unknown = {0};
+    memset(unknown.salt, '0', PASSWORD_SALT_HEX - 1);
+    memset(unknown.password_hash, '0', PASSWORD_HASH_HEX - 1);
+    const User* checked = (user != NULL) ? user : &unknown;
+    if (password_verify(password, checked->salt, checked->password_hash) && user != NULL)
+    {
+        printf("\nLogin successful. Welcome %s!\n\n", user->username);
+        return;
+    }
+    printf("Invalid username or password!!! Please try again.\n\n");
+}
+/**
+ * @brief Prompts for a file name.
+ * @param file_name Buffer to store the name.
+ * @param size Size of the buffer.
+ */
+void input_file_name(char* file_name, int size)
+{
+    printf("\nEnter CSV file name: ");
+    input_line(input_stdin(), file_name, size, 0, NULL, NULL); // Empty at the end of input
+}
+/**
+ * @brief Returns how many threads to use for parsing.
+ */
+int get_thread_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long cores = info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cores < 1)
+    {
+        return 1;
+    }
+    return cores > MAX_IMPORT_THREADS ? MAX_IMPORT_THREADS : (int)cores;
+}
+/**
+ * @brief Thread routine: parses "username,salt,password_hash" lines of one chunk.
+ * Usernames are hashed here so the table build only has to place rows.
+ * @param arg Pointer to the ImportChunk to parse.
+ * @return NULL.
+ */
+void* parse_import_chunk(void* arg)
+{
+    ImportChunk* chunk = arg;
+    // Every row needs at least CSV_MIN_ROW bytes, so this bounds the row count.
+    chunk->rows = malloc(((chunk->end - chunk->begin) / CSV_MIN_ROW + 1) * sizeof(User));
+    if (chunk->rows == NULL)
+    {
+        chunk->failed = 1;
+        return NULL;
+    }
 
-    for (int i = 0; i < user_count; i++)
+    char* line = chunk->begin;
+    while (line < chunk->end)
     {
-        if (strcmp(username, users[i].username) == 0 && strcmp(password, users[i].password) == 0)
+        char* line_end = memchr(line, '\n', chunk->end - line);
+        if (line_end == NULL)
+        {
+            line_end = chunk->end;
+        }
+        size_t length = line_end - line;
+        if (length > 0 && line[length - 1] == '\r')
+        {
+            length--;
+        }
+
+        // "username,salt,hash": the salt and hash have fixed lengths, so the
+        // username is everything before them.
+        const size_t tail = 1 + (PASSWORD_SALT_HEX - 1) + 1 + (PASSWORD_HASH_HEX - 1);
+        if (length == 0 || (length == strlen(CSV_HEADER) && memcmp(line, CSV_HEADER, length) == 0))
         {
-            printf("\nLogin successful. Welcome %s!\n\n", users[i].username);
-            return;
+            // Blank line or header row.
         }
+        else if (length <= tail || length - tail >= CREDENTIAL_LENGTH || line[length - tail] != ',' ||
+                 line[length - PASSWORD_HASH_HEX] != ',' || memchr(line, ',', length - tail) != NULL)
+        {
+            chunk->invalid++;
+        }
+        else
+        {
+            User* row = &chunk->rows[chunk->row_count];
+            size_t name_length = length - tail;
+            memcpy(row->username, line, name_length);
+            row->username[name_length] = '\0';
+            memcpy(row->salt, line + name_length + 1, PASSWORD_SALT_HEX - 1);
+            row->salt[PASSWORD_SALT_HEX - 1] = '\0';
+            memcpy(row->password_hash, line + length - (PASSWORD_HASH_HEX - 1), PASSWORD_HASH_HEX - 1);
+            row->password_hash[PASSWORD_HASH_HEX - 1] = '\0';
+            if (!password_is_hex(row->salt, PASSWORD_SALT_HEX - 1) ||
+                !password_is_hex(row->password_hash, PASSWORD_HASH_HEX - 1))
+            {
+                chunk->invalid++;
+            }
+            else
+            {
+                row->key = hash_string(row->username);
+                chunk->row_count++;
+            }
+        }
+        line = line_end + 1;
     }
-    printf("Invalid username or password!!! Please try again.\n\n");
+    return NULL;
+}
+/**
+ * @brief Imports users from a CSV file of "username,salt,password_hash" rows.
+ * The file is split at line boundaries and parsed in parallel, then the table
+ * is sized once and filled in a single pass. Existing usernames are kept.
+ */
+void import_users()
+{
+    char file_name[256];
+    input_file_name(file_name, sizeof(file_name));
+
+    FILE* file = fopen(file_name, "rb");
+    if (file == NULL)
+    {
+        perror("Failed to open file");
+        printf("\n");
+        return;
+    }
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        size = ftell(file);
+    }
+    char* buffer = (size >= 0 && fseek(file, 0, SEEK_SET) == 0) ? malloc(size + 1) : NULL;
+    if (buffer == NULL || fread(buffer, 1, size, file) != (size_t)size)
+    {
+        printf("Failed to read '%s'.\n\n", file_name);
+        free(buffer);
+        fclose(file);
+        return;
+    }
+    fclose(file);
+
+    // Split the buffer into one chunk per thread, each ending on a newline.
+    int thread_count = get_thread_count();
+    ImportChunk chunks[MAX_IMPORT_THREADS] = {0};
+    pthread_t threads[MAX_IMPORT_THREADS];
+    char* cursor = buffer;
+    char* buffer_end = buffer + size;
+    for (int t = 0; t < thread_count; t++)
+    {
+        char* chunk_end = (t == thread_count - 1) ? buffer_end : buffer + size / thread_count * (t + 1);
+        if (chunk_end <= cursor)
+        {
+            chunk_end = cursor;
+        }
+        while (chunk_end > cursor && chunk_end < buffer_end && chunk_end[-1] != '\n')
+        {
+            chunk_end++;
+        }
+        chunks[t].begin = cursor;
+        chunks[t].end = chunk_end;
+        cursor = chunk_end;
+    }
+    for (int t = 0; t < thread_count; t++)
+    {
+        if (pthread_create(&threads[t], NULL, parse_import_chunk, &chunks[t]) != 0)
+        {
+            parse_import_chunk(&chunks[t]); // Fall back to parsing on this thread.
+            threads[t] = pthread_self();
+        }
+    }
+
+    size_t parsed = 0, invalid = 0, duplicates = 0, imported = 0;
+    int failed = 0;
+    for (int t = 0; t < thread_count; t++)
+    {
+        if (!pthread_equal(threads[t], pthread_self()))
+        {
+            pthread_join(threads[t], NULL);
+        }
+        parsed += chunks[t].row_count;
+        invalid += chunks[t].invalid;
+        failed |= chunks[t].failed;
+    }
+
+    // A chunk that ran out of memory would silently lose its rows: import nothing.
+    if (!failed && reserve_users(user_count + parsed))
+    {
+        for (int t = 0; t < thread_count; t++)
+        {
+            for (size_t i = 0; i < chunks[t].row_count; i++)
+            {
+                insert_user(&chunks[t].rows[i]) ? imported++ : duplicates++;
+            }
+        }
+        printf("Imported %zu users (%zu duplicate, %zu invalid rows) using %d threads.\n\n", imported, duplicates,
+               invalid, thread_count);
+    }
+    else
+    {
+        printf("Out of memory. Import failed!!\n\n");
+    }
+
+    for (int t = 0; t < thread_count; t++)
+    {
+        free(chunks[t].rows);
+    }
+    free(buffer);
+}
+/**
+ * @brief Exports all users to a CSV file of "username,salt,password_hash" rows.
+ */
+void export_users()
+{
+    char file_name[256];
+    input_file_name(file_name, sizeof(file_name));
+
+    FILE* file = fopen(file_name, "wb");
+    if (file == NULL)
+    {
+        perror("Failed to open file");
+        printf("\n");
+        return;
+    }
+    static char write_buffer[1 << 16];
+    setvbuf(file, write_buffer, _IOFBF, sizeof(write_buffer));
+
+    fprintf(file, "%s\n", CSV_HEADER);
+    for (size_t i = 0; i < user_capacity; i++)
+    {
+        if (users[i].username[0] != '\0')
+        {
+            fprintf(file, "%s,%s,%s\n", users[i].username, users[i].salt, users[i].password_hash);
+        }
+    }
+    if (fclose(file) != 0)
+    {
+        printf("Failed to write '%s'.\n\n", file_name);
+        return;
+    }
+    printf("Exported %zu users to '%s'.\n\n", user_count, file_name);
 }
@@ -0,0 +1,299 @@
+/*
+ * Module Name: Password Hash (PBKDF2-HMAC-SHA256)
+ * Date: 19th October 2026
+ *
+ * Passwords are stored as PBKDF2-HMAC-SHA256 of the password and a random
+ * 16-byte salt, with PASSWORD_ITERATIONS rounds.
+ * - The salt differs per user, so a precomputed table is useless and equal
+ *   passwords do not give equal hashes.
+ * - The rounds make every guess cost as much as a login, about 0.1 s, so
+ *   brute force over a leaked file is slow.
+ * Salt and hash are kept as lowercase hex. Hashes are compared in constant
+ * time.
+ *
+ * Usage:
+ *     char salt[PASSWORD_SALT_HEX], hash[PASSWORD_HASH_HEX];
+ *     if (password_new_salt(salt))
+ *         password_hash(password, salt, hash);
+ *     int ok = password_verify(password, salt, hash);
+ */
+#ifndef PASSWORD_HASH_H
+#define PASSWORD_HASH_H
+
+// On Windows, define _CRT_RAND_S before the first #include <stdlib.h> for rand_s().
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*================= Constant =================*/
+#define PASSWORD_ITERATIONS 100000
+#define PASSWORD_SALT_BYTES 16
+#define PASSWORD_HASH_BYTES 32                          // One SHA-256 block of output
+#define PASSWORD_SALT_HEX (2 * PASSWORD_SALT_BYTES + 1) // Hex digits + '\0'
+#define PASSWORD_HASH_HEX (2 * PASSWORD_HASH_BYTES + 1)
+/*================= Type =================*/
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t length; // Bytes hashed so far
+    unsigned char block[64];
+    size_t used; // Bytes waiting in block
+} Sha256;
+/*================= Lookup Table =================*/
+static const uint32_t sha256_round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+/*================= Function Definition =================*/
+static inline uint32_t sha256_rotate(uint32_t x, int k)
+{
+    return (x >> k) | (x << (32 - k));
+}
+static inline void sha256_init(Sha256* sha)
+{
+    static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(sha->state, initial, sizeof(initial));
+    sha->length = 0;
+    sha->used = 0;
+}
+/**
+ * @brief Mixes one 64-byte block into the state.
+ */
+static inline void sha256_compress(uint32_t state[8], const unsigned char block[64])
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 | (uint32_t)block[4 * i + 2] << 8 |
+               block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = sha256_rotate(w[i - 15], 7) ^ sha256_rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = sha256_rotate(w[i - 2], 17) ^ sha256_rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (sha256_rotate(e, 6) ^ sha256_rotate(e, 11) ^ sha256_rotate(e, 25)) + ((e & f) ^ (~e & g)) +
+                      sha256_round_constants[i] + w[i];
+        uint32_t t2 = (sha256_rotate(a, 2) ^ sha256_rotate(a, 13) ^ sha256_rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+static inline void sha256_update(Sha256* sha, const void* data, size_t size)
+{
+    const unsigned char* bytes = data;
+    sha->length += size;
+    while (size > 0)
+    {
+        size_t take = 64 - sha->used;
+        if (take > size)
+        {
+            take = size;
+        }
+        memcpy(sha->block + sha->used, bytes, take);
+        sha->used += take;
+        bytes += take;
+        size -= take;
+        if (sha->used == 64)
+        {
+            sha256_compress(sha->state, sha->block);
+            sha->used = 0;
+        }
+    }
+}
+static inline void sha256_final(Sha256* sha, unsigned char digest[32])
+{
+    uint64_t bits = sha->length * 8;
+    unsigned char pad = 0x80;
+    sha256_update(sha, &pad, 1);
+    pad = 0;
+    while (sha->used != 56)
+    {
+        sha256_update(sha, &pad, 1);
+    }
+    unsigned char length[8];
+    for (int i = 0; i < 8; i++)
+    {
+        length[i] = (unsigned char)(bits >> (56 - 8 * i));
+    }
+    sha256_update(sha, length, 8);
+    for (int i = 0; i < 32; i++)
+    {
+        digest[i] = (unsigned char)(sha->state[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+/**
+ * @brief Prepares the inner and outer HMAC states of a key. They are reused
+ * for every round, so one round costs two compressions.
+ */
+static inline void hmac_sha256_keys(const void* key, size_t size, Sha256* inner, Sha256* outer)
+{
+    unsigned char block[64] = {0};
+    if (size > 64)
+    {
+        Sha256 sha;
+        sha256_init(&sha);
+        sha256_update(&sha, key, size);
+        sha256_final(&sha, block);
+    }
+    else
+    {
+        memcpy(block, key, size);
+    }
+    unsigned char pad[64];
+    for (int i = 0; i < 64; i++)
+    {
+        pad[i] = block[i] ^ 0x36;
+    }
+    sha256_init(inner);
+    sha256_update(inner, pad, 64);
+    for (int i = 0; i < 64; i++)
+    {
+        pad[i] = block[i] ^ 0x5c;
+    }
+    sha256_init(outer);
+    sha256_update(outer, pad, 64);
+}
+static inline void hmac_sha256(const Sha256* inner, const Sha256* outer, const void* data, size_t size,
+                               unsigned char mac[32])
+{
+    Sha256 sha = *inner;
+    sha256_update(&sha, data, size);
+    sha256_final(&sha, mac);
+    sha = *outer;
+    sha256_update(&sha, mac, 32);
+    sha256_final(&sha, mac);
+}
+/**
+ * @brief PBKDF2-HMAC-SHA256 with one 32-byte output block.
+ */
+static inline void pbkdf2_sha256(const char* password, const unsigned char* salt, size_t salt_size, long iterations,
+                                 unsigned char out[PASSWORD_HASH_BYTES])
+{
+    Sha256 inner, outer;
+    hmac_sha256_keys(password, strlen(password), &inner, &outer);
+    unsigned char first[PASSWORD_SALT_BYTES + 4];
+    memcpy(first, salt, salt_size);
+    memcpy(first + salt_size, "\0\0\0\1", 4); // Block index 1
+    unsigned char u[32];
+    hmac_sha256(&inner, &outer, first, salt_size + 4, u);
+    memcpy(out, u, 32);
+    for (long i = 1; i < iterations; i++)
+    {
+        hmac_sha256(&inner, &outer, u, 32, u);
+        for (int k = 0; k < 32; k++)
+        {
+            out[k] ^= u[k];
+        }
+    }
+}
+static inline void password_to_hex(const unsigned char* bytes, size_t size, char* hex)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        snprintf(hex + 2 * i, 3, "%02x", bytes[i]);
+    }
+}
+/**
+ * @brief Checks that text is exactly `digits` lowercase hex digits.
+ */
+static inline int password_is_hex(const char* text, size_t digits)
+{
+    return strlen(text) == digits && strspn(text, "0123456789abcdef") == digits;
+}
+/**
+ * @brief Draws a fresh salt from the system's secure generator.
+ * @param salt_hex Buffer of PASSWORD_SALT_HEX bytes receiving the hex salt.
+ * @return 1 on success, 0 if no secure random bytes are available.
+ */
+static inline int password_new_salt(char* salt_hex)
+{
+    unsigned char salt[PASSWORD_SALT_BYTES];
+#ifdef _WIN32
+    for (int i = 0; i < PASSWORD_SALT_BYTES; i++)
+    {
+        unsigned int value;
+        if (rand_s(&value) != 0)
+        {
+            return 0;
+        }
+        salt[i] = (unsigned char)value;
+    }
+#else
+    FILE* source = fopen("/dev/urandom", "rb");
+    if (source == NULL)
+    {
+        return 0;
+    }
+    size_t read = fread(salt, 1, sizeof(salt), source);
+    fclose(source);
+    if (read != sizeof(salt))
+    {
+        return 0;
+    }
+#endif
+    password_to_hex(salt, sizeof(salt), salt_hex);
+    return 1;
+}
+/**
+ * @brief Hashes a password with a salt into its stored hex form.
+ * @param password Plain password.
+ * @param salt_hex Salt as PASSWORD_SALT_HEX - 1 hex digits.
+ * @param hash_hex Buffer of PASSWORD_HASH_HEX bytes receiving the hash.
+ */
+static inline void password_hash(const char* password, const char* salt_hex, char* hash_hex)
+{
+    unsigned char salt[PASSWORD_SALT_BYTES];
+    for (int i = 0; i < PASSWORD_SALT_BYTES; i++)
+    {
+        unsigned value;
+        sscanf(salt_hex + 2 * i, "%2x", &value);
+        salt[i] = (unsigned char)value;
+    }
+    unsigned char hash[PASSWORD_HASH_BYTES];
+    pbkdf2_sha256(password, salt, sizeof(salt), PASSWORD_ITERATIONS, hash);
+    password_to_hex(hash, sizeof(hash), hash_hex);
+}
+/**
+ * @brief Checks a password against a stored salt and hash.
+ * @return 1 if the password matches.
+ */
+static inline int password_verify(const char* password, const char* salt_hex, const char* hash_hex)
+{
+    char computed[PASSWORD_HASH_HEX];
+    password_hash(password, salt_hex, computed);
+    unsigned char difference = 0;
+    for (int i = 0; i < PASSWORD_HASH_HEX - 1; i++)
+    {
+        difference |= (unsigned char)(computed[i] ^ hash_hex[i]); // No early exit: time does not leak the prefix
+    }
+    return difference == 0;
+}
+
+#endif // PASSWORD_HASH_H
@@ -3,8 +3,11 @@
  * Author: Shad Hossain Fardin
  * Date: 16th June 2025
  */
+#include <float.h>
 #include <stdio.h>
 #include <string.h>
+
+#include "../common/input.h" // Line input and typed parsers.
 /*================= Constant =================*/
 #define ACCOUNT_FILE "account.dat" // Defines the filename
 /*================= Type =================*/
@@ -15,7 +18,8 @@ typedef struct
     float balance;   // Current account balance.
 } Account;
 /*================= Function Prototypes =================*/
-void flush_input();    // Clears the input buffer.
+int input_account_number(int* account_num); // Reads an account number; 0 at the end of input.
+int input_amount(const char* prompt, float* amount); // Reads an amount of money; 0 at the end of input.
 int menu_selection();  // Displays menu and gets user's choice.
 void create_account(); // Creates a new bank account.
 void deposit_money();  // Deposits money into an account.
@@ -58,13 +62,42 @@ int main()
 }
 /*================= Function Definitions =================*/
 /**
- * @brief Clears the standard input buffer.
+ * @brief Prompts for an account number until a whole number is entered.
+ * @param account_num Stores the number.
+ * @return 1 on success, 0 at the end of input.
+ */
+int input_account_number(int* account_num)
+{
+    int status;
+    printf("Enter your account number: ");
+    while ((status = input_int(input_stdin(), account_num)) == 0)
+    {
+        printf("Invalid account number. Enter your account number: ");
+    }
+    return status > 0;
+}
+/**
+ * @brief Prompts for an amount until a positive number is entered.
+ * @param prompt Text shown before the input.
+ * @param amount Stores the amount.
+ * @return 1 on success, 0 at the end of input.
  */
-void flush_input()
+int input_amount(const char* prompt, float* amount)
 {
-    int ch;
-    while ((ch = getchar()) != '\n' && ch != EOF)
-        ;
+    double value;
+    int status;
+    printf("%s", prompt);
+    // The status comes first: value is only set when a number was read
+    while ((status = input_double(input_stdin(), &value)) <= 0 || value <= 0 || value > FLT_MAX)
+    {
+        if (status < 0)
+        {
+            return 0;
+        }
+        printf("Invalid amount. Enter a positive number: ");
+    }
+    *amount = (float)value;
+    return 1;
 }
 /**
  * @brief Displays the main menu and prompts the user for a selection.
@@ -79,10 +112,12 @@ int menu_selection(void)
     printf("04. Check Balance\n");
     printf("05. Exit\n");
     printf("Select your option (1 - 5): ");
-    scanf("%d", &option);
-    flush_input(); // Clear input buffer
-
-    return option;
+    int status = input_int(input_stdin(), &option);
+    if (status < 0)
+    {
+        return 5; // No more input: close the bank.
+    }
+    return (status == 1) ? option : 0;
 }
 /**
  * @brief Creates a new bank account and saves it to the account data file.
@@ -98,12 +133,12 @@ void create_account()
 
     Account account;
     printf("Enter your name: ");
-    fgets(account.name, sizeof(account.name), stdin);
-    account.name[strcspn(account.name, "\n")] = '\0'; // Removes newline
-
-    printf("Enter your account number: ");
-    scanf("%d", &account.account_num);
-    flush_input(); // Clear input buffer
+    if (!input_line(input_stdin(), account.name, sizeof(account.name), 0, NULL, NULL) ||
+        !input_account_number(&account.account_num))
+    {
+        fclose(file_p);
+        return;
+    }
     account.balance = 0;
 
     fwrite(&account, sizeof(Account), 1, file_p); // Write account structure to file.
@@ -126,11 +161,11 @@ void deposit_money()
     int account_num;
     float deposit_amount;
 
-    printf("Enter your account number: ");
-    scanf("%d", &account_num);
-    printf("Enter the amount to deposit: ");
-    scanf("%f", &deposit_amount);
-    flush_input(); // Clear input buffer.
+    if (!input_account_number(&account_num) || !input_amount("Enter the amount to deposit: ", &deposit_amount))
+    {
+        fclose(file_p);
+        return;
+    }
 
     // Reads until end-of-file (EOF).
     while (fread(&account, sizeof(Account), 1, file_p) == 1) // fread() returns number of items read.
@@ -164,11 +199,11 @@ void withdraw_money()
     int account_num;
     float withdraw_amount;
 
-    printf("Enter your account number: ");
-    scanf("%d", &account_num);
-    printf("Enter the amount to withdraw: ");
-    scanf("%f", &withdraw_amount);
-    flush_input(); // Clear input buffer.
+    if (!input_account_number(&account_num) || !input_amount("Enter the amount to withdraw: ", &withdraw_amount))
+    {
+        fclose(file_p);
+        return;
+    }
 
     // Reads until end-of-file (EOF).
     while (fread(&account, sizeof(Account), 1, file_p) == 1)
@@ -208,9 +243,11 @@ void check_balance()
     Account account;
     int account_num;
 
-    printf("Enter your account number: ");
-    scanf("%d", &account_num);
-    flush_input(); // Clear input buffer.
+    if (!input_account_number(&account_num))
+    {
+        fclose(file_p);
+        return;
+    }
 
     // Reads until end-of-file (EOF).
     while (fread(&account, sizeof(Account), 1, file_p) == 1)
@@ -3,14 +3,65 @@
  * Author: Shad Hossain Fardin
  * Date: 17th June 2025
  */
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L // For clock_gettime()
+#endif
+#include <math.h>    // For sqrt(), log() in MCTS
+#include <pthread.h> // For the self-play simulator and MCTS threads
+#include <stdarg.h>  // For print_under_board()
+#include <stdint.h>  // For uint16_t
 #include <stdio.h>
-#include <stdlib.h> // For system(), srand(), rand()
-#include <time.h>   // For time()
+#include <stdlib.h> // For strtoull()
+#include <string.h> // For memset()
+#include <time.h>   // For clock_gettime(), timespec_get()
+#ifdef _WIN32
+    #include <windows.h> // For GetSystemInfo()
+#else
+    #include <unistd.h> // For sysconf()
+#endif
+
+#include "../common/input.h"  // Line editor with a live turn timer
+#include "../common/random.h" // Per-thread xoshiro256** generator
+#include "../common/screen.h" // Incremental terminal renderer
 /*================= Constant =================*/
-#define BOARD_SIZE 3   // Standard 3x3 Tic-Tac-Toe board.
-#define PLAYER1 'X'    // For Player 1.
-#define PLAYER2 'O'    // For Player 2 (or Computer).
-#define EMPTY_CELL ' ' // Representing an empty cell
+#define BOARD_SIZE 3                         // Standard 3x3 Tic-Tac-Toe board.
+#define CELL_COUNT (BOARD_SIZE * BOARD_SIZE) // Number of cells (bits) on the board.
+#define FULL_BOARD 0x1FF                     // All 9 cell bits set.
+#define WIN_LINE_COUNT 8                     // 3 rows, 3 columns, 2 diagonals.
+#define PLAYER1 'X'                          // For Player 1.
+#define PLAYER2 'O'                          // For Player 2 (or Computer).
+#define EMPTY_CELL ' '                       // Representing an empty cell
+#define CELL_BIT(row, col) (1u << ((row) * BOARD_SIZE + (col))) // Bit of cell (row, col).
+#define SYMMETRY_COUNT 8                     // 4 rotations x (plain, mirrored).
+#define TT_SIZE (1 << (2 * CELL_COUNT + 1))  // Both masks plus the side to move.
+#define SCORE_INFINITY 100                   // Larger than any reachable score.
+// m,n,k (Gomoku-style) mode
+#define MNK_MIN_SIZE 3                       // Smallest board side and win length.
+#define MNK_MAX_SIZE 19                      // Largest board side (Go board).
+#define MNK_MAX_CELLS (MNK_MAX_SIZE * MNK_MAX_SIZE)
+#define MNK_MAX_WIN 8                        // Longest win length (keeps window scores in range).
+#define MNK_NEIGHBOUR_RADIUS 2               // Only cells this close to a mark are searched.
+#define MNK_MAX_BRANCH 20                    // Best-ordered moves searched per node.
+#define MNK_MAX_DEPTH 64                     // Deepest iterative-deepening iteration.
+#define MNK_TT_SIZE (1 << 20)                // Transposition table entries (power of two).
+#define MNK_WIN_SCORE 1000000000             // Score of a won position, minus plies to reach it.
+#define MNK_INFINITY 2000000000              // Larger than any reachable score.
+// Terminal frame size (fits the largest m,n,k board)
+#define SCREEN_ROWS (MNK_MAX_SIZE + 8)
+#define SCREEN_COLS 100
+// Self-play simulator
+#define MAX_SIMULATION_THREADS 64
+// Monte Carlo Tree Search
+#define MAX_MCTS_THREADS 8                   // Root-parallel search trees.
+#define MCTS_POOL_SIZE (1 << 16)             // Preallocated nodes per tree.
+#define MCTS_DEFAULT_ROLLOUTS 20000          // Rollouts per move when no time budget is set.
+#define MCTS_SIMULATION_ROLLOUTS 1000        // Rollouts per move for the headless simulator.
+#define MCTS_EXPLORATION 1.41421356          // UCT exploration constant (sqrt 2).
+#define MNK_MCTS_EXPAND_VISITS 8             // Visits before an m,n,k leaf lists its moves.
+#define MNK_MCTS_PLAYOUT_PLIES 32            // Random m,n,k moves before the evaluation decides.
+// Human turns
+#define TURN_TIMER_INTERVAL_MS 200           // How often the turn timer in the prompt is checked.
+#define PROMPT_LENGTH 128
 /*================= Type =================*/
 typedef struct
 {
@@ -18,9 +69,180 @@ typedef struct
     int player2;
     int draw;
 } Score;
+// Bitboard: bit (row * 3 + col) is set when that cell belongs to the player.
+typedef struct
+{
+    uint16_t player1; // Cells taken by 'X'.
+    uint16_t player2; // Cells taken by 'O'.
+} Board;
+// Transposition table bound types.
+typedef enum
+{
+    TT_EMPTY = 0,
+    TT_EXACT,
+    TT_LOWER, // Real value is >= stored value.
+    TT_UPPER  // Real value is <= stored value.
+} TTFlag;
+typedef struct
+{
+    int8_t value; // Score from the side to move's point of view.
+    uint8_t flag; // One of TTFlag.
+} TTEntry;
+// Settings of the m,n,k (Gomoku-style) mode.
+typedef struct
+{
+    int rows;
+    int cols;
+    int win_length;     // Marks in a row needed to win (k).
+    int time_budget_ms; // Computer thinking time per move.
+    int threads;        // MCTS search threads, 0 for the alpha-beta search.
+} MnkSettings;
+// Board of the m,n,k mode. Cell index is row * cols + col.
+typedef struct
+{
+    int rows;
+    int cols;
+    int win_length;
+    int move_count;
+    int evaluation;                    // Window score from X's point of view, kept up to date per move.
+    uint64_t hash;                     // Zobrist hash of all marks.
+    char cells[MNK_MAX_CELLS];         // PLAYER1, PLAYER2 or EMPTY_CELL.
+    uint8_t neighbours[MNK_MAX_CELLS]; // Marks within MNK_NEIGHBOUR_RADIUS of each cell.
+} MnkBoard;
+typedef struct
+{
+    uint64_t key;      // Full Zobrist key, to detect index collisions.
+    int32_t value;     // Score for the side to move.
+    int16_t best_move; // Cell to try first next time.
+    int8_t depth;      // Remaining depth the value was searched to.
+    uint8_t flag;      // One of TTFlag.
+} MnkTTEntry;
+// One node of a 3x3 Monte Carlo search tree. Nodes live in a preallocated pool and link by index.
+typedef struct
+{
+    Board board;       // Position after 'move'.
+    int32_t parent;    // -1 for the root.
+    int32_t first_child;
+    int32_t next_sibling;
+    uint32_t visits;
+    uint32_t score;    // 2 per win, 1 per draw, for the player who made 'move'.
+    uint16_t untried;  // Legal moves not expanded yet (0 once the game is over).
+    int8_t move;       // Cell index played to reach this node.
+    char mover;        // Player who made 'move'.
+} MctsNode;
+// Per-move budget of the MCTS difficulty.
+typedef struct
+{
+    int threads;
+    long long rollouts;  // Total rollouts per move, 0 for no limit.
+    int time_budget_ms;  // Thinking time per move, 0 for no limit.
+} MctsSettings;
+// Input and output of one root-parallel MCTS thread.
+typedef struct
+{
+    Board root;
+    char player;              // Side to move at the root.
+    long long rollout_budget; // 0 for no limit.
+    double deadline;          // Seconds from now_seconds(), 0 for no limit.
+    Random rng;
+    MctsNode* pool;
+    long long rollouts;             // Rollouts done.
+    uint32_t root_visits[CELL_COUNT]; // Visits of each root move.
+} MctsWorker;
+// Outcome of one root-parallel MCTS move choice.
+typedef struct
+{
+    long long rollouts; // Summed over all threads.
+    double seconds;
+    int threads; // Threads that actually ran (thread creation may fail).
+} MctsStats;
+// One node of an m,n,k Monte Carlo search tree. Boards are too large to store per node,
+// so positions are rebuilt by replaying the moves from the root.
+typedef struct
+{
+    int32_t parent; // -1 for the root.
+    int32_t first_child;
+    int32_t next_sibling;
+    uint32_t visits;
+    uint32_t score;   // 2 per win, 1 per draw, for the player who made 'move'.
+    int16_t move;     // Cell index played to reach this node, -1 for the root.
+    uint8_t expanded; // Set once the candidate moves are children.
+    char mover;       // Player who made 'move'.
+} MnkMctsNode;
+// Input and output of one root-parallel m,n,k MCTS thread.
+typedef struct
+{
+    const MnkBoard* root;
+    char player;              // Side to move at the root.
+    long long rollout_budget; // 0 for no limit.
+    double deadline;          // Seconds from now_seconds(), 0 for no limit.
+    Random rng;
+    MnkMctsNode* pool;
+    MnkBoard board;                      // Scratch position of the current rollout.
+    long long rollouts;                  // Rollouts done.
+    uint32_t root_visits[MNK_MAX_CELLS]; // Visits of each root move.
+} MnkMctsWorker;
+// AI strategies the self-play simulator can pit against each other.
+typedef enum
+{
+    STRATEGY_RANDOM = 0, // Any empty cell, uniformly.
+    STRATEGY_RULE,       // Win, else block, else first empty cell ('Human' difficulty).
+    STRATEGY_MINIMAX,    // Perfect play from the solved game tree ('God' difficulty).
+    STRATEGY_MCTS,       // Single-threaded MCTS with MCTS_SIMULATION_ROLLOUTS per move.
+    STRATEGY_COUNT
+} Strategy;
+// Work and results of one simulator thread. Aligned to a cache line so
+// neighbouring jobs in the array never share one.
+typedef struct
+{
+    _Alignas(64) Strategy strategy_x;
+    Strategy strategy_o;
+    long long games;      // Games to play.
+    long long first_game; // Index of the first game (even index: X starts).
+    Random rng;           // Private generator.
+    MctsNode* mcts_pool;  // Search tree of STRATEGY_MCTS, NULL if unused.
+    long long x_wins;
+    long long o_wins;
+    long long draws;
+} SimulationJob;
+// State of one iterative-deepening search.
+typedef struct
+{
+    unsigned long nodes;
+    double deadline; // Seconds from now_seconds().
+    int aborted;   // Set when the deadline passes; partial results are discarded.
+    int best_move; // Best root move of the current iteration.
+} MnkSearch;
+// Prompt of a human move with the time spent on the turn.
+typedef struct
+{
+    const char* text;   // Prompt shown after the timer.
+    double start;       // When the turn began.
+    int shown_seconds;  // Seconds in the prompt on screen, -1 before it is shown.
+    char prompt[PROMPT_LENGTH];
+} TurnTimer;
+/*================= Lookup Table =================*/
+// Every winning line as a 9-bit mask.
+static const uint16_t win_masks[WIN_LINE_COUNT] = {
+    0x007, 0x038, 0x1C0, // Rows.
+    0x049, 0x092, 0x124, // Columns.
+    0x111, 0x054,        // Primary and secondary diagonals.
+};
 /*================= Global Variables =================*/
 Score score = {.player1 = 0, .player2 = 0, .draw = 0}; // Global score tracker.
 char current_player_char;                              // Stores 'X' or 'O' for the current player.
+Screen screen;                                         // Back buffer of the board display.
+TTEntry transposition_table[TT_SIZE];                  // Minimax results, indexed by canonical key.
+uint16_t symmetry_masks[SYMMETRY_COUNT][FULL_BOARD + 1]; // Cell mask after each rotation/reflection.
+MnkTTEntry mnk_transposition_table[MNK_TT_SIZE];        // m,n,k search results, indexed by Zobrist key.
+uint64_t zobrist_keys[MNK_MAX_CELLS][2];                // Random key per cell and player.
+uint64_t zobrist_side_key;                              // Mixed in when O is to move.
+const int mnk_directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}}; // Row, column, two diagonals.
+Random ai_rng;                                          // Tie-break randomness of the interactive AI.
+const char* strategy_names[STRATEGY_COUNT] = {"random", "rule", "minimax", "mcts"};
+MctsSettings mcts_settings = {.threads = 1, .rollouts = MCTS_DEFAULT_ROLLOUTS, .time_budget_ms = 0};
+MctsNode mcts_pools[MAX_MCTS_THREADS][MCTS_POOL_SIZE]; // Node pools of the interactive MCTS AI.
+MnkMctsNode mnk_mcts_pools[MAX_MCTS_THREADS][MCTS_POOL_SIZE]; // Node pools of the m,n,k MCTS AI.
 /*================= Function Prototypes =================*/
 // Game Setup & Control Functions
 int get_game_mode();        // Prompts for game mode
@@ -28,26 +250,93 @@ int get_difficulty_level(); // Prompts for AI difficulty
 void reset_scoreboard();    // Resets all scores.
 // Utility Functions
 void clear_screen();       // Clears the console screen.
+void print_under_board(const char* format, ...); // printf() for messages between board frames.
 void exit_message();       // Displays a farewell message.
-void clear_input_buffer(); // Clears leftover input from stdin.
+int read_int(int* value);  // Reads a line holding one number; exits at the end of input.
+void update_turn_timer(void* arg);                      // Redraws the prompt when the turn timer changes.
+int read_move(const char* prompt, int* row, int* col);  // Reads "row col" while the turn timer runs.
+// Bitboard Helpers
+uint16_t player_cells(Board board, char player);        // Returns the bit mask of a player's cells.
+uint16_t empty_cells(Board board);                      // Returns the bit mask of empty cells.
+char cell_at(Board board, int row, int col);            // Returns 'X', 'O' or ' ' for a cell.
+void place_mark(Board* board, int cell, char player);   // Puts a player's mark on a cell index.
+int find_winning_cell(uint16_t own, uint16_t empty);    // Finds a cell completing a line for 'own'.
 // Game Logic Functions
-void print_board(char board[BOARD_SIZE][BOARD_SIZE], int mode);              // Prints the board and scoreboard.
-int check_win(char board[BOARD_SIZE][BOARD_SIZE], char player);              // Checks for a win condition.
-int check_draw(char board[BOARD_SIZE][BOARD_SIZE]);                          // Checks for a draw condition.
-int is_valid_move(char board[BOARD_SIZE][BOARD_SIZE], int row, int col);     // Validates a player's chosen move.
-void player_move(char board[BOARD_SIZE][BOARD_SIZE], char player, int mode); // Handles human player input.
-void computer_move(char board[BOARD_SIZE][BOARD_SIZE], int difficulty);      // Makes a move for the AI.
-void play_game(int mode, int difficulty);                                    // Manages a single round of Tic-Tac-Toe.
-/*================= Functions for future implementation (Minimax AI) =================*/
-// #define max(a, b) ((a) > (b) ? (a) : (b))
-// #define min(a, b) ((a) < (b) ? (a) : (b))
-// int evaluate(char board[BOARD_SIZE][BOARD_SIZE]);                                     // Evaluates board state for Minimax.
-// int minimax(char board[BOARD_SIZE][BOARD_SIZE], int depth, int is_maximizing_player); // Minimax algorithm.
-// void find_best_move(char board[BOARD_SIZE][BOARD_SIZE], int* row, int* col);          // Finds optimal move using Minimax.
+void print_board(Board board, int mode);                // Prints the board and scoreboard.
+int check_win(Board board, char player);                // Checks for a win condition.
+int check_draw(Board board);                            // Checks for a draw condition.
+int is_valid_move(Board board, int row, int col);       // Validates a player's chosen move.
+void player_move(Board* board, char player, int mode);  // Handles human player input.
+int rule_based_cell(Board board, char player);          // Win, else block, else first empty cell.
+void computer_move(Board* board, int difficulty);       // Makes a move for the AI.
+void play_game(int mode, int difficulty);               // Manages a single round of Tic-Tac-Toe.
+// Minimax AI Functions
+void init_symmetry_masks();                                     // Precomputes the 8 board symmetries.
+uint32_t canonical_key(Board board, char player);               // Symmetry-independent table index.
+int evaluate(Board board, char player);                         // Scores a finished game for Minimax.
+int minimax(Board board, char player, int alpha, int beta);     // Alpha-beta search with transposition table.
+void solve_positions(Board board, char player, uint8_t* seen);  // Fills the table for every reachable position.
+void solve_game_tree();                                         // Solves the whole game once at startup.
+void find_best_move(Board board, char player, Random* rng, int* row, int* col); // Optimal move via Minimax.
+// m,n,k (Gomoku-style) Functions
+int get_bounded_number(const char* prompt, int min, int max);   // Prompts for a number in a range.
+void get_mnk_settings(MnkSettings* settings);                   // Prompts for board size, win length, time.
+void init_zobrist_keys();                                       // Fills the Zobrist hash keys.
+void mnk_init_board(MnkBoard* board, const MnkSettings* settings); // Empties the board.
+int mnk_window_score(const MnkBoard* board, int cell);          // Scores all windows through a cell.
+void mnk_set_cell(MnkBoard* board, int cell, char mark);        // Places/removes a mark incrementally.
+int mnk_is_winning_move(const MnkBoard* board, int cell);       // Checks the lines through the last move.
+int mnk_generate_moves(MnkBoard* board, char player, int table_move, int* moves); // Ordered candidates.
+int mnk_search(MnkSearch* search, MnkBoard* board, int depth, int ply, int alpha, int beta, char player); // Alpha-beta.
+int mnk_find_best_move(MnkBoard* board, char player, int time_budget_ms, int* depth_reached); // Iterative deepening.
+void mnk_print_board(const MnkBoard* board);                    // Prints the m,n,k board.
+void play_mnk_game(const MnkSettings* settings);                // Manages a single m,n,k round.
+// Headless Self-Play Simulator
+int strategy_cell(Strategy strategy, Board board, char player, SimulationJob* job); // Picks a move.
+char simulate_game(Strategy strategy_x, Strategy strategy_o, char first, SimulationJob* job); // One game.
+void* run_simulation_job(void* arg);                            // Simulator thread routine.
+int get_thread_count();                                         // Number of online CPU cores.
+int parse_strategy(const char* name);                           // Strategy from its name, -1 if unknown.
+int run_simulation(int argc, char* argv[]);                     // Handles --simulate.
+// Monte Carlo Tree Search Functions
+void get_mcts_settings();                                       // Prompts for the MCTS budget.
+double now_seconds();                                           // Monotonic time in seconds.
+char random_playout(Board board, char player, Random* rng); // Plays random moves to the end.
+double mcts_uct(uint32_t score, uint32_t visits, double log_parent_visits); // UCT value of a child.
+int mcts_select_child(const MctsNode* pool, int node);          // UCT child selection.
+void mcts_run(MctsWorker* worker);                              // Grows one search tree.
+void* mcts_thread(void* arg);                                   // MCTS thread routine.
+int mcts_best_cell(Board board, char player, const MctsSettings* settings, MctsNode* pools, Random* rng,
+                   MctsStats* stats);                           // Root-parallel MCTS move choice.
+char mnk_result(const MnkBoard* board, int cell);               // Winner after a move, 0 if not over.
+char mnk_random_playout(MnkBoard* board, char player, Random* rng); // Random moves near the marks.
+int mnk_mcts_select_child(const MnkMctsNode* pool, int node);   // UCT child selection.
+void mnk_mcts_run(MnkMctsWorker* worker);                       // Grows one m,n,k search tree.
+void* mnk_mcts_thread(void* arg);                               // m,n,k MCTS thread routine.
+int mnk_mcts_best_cell(const MnkBoard* board, char player, const MctsSettings* settings, MnkMctsNode* pools,
+                       Random* rng, MctsStats* stats);          // Root-parallel m,n,k MCTS move choice.
+int run_mcts_benchmark(int argc, char* argv[]);                 // Handles --mcts-bench.
 /*================= Main Function =================*/
-int main()
+int main(int argc, char* argv[])
 {
-    srand(time(NULL)); // Seeds a random number
+    random_seed(&ai_rng, random_entropy()); // Different tie-breaks and first players every run
+    solve_game_tree(); // Precomputes perfect play for 'God' mode.
+
+    // Headless mode: AI vs AI, no board drawing and no input.
+    if (argc > 1 && strcmp(argv[1], "--simulate") == 0)
+    {
+        return run_simulation(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--mcts-bench") == 0)
+    {
+        return run_mcts_benchmark(argc, argv);
+    }
+    if (!screen_init(&screen, SCREEN_ROWS, SCREEN_COLS))
+    {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    input_raw(input_stdin(), 1); // The line editor echoes, so the prompt can be redrawn while typing.
 
     printf("\n-----------------------------\n");
     printf("Welcome to TIC-TAC-TOE game!!");
@@ -58,6 +347,7 @@ int main()
     int prev_mode = -1;       // Tracks previous mode
     int prev_difficulty = -1; // Tracks previous difficulty
     int choice_play_again;
+    MnkSettings mnk_settings;
 
     // Main loop for game mode selection and continuous play sessions.
     while (1)
@@ -72,7 +362,7 @@ int main()
             prev_difficulty = -1; // Difficulty
         }
 
-        if (current_mode == 3)
+        if (current_mode == 4)
         { // Exit program.
             break;
         }
@@ -82,6 +372,10 @@ int main()
         {
             clear_screen();
             current_difficulty = get_difficulty_level();
+            if (current_difficulty == 3)
+            {
+                get_mcts_settings();
+            }
 
             // Reset scoreboard if difficulty changes within Single Player mode.
             if (current_difficulty != prev_difficulty)
@@ -91,27 +385,38 @@ int main()
             }
 
             // Option to return to main mode menu from difficulty selection.
-            if (current_difficulty == 3)
+            if (current_difficulty == 4)
             {
                 prev_mode = -1; // Force score reset if user re-enters same mode later.
                 continue;       // Skip game play, go back to mode selection.
             }
         }
-        else // Duo Player mode (current_mode == 2).
+        else // Duo Player or Gomoku mode (current_mode == 2 or 3).
         {
             prev_difficulty = -1;    // Difficulty not applicable for Duo mode.
             current_difficulty = -1; // Set to unused value.
+            if (current_mode == 3)
+            {
+                clear_screen();
+                get_mnk_settings(&mnk_settings);
+                reset_scoreboard(); // New board settings, new scores.
+            }
         }
 
         // Loop to play multiple rounds with the same settings.
         do
         {
-            play_game(current_mode, current_difficulty);
+            if (current_mode == 3)
+                play_mnk_game(&mnk_settings);
+            else
+                play_game(current_mode, current_difficulty);
 
             printf("Want to play again with same settings? (1 for yes, 0 for no to go to main "
                    "menu): ");
-            scanf("%d", &choice_play_again);
-            clear_input_buffer(); // Clear input buffer after reading choice.
+            if (!read_int(&choice_play_again))
+            {
+                choice_play_again = 0; // Not a number: back to the main menu.
+            }
             clear_screen();
         } while (choice_play_again == 1);
     }
@@ -122,7 +427,7 @@ int main()
 /*================= Function Definitions =================*/
 /**
  * @brief Prompts the user to select the game mode.
- * Ensures valid input (1, 2, or 3).
+ * Ensures valid input (1 - 4).
  * @return The selected game mode.
  */
 int get_game_mode()
@@ -134,17 +439,17 @@ int get_game_mode()
         printf("\nSelect mode\n");
         printf("01. Single (Play against computer)\n");
         printf("02. Duo (Play with another player)\n");
-        printf("03. Exit\n");
-        printf("Enter your choice (1 - 3): ");
-        input_status = scanf("%d", &mode);
-        clear_input_buffer();
+        printf("03. Gomoku (Play against computer on a bigger board)\n");
+        printf("04. Exit\n");
+        printf("Enter your choice (1 - 4): ");
+        input_status = read_int(&mode);
 
-        if (input_status != 1 || mode < 1 || mode > 3)
+        if (input_status != 1 || mode < 1 || mode > 4)
         {
-            printf("Invalid input. Please enter a number between 1 and 3.\n");
+            printf("Invalid input. Please enter a number between 1 and 4.\n");
             clear_screen();
         }
-    } while (input_status != 1 || mode < 1 || mode > 3);
+    } while (input_status != 1 || mode < 1 || mode > 4);
     return mode;
 }
 /**
@@ -160,17 +465,17 @@ int get_difficulty_level()
         printf("\nSelect difficulty level\n");
         printf("01. Human (Standard)\n");
         printf("02. God (Impossible to win)\n");
-        printf("03. Back to mode menu\n");
-        printf("Enter your difficulty (1 - 3): ");
-        input_status = scanf("%d", &difficulty);
-        clear_input_buffer();
+        printf("03. MCTS (Monte Carlo Tree Search)\n");
+        printf("04. Back to mode menu\n");
+        printf("Enter your difficulty (1 - 4): ");
+        input_status = read_int(&difficulty);
 
-        if (input_status != 1 || difficulty < 1 || difficulty > 3)
+        if (input_status != 1 || difficulty < 1 || difficulty > 4)
         {
-            printf("Invalid input. Please enter a number between 1 and 3.\n");
+            printf("Invalid input. Please enter a number between 1 and 4.\n");
             clear_screen();
         }
-    } while (input_status != 1 || difficulty < 1 || difficulty > 3);
+    } while (input_status != 1 || difficulty < 1 || difficulty > 4);
     return difficulty;
 }
 /**
@@ -183,15 +488,26 @@ void reset_scoreboard()
     score.draw = 0;
 }
 /**
- * @brief Clears the console screen using system-specific commands.
+ * @brief Clears the console screen.
  */
 void clear_screen()
 {
-#ifdef _WIN32 // For Windows systems.
-    system("cls");
-#else // For Linux/macOS (Unix-like systems).
-    system("clear");
-#endif
+    screen_clear_terminal(&screen); // ANSI escape sequences, no shell process.
+}
+/**
+ * @brief Prints a message under the board and tells the renderer, so the next board
+ * is redrawn in full only if the messages scrolled the terminal.
+ * @param format printf-style format.
+ */
+void print_under_board(const char* format, ...)
+{
+    char text[PROMPT_LENGTH * 2];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    fputs(text, stdout);
+    screen_note_text(&screen, text);
 }
 /**
  * @brief Displays a polite farewell message to the user.
@@ -204,102 +520,210 @@ void exit_message()
     printf("Exiting...\n\n");
 }
 /**
- * @brief Clears any leftover characters in the standard input buffer.
- * Reads characters until a newline or EOF is encountered.
+ * @brief Reads a line holding one number. The game ends when there is no more input.
+ * @param value Stores the number.
+ * @return 1 if the line was a number, 0 otherwise.
+ */
+int read_int(int* value)
+{
+    int status = input_int(input_stdin(), value);
+    if (status < 0)
+    {
+        exit_message();
+        exit(0);
+    }
+    return status;
+}
+/**
+ * @brief Rewrites the move prompt when the seconds of the turn timer change.
+ * Runs while the player types; what was typed so far is kept.
+ * @param arg The TurnTimer.
+ */
+void update_turn_timer(void* arg)
+{
+    TurnTimer* timer = arg;
+    int seconds = (int)(now_seconds() - timer->start);
+    if (seconds != timer->shown_seconds)
+    {
+        timer->shown_seconds = seconds;
+        snprintf(timer->prompt, sizeof(timer->prompt), "[%d:%02d] %s", seconds / 60, seconds % 60, timer->text);
+        input_redraw(input_stdin(), timer->prompt);
+    }
+}
+/**
+ * @brief Reads a move as two numbers, "row col". In a terminal the prompt
+ * shows how long the turn has taken so far.
+ * @param prompt Text asking for the move.
+ * @param row Stores the first number (1-based).
+ * @param col Stores the second number (1-based).
+ * @return 1 if the line held two numbers, 0 otherwise. The game ends when there is no more input.
+ */
+int read_move(const char* prompt, int* row, int* col)
+{
+    Input* input = input_stdin();
+    TurnTimer timer = {.text = prompt, .start = now_seconds(), .shown_seconds = -1};
+    if (input->raw)
+    {
+        update_turn_timer(&timer); // Shows the prompt with the timer at 0:00.
+    }
+    else
+    {
+        printf("%s", prompt); // No line editor: the prompt cannot be redrawn.
+    }
+    char line[INPUT_LINE_LENGTH];
+    int cell[2];
+    if (!input_line(input, line, sizeof(line), TURN_TIMER_INTERVAL_MS, update_turn_timer, &timer))
+    {
+        exit_message();
+        exit(0);
+    }
+    // The prompt line and the answer echoed with it sit under the board too.
+    screen_note_text(&screen, input->raw ? timer.prompt : prompt);
+    screen_note_text(&screen, line);
+    screen_note_text(&screen, "\n");
+    if (!input_parse_ints(line, cell, 2))
+    {
+        return 0;
+    }
+    *row = cell[0];
+    *col = cell[1];
+    return 1;
+}
+/**
+ * @brief Returns the bit mask of cells owned by a player.
+ * @param board The current bitboard.
+ * @param player The character representing the player ('X' or 'O').
+ * @return 9-bit mask of the player's cells.
+ */
+uint16_t player_cells(Board board, char player)
+{
+    return (player == PLAYER1) ? board.player1 : board.player2;
+}
+/**
+ * @brief Returns the bit mask of empty cells.
+ * @param board The current bitboard.
+ * @return 9-bit mask of empty cells.
+ */
+uint16_t empty_cells(Board board)
+{
+    return ~(board.player1 | board.player2) & FULL_BOARD;
+}
+/**
+ * @brief Returns the mark on a cell, for display.
+ * @param board The current bitboard.
+ * @param row The row index (0-based).
+ * @param col The column index (0-based).
+ * @return 'X', 'O' or ' '.
+ */
+char cell_at(Board board, int row, int col)
+{
+    if (board.player1 & CELL_BIT(row, col))
+        return PLAYER1;
+    if (board.player2 & CELL_BIT(row, col))
+        return PLAYER2;
+    return EMPTY_CELL;
+}
+/**
+ * @brief Places a player's mark on a cell.
+ * @param board The bitboard to update.
+ * @param cell Cell index (row * 3 + col).
+ * @param player The character representing the player ('X' or 'O').
+ */
+void place_mark(Board* board, int cell, char player)
+{
+    if (player == PLAYER1)
+        board->player1 |= 1u << cell;
+    else
+        board->player2 |= 1u << cell;
+}
+/**
+ * @brief Finds an empty cell that completes a line already holding two of 'own' marks.
+ * @param own Mask of the player's cells.
+ * @param empty Mask of empty cells.
+ * @return Cell index of the winning move, or -1 if there is none.
  */
-void clear_input_buffer()
+int find_winning_cell(uint16_t own, uint16_t empty)
 {
-    int ch;
-    while ((ch = getchar()) != '\n' && ch != EOF)
-        ;
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
+    {
+        uint16_t gap = win_masks[i] & empty;
+        if (gap && __builtin_popcount(own & win_masks[i]) == BOARD_SIZE - 1)
+            return __builtin_ctz(gap); // The line's single empty cell.
+    }
+    return -1;
 }
 /**
  * @brief Prints the current state of the game board along with the scoreboard.
  * Scoreboard labels adjust based on game mode (Single Player vs. Duo Player).
- * @param board The 2D array representing the Tic-Tac-Toe board.
+ * @param board The bitboard representing the Tic-Tac-Toe board.
  * @param mode The current game mode (1 for Single, 2 for Duo).
  */
-void print_board(char board[BOARD_SIZE][BOARD_SIZE], int mode)
+void print_board(Board board, int mode)
 {
-    clear_screen();
+    screen_begin_frame(&screen);
     // Print scoreboard based on game mode.
     if (mode == 1)
     { // Single Player mode.
-        printf("Score Board:- You (X): %d, Computer (O): %d, Draw: %d\n\n", score.player1, score.player2, score.draw);
+        screen_printf(&screen, "Score Board:- You (X): %d, Computer (O): %d, Draw: %d\n\n", score.player1, score.player2, score.draw);
     }
     else
     { // Duo Player mode.
-        printf("Score Board:- Player-1 (X): %d, Player-2 (O): %d, Draw: %d\n\n", score.player1, score.player2, score.draw);
+        screen_printf(&screen, "Score Board:- Player-1 (X): %d, Player-2 (O): %d, Draw: %d\n\n", score.player1, score.player2, score.draw);
     }
     // Print the game board grid.
     for (int row = 0; row < BOARD_SIZE; row++)
     {
         for (int col = 0; col < BOARD_SIZE; col++)
         {
-            printf(" %c ", board[row][col]);
+            screen_printf(&screen, " %c ", cell_at(board, row, col));
             if (col < BOARD_SIZE - 1)
             {
-                printf("|"); // Vertical separator.
+                screen_text(&screen, "|"); // Vertical separator.
             }
         }
         if (row < BOARD_SIZE - 1)
         {
-            printf("\n---+---+---\n"); // Horizontal separator.
+            screen_text(&screen, "\n---+---+---\n"); // Horizontal separator.
         }
     }
-    printf("\n");
+    screen_text(&screen, "\n");
+    screen_present(&screen);
 }
 /**
  * @brief Checks if a specified player has achieved a winning configuration.
- * @param board The current state of the Tic-Tac-Toe board.
+ * @param board The current bitboard.
  * @param player The character representing the player ('X' or 'O').
  * @return 1 if the player has won, 0 otherwise.
  */
-int check_win(char board[BOARD_SIZE][BOARD_SIZE], char player)
+int check_win(Board board, char player)
 {
-    // Check all rows and columns.
-    for (int i = 0; i < BOARD_SIZE; i++)
+    uint16_t cells = player_cells(board, player);
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
     {
-        if (board[i][0] == player && board[i][1] == player && board[i][2] == player)
-            return 1; // Row win.
-        if (board[0][i] == player && board[1][i] == player && board[2][i] == player)
-            return 1; // Column win.
+        if ((cells & win_masks[i]) == win_masks[i])
+            return 1; // All three cells of the line are owned.
     }
-    // Check main diagonals.
-    if (board[0][0] == player && board[1][1] == player && board[2][2] == player)
-        return 1; // Primary diagonal.
-    if (board[0][2] == player && board[1][1] == player && board[2][0] == player)
-        return 1; // Secondary diagonal.
-
     return 0; // No win detected.
 }
 /**
  * @brief Checks if the game board is full, indicating a draw.
- * @param board The current state of the Tic-Tac-Toe board.
+ * @param board The current bitboard.
  * @return 1 if the board is full (draw), 0 otherwise.
  */
-int check_draw(char board[BOARD_SIZE][BOARD_SIZE])
+int check_draw(Board board)
 {
-    for (int i = 0; i < BOARD_SIZE; i++)
-    {
-        for (int j = 0; j < BOARD_SIZE; j++)
-        {
-            if (board[i][j] == EMPTY_CELL)
-                return 0; // Empty cell found, not a draw.
-        }
-    }
-    return 1; // Board is full.
+    return empty_cells(board) == 0; // Board is full.
 }
 /**
  * @brief Checks if a player's chosen move (row, col) is valid.
- * @param board The current state of the Tic-Tac-Toe board.
+ * @param board The current bitboard.
  * @param row The row index (0-based).
  * @param col The column index (0-based).
  * @return 1 if the move is valid, 0 otherwise.
  */
-int is_valid_move(char board[BOARD_SIZE][BOARD_SIZE], int row, int col)
+int is_valid_move(Board board, int row, int col)
 {
-    return (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE && board[row][col] == EMPTY_CELL);
+    return (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE && (empty_cells(board) & CELL_BIT(row, col)));
 }
 /**
  * @brief Handles a human player's turn, prompting for and validating input.
@@ -307,115 +731,273 @@ int is_valid_move(char board[BOARD_SIZE][BOARD_SIZE], int row, int col)
  * @param player The current player's character ('X' or 'O').
  * @param mode Game mode, used for turn message.
  */
-void player_move(char board[BOARD_SIZE][BOARD_SIZE], char player, int mode)
+void player_move(Board* board, char player, int mode)
 {
     int row, col;
-    int input_status; // Stores scanf's return value for validation.
+    int input_status; // 1 if two numbers were read.
+    char prompt[PROMPT_LENGTH];
 
     do
     {
         // Display turn message based on game mode and current player.
         if (mode == 1)
         {
-            printf("\nYour turn.\n");
+            print_under_board("\nYour turn.\n");
         }
         else // Duo player mode.
         {
-            (current_player_char == PLAYER1) ? printf("\nPlayer-1's turn.\n") : printf("\nPlayer-2's turn.\n");
+            print_under_board((current_player_char == PLAYER1) ? "\nPlayer-1's turn.\n" : "\nPlayer-2's turn.\n");
         }
-        printf("Enter row and column (1 - 3) for %c: ", player);
-        input_status = scanf("%d %d", &row, &col); // Read user input for row and column.
-        clear_input_buffer();                      // Clear any remaining characters in buffer.
+        snprintf(prompt, sizeof(prompt), "Enter row and column (1 - 3) for %c: ", player);
+        input_status = read_move(prompt, &row, &col); // Read user input for row and column.
 
         // Convert 1-based input to 0-based array indices.
         row--;
         col--;
 
         // Validate input: checks if two numbers were read and if the move is valid.
-        if (input_status != 2 || !is_valid_move(board, row, col))
+        if (input_status != 1 || !is_valid_move(*board, row, col))
         {
-            printf("Invalid input or move. Please enter two numbers (1-3) for an empty cell.\n");
+            print_under_board("Invalid input or move. Please enter two numbers (1-3) for an empty cell.\n");
         }
-    } while (input_status != 2 || !is_valid_move(board, row, col)); // Repeat until valid input/move.
-    board[row][col] = player; // Place the player's mark on the board.
+    } while (input_status != 1 || !is_valid_move(*board, row, col)); // Repeat until valid input/move.
+    place_mark(board, row * BOARD_SIZE + col, player); // Place the player's mark on the board.
 }
 /**
- * @brief Makes a move for the computer player based on rule-based AI.
- * Prioritizes winning, then blocking, then strategic spots (center/corners for God mode), then any random spot.
+ * @brief Makes a move for the computer player.
+ * 'God' mode plays the solved game tree, 'MCTS' mode runs a Monte Carlo Tree Search.
+ * 'Human' mode prioritizes winning, then blocking, then any spot.
  * @param board The game board to update.
  * @param difficulty AI difficulty level.
  */
-void computer_move(char board[BOARD_SIZE][BOARD_SIZE], int difficulty)
+void computer_move(Board* board, int difficulty)
 {
-    printf("\nComputer's turn...\n");
+    print_under_board("\nComputer's turn...\n");
 
-    // 1. Check for an immediate winning move.
-    for (int i = 0; i < BOARD_SIZE; i++)
+    // 'God' difficulty: perfect play from the solved game tree.
+    if (difficulty == 2)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
-        {
-            if (board[i][j] == EMPTY_CELL)
-            {
-                board[i][j] = PLAYER2; // Try placing computer's mark.
-                if (check_win(board, PLAYER2))
-                    return;               // If it wins, make the move and return.
-                board[i][j] = EMPTY_CELL; // Undo the trial move.
-            }
-        }
+        int row, col;
+        find_best_move(*board, PLAYER2, &ai_rng, &row, &col);
+        place_mark(board, row * BOARD_SIZE + col, PLAYER2);
+        return;
+    }
+    // 'MCTS' difficulty: root-parallel Monte Carlo Tree Search.
+    if (difficulty == 3)
+    {
+        MctsStats stats;
+        int cell = mcts_best_cell(*board, PLAYER2, &mcts_settings, &mcts_pools[0][0], &ai_rng, &stats);
+        place_mark(board, cell, PLAYER2);
+        print_under_board("MCTS: %lld rollouts on %d threads in %.1f ms (%.0f rollouts/s per thread)\n",
+                          stats.rollouts, stats.threads, stats.seconds * 1000, stats.rollouts / stats.seconds / stats.threads);
+        return;
     }
+
+    int cell = rule_based_cell(*board, PLAYER2);
+    if (cell >= 0)
+        place_mark(board, cell, PLAYER2);
+}
+/**
+ * @brief Rule-based AI used by 'Human' difficulty.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @return Cell index to play, or -1 if the board is full.
+ */
+int rule_based_cell(Board board, char player)
+{
+    uint16_t empty = empty_cells(board);
+    char opponent = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+
+    // 1. Check for an immediate winning move.
+    int cell = find_winning_cell(player_cells(board, player), empty);
     // 2. Check for an immediate blocking move
-    for (int i = 0; i < BOARD_SIZE; i++)
+    if (cell < 0)
+        cell = find_winning_cell(player_cells(board, opponent), empty);
+    // 3. Any available move.
+    if (cell < 0 && empty)
+        cell = __builtin_ctz(empty);
+    return cell;
+}
+
+/**
+ * @brief Precomputes, for every symmetry of the square, where each cell mask maps to.
+ * Symmetry s rotates the board s % 4 quarter turns and mirrors it when s >= 4.
+ */
+void init_symmetry_masks()
+{
+    for (int sym = 0; sym < SYMMETRY_COUNT; sym++)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        int cell_map[CELL_COUNT];
+        for (int row = 0; row < BOARD_SIZE; row++)
         {
-            if (board[i][j] == EMPTY_CELL)
+            for (int col = 0; col < BOARD_SIZE; col++)
             {
-                board[i][j] = PLAYER1; // Try placing opponent's mark.
-                if (check_win(board, PLAYER1))
+                int r = row, c = (sym >= 4) ? BOARD_SIZE - 1 - col : col; // Mirror first.
+                for (int turn = 0; turn < sym % 4; turn++)                 // Then rotate clockwise.
                 {
-                    board[i][j] = PLAYER2; // Block the opponent's winning move.
-                    return;
+                    int old_r = r;
+                    r = c;
+                    c = BOARD_SIZE - 1 - old_r;
                 }
-                board[i][j] = EMPTY_CELL; // Undo the trial move.
+                cell_map[row * BOARD_SIZE + col] = r * BOARD_SIZE + c;
             }
         }
-    }
-    // 3. 'God' difficulty: Prioritize strategic spots (center, then corners).
-    if (difficulty == 2)
-    {
-        if (board[1][1] == EMPTY_CELL) // Center cell move
-        {
-            board[1][1] = PLAYER2;
-            return;
-        }
-        // List of corner coordinates.
-        int corner[4][2] = {
-            {0, 0},
-            {0, 2},
-            {2, 0},
-            {2, 2}
-        };
-        for (int i = 0; i < 4; i++) // Corner cell move
+        for (int mask = 0; mask <= FULL_BOARD; mask++)
         {
-            if (board[corner[i][0]][corner[i][1]] == EMPTY_CELL)
+            uint16_t mapped = 0;
+            for (int cell = 0; cell < CELL_COUNT; cell++)
             {
-                board[corner[i][0]][corner[i][1]] = PLAYER2;
-                return;
+                if (mask & (1u << cell))
+                    mapped |= 1u << cell_map[cell];
             }
+            symmetry_masks[sym][mask] = mapped;
         }
     }
-    // 4. Any available move.
-    for (int i = 0; i < BOARD_SIZE; i++)
+}
+/**
+ * @brief Builds a transposition table index that is the same for all 8 symmetric boards.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @return The smallest key among the board's rotations and reflections.
+ */
+uint32_t canonical_key(Board board, char player)
+{
+    uint32_t best = UINT32_MAX;
+    for (int sym = 0; sym < SYMMETRY_COUNT; sym++)
+    {
+        uint32_t key = symmetry_masks[sym][board.player1] | ((uint32_t)symmetry_masks[sym][board.player2] << CELL_COUNT);
+        if (key < best)
+            best = key;
+    }
+    return (best << 1) | (player == PLAYER2);
+}
+/**
+ * @brief Scores a finished game from the point of view of the side to move.
+ * Faster wins (more empty cells left) score higher.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @return Negative if the opponent has won, 0 otherwise.
+ */
+int evaluate(Board board, char player)
+{
+    char opponent = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    if (check_win(board, opponent))
+        return -(__builtin_popcount(empty_cells(board)) + 1);
+    return 0;
+}
+/**
+ * @brief Negamax search with alpha-beta pruning and a symmetry-aware transposition table.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @param alpha Lower bound of the search window.
+ * @param beta Upper bound of the search window.
+ * @return Score of the position for the side to move.
+ */
+int minimax(Board board, char player, int alpha, int beta)
+{
+    uint16_t empty = empty_cells(board);
+    int score_now = evaluate(board, player);
+    if (score_now != 0 || empty == 0)
+        return score_now; // Game over.
+
+    TTEntry* entry = &transposition_table[canonical_key(board, player)];
+    if (entry->flag == TT_EXACT || (entry->flag == TT_LOWER && entry->value >= beta) ||
+        (entry->flag == TT_UPPER && entry->value <= alpha))
+        return entry->value;
+
+    char opponent = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    int alpha_original = alpha;
+    int best = -SCORE_INFINITY;
+    for (uint16_t moves = empty; moves; moves &= moves - 1)
+    {
+        Board child = board;
+        place_mark(&child, __builtin_ctz(moves), player);
+        int value = -minimax(child, opponent, -beta, -alpha);
+        if (value > best)
+            best = value;
+        if (best > alpha)
+            alpha = best;
+        if (alpha >= beta)
+            break; // Cut-off: the opponent will avoid this line.
+    }
+
+    entry->value = best;
+    if (best <= alpha_original)
+        entry->flag = TT_UPPER;
+    else if (best >= beta)
+        entry->flag = TT_LOWER;
+    else
+        entry->flag = TT_EXACT;
+    return best;
+}
+/**
+ * @brief Visits every reachable position once (per symmetry class) and stores its exact score.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @param seen Marks canonical keys already visited.
+ */
+void solve_positions(Board board, char player, uint8_t* seen)
+{
+    uint32_t key = canonical_key(board, player);
+    if (seen[key] || evaluate(board, player) != 0 || empty_cells(board) == 0)
+        return;
+    seen[key] = 1;
+    minimax(board, player, -SCORE_INFINITY, SCORE_INFINITY); // Full window, so the entry is exact.
+
+    char opponent = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    for (uint16_t moves = empty_cells(board); moves; moves &= moves - 1)
+    {
+        Board child = board;
+        place_mark(&child, __builtin_ctz(moves), player);
+        solve_positions(child, opponent, seen);
+    }
+}
+/**
+ * @brief Solves the whole game tree for either player starting, so later moves are table lookups.
+ */
+void solve_game_tree()
+{
+    static uint8_t seen[TT_SIZE];
+    Board empty_board = {.player1 = 0, .player2 = 0};
+    init_symmetry_masks();
+    solve_positions(empty_board, PLAYER1, seen);
+    solve_positions(empty_board, PLAYER2, seen);
+}
+/**
+ * @brief Finds the optimal move using the solved transposition table.
+ * Ties between equally good moves are broken randomly. Only reads the table, so
+ * it is safe to call from several threads once solve_game_tree() has run.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @param rng Generator used for tie-breaks.
+ * @param row Stores the chosen row index (0-based).
+ * @param col Stores the chosen column index (0-based).
+ */
+void find_best_move(Board board, char player, Random* rng, int* row, int* col)
+{
+    char opponent = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    int best_value = -SCORE_INFINITY;
+    int best_cell = -1;
+    int ties = 0;
+    for (uint16_t moves = empty_cells(board); moves; moves &= moves - 1)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        int cell = __builtin_ctz(moves);
+        Board child = board;
+        place_mark(&child, cell, player);
+        int value = -minimax(child, opponent, -SCORE_INFINITY, SCORE_INFINITY); // Exact entry: O(1).
+        if (value > best_value)
         {
-            if (board[i][j] == EMPTY_CELL)
-            {
-                board[i][j] = PLAYER2;
-                return;
-            }
+            best_value = value;
+            best_cell = cell;
+            ties = 1;
+        }
+        else if (value == best_value && random_below(rng, ++ties) == 0)
+        {
+            best_cell = cell;
         }
     }
+    *row = best_cell / BOARD_SIZE;
+    *col = best_cell % BOARD_SIZE;
 }
 
 /**
@@ -426,53 +1008,38 @@ void computer_move(char board[BOARD_SIZE][BOARD_SIZE], int difficulty)
 void play_game(int mode, int difficulty)
 {
     // Initialize the game board with empty cells.
-    char board[BOARD_SIZE][BOARD_SIZE] = {
-        {EMPTY_CELL, EMPTY_CELL, EMPTY_CELL},
-        {EMPTY_CELL, EMPTY_CELL, EMPTY_CELL},
-        {EMPTY_CELL, EMPTY_CELL, EMPTY_CELL},
-    };
-    current_player_char = (rand() % 2 == 0) ? PLAYER1 : PLAYER2; // Randomly decide who starts.
-
-    print_board(board, mode); // Display the initial empty board.
+    Board board = {.player1 = 0, .player2 = 0};
+    current_player_char = (random_below(&ai_rng, 2) == 0) ? PLAYER1 : PLAYER2; // Randomly decide who starts.
+
+    screen_invalidate(&screen); // The menus were printed outside the screen.
+    print_board(board, mode);   // Display the initial empty board.
     // Game loop for a single round.
     while (1)
     {
         // Quality of life feature: Auto-fill if only one empty cell remains.
-        int empty_cells_count = 0;
-        int last_empty_row = -1, last_empty_col = -1;
-        for (int i = 0; i < BOARD_SIZE; i++)
-        {
-            for (int j = 0; j < BOARD_SIZE; j++)
-            {
-                if (board[i][j] == EMPTY_CELL)
-                {
-                    empty_cells_count++;
-                    last_empty_row = i;
-                    last_empty_col = j;
-                }
-            }
-        }
+        uint16_t empty = empty_cells(board);
 
-        if (empty_cells_count == 1)
+        if (__builtin_popcount(empty) == 1)
         {
-            printf("\nOnly one move left! Automatically placing %c at (%d, %d).\n", current_player_char, last_empty_row + 1, last_empty_col + 1);
-            board[last_empty_row][last_empty_col] = current_player_char;
+            int last_empty = __builtin_ctz(empty);
+            print_under_board("\nOnly one move left! Automatically placing %c at (%d, %d).\n", current_player_char, last_empty / BOARD_SIZE + 1, last_empty % BOARD_SIZE + 1);
+            place_mark(&board, last_empty, current_player_char);
         }
         else // Proceed with normal player/AI move.
         {
             if (current_player_char == PLAYER1)
             {
-                player_move(board, PLAYER1, mode); // Player 1's turn.
+                player_move(&board, PLAYER1, mode); // Player 1's turn.
             }
             else // current_player_char == PLAYER2.
             {
                 if (mode == 1)
                 { // Computer's turn in Single Player mode.
-                    computer_move(board, difficulty);
+                    computer_move(&board, difficulty);
                 }
                 else
                 { // Player 2's turn in Duo Player mode.
-                    player_move(board, PLAYER2, mode);
+                    player_move(&board, PLAYER2, mode);
                 }
             }
         }
@@ -513,3 +1080,1126 @@ void play_game(int mode, int difficulty)
         current_player_char = (current_player_char == PLAYER1) ? PLAYER2 : PLAYER1;
     }
 }
+/**
+ * @brief Prompts for one integer setting within a range, re-asking on invalid input.
+ * @param prompt Text shown before the input.
+ * @param min Smallest accepted value.
+ * @param max Largest accepted value.
+ * @return The accepted value.
+ */
+int get_bounded_number(const char* prompt, int min, int max)
+{
+    int value;
+    int input_status;
+    do
+    {
+        printf("%s (%d - %d): ", prompt, min, max);
+        input_status = read_int(&value);
+
+        if (input_status != 1 || value < min || value > max)
+        {
+            printf("Invalid input. Please enter a number between %d and %d.\n", min, max);
+        }
+    } while (input_status != 1 || value < min || value > max);
+    return value;
+}
+/**
+ * @brief Prompts for the board size, win length, AI engine and thinking time of the m,n,k mode.
+ * @param settings Stores the chosen settings.
+ */
+void get_mnk_settings(MnkSettings* settings)
+{
+    printf("\nGomoku setup (standard: 15 x 15 board, 5 in a row)\n");
+    settings->rows = get_bounded_number("Number of rows", MNK_MIN_SIZE, MNK_MAX_SIZE);
+    settings->cols = get_bounded_number("Number of columns", MNK_MIN_SIZE, MNK_MAX_SIZE);
+    int longest = (settings->rows > settings->cols) ? settings->rows : settings->cols;
+    settings->win_length = get_bounded_number("Marks in a row to win", MNK_MIN_SIZE, (longest < MNK_MAX_WIN) ? longest : MNK_MAX_WIN);
+    settings->time_budget_ms = get_bounded_number("Computer thinking time in ms", 10, 60000);
+    printf("01. Alpha-beta search\n");
+    printf("02. Monte Carlo Tree Search\n");
+    settings->threads = 0;
+    if (get_bounded_number("Computer engine", 1, 2) == 2)
+    {
+        int cores = get_thread_count();
+        settings->threads = get_bounded_number("Search threads", 1, (cores < MAX_MCTS_THREADS) ? cores : MAX_MCTS_THREADS);
+    }
+}
+/**
+ * @brief Fills the Zobrist keys used to hash m,n,k positions (once per program run).
+ */
+void init_zobrist_keys()
+{
+    static int initialized = 0;
+    if (initialized)
+        return;
+    initialized = 1;
+
+    Random random;
+    random_seed(&random, 0x9E3779B97F4A7C15ULL); // Fixed seed: hashes only need to be well mixed.
+    random_fill(&random, &zobrist_keys[0][0], MNK_MAX_CELLS * 2);
+    zobrist_side_key = zobrist_keys[0][0] * 0xD6E8FEB86659FD93ULL + 1;
+}
+/**
+ * @brief Resets an m,n,k board to empty with the given dimensions.
+ * @param board The board to reset.
+ * @param settings Board size and win length.
+ */
+void mnk_init_board(MnkBoard* board, const MnkSettings* settings)
+{
+    board->rows = settings->rows;
+    board->cols = settings->cols;
+    board->win_length = settings->win_length;
+    board->move_count = 0;
+    board->evaluation = 0;
+    board->hash = 0;
+    memset(board->cells, EMPTY_CELL, sizeof(board->cells));
+    memset(board->neighbours, 0, sizeof(board->neighbours));
+}
+/**
+ * @brief Sums the scores of every win-length window that passes through a cell.
+ * A window holding only X marks scores positive, only O marks negative.
+ * @param board The m,n,k board.
+ * @param cell Cell index (row * cols + col).
+ * @return The summed window score, from X's point of view.
+ */
+int mnk_window_score(const MnkBoard* board, int cell)
+{
+    int row = cell / board->cols, col = cell % board->cols;
+    int k = board->win_length;
+    int total = 0;
+    for (int d = 0; d < 4; d++)
+    {
+        int dr = mnk_directions[d][0], dc = mnk_directions[d][1];
+        for (int start = 0; start < k; start++)
+        {
+            int first_row = row - start * dr, first_col = col - start * dc;
+            int last_row = first_row + (k - 1) * dr, last_col = first_col + (k - 1) * dc;
+            if (first_row < 0 || first_col < 0 || first_col >= board->cols || last_row >= board->rows || last_col < 0 ||
+                last_col >= board->cols)
+                continue; // Window does not fit on the board.
+
+            int x_count = 0, o_count = 0;
+            for (int i = 0; i < k; i++)
+            {
+                char mark = board->cells[(first_row + i * dr) * board->cols + first_col + i * dc];
+                x_count += (mark == PLAYER1);
+                o_count += (mark == PLAYER2);
+            }
+            if (x_count && !o_count)
+                total += 1 << (2 * x_count);
+            else if (o_count && !x_count)
+                total -= 1 << (2 * o_count);
+        }
+    }
+    return total;
+}
+/**
+ * @brief Places or removes a mark, updating evaluation, hash and neighbour counts incrementally.
+ * @param board The m,n,k board.
+ * @param cell Cell index (row * cols + col).
+ * @param mark PLAYER1 or PLAYER2 to place, EMPTY_CELL to remove the current mark.
+ */
+void mnk_set_cell(MnkBoard* board, int cell, char mark)
+{
+    char old_mark = board->cells[cell];
+    int before = mnk_window_score(board, cell);
+    board->cells[cell] = mark;
+    board->evaluation += mnk_window_score(board, cell) - before;
+
+    char hashed = (mark == EMPTY_CELL) ? old_mark : mark;
+    board->hash ^= zobrist_keys[cell][hashed == PLAYER2];
+
+    int delta = (mark == EMPTY_CELL) ? -1 : 1;
+    board->move_count += delta;
+    int row = cell / board->cols, col = cell % board->cols;
+    for (int r = row - MNK_NEIGHBOUR_RADIUS; r <= row + MNK_NEIGHBOUR_RADIUS; r++)
+    {
+        for (int c = col - MNK_NEIGHBOUR_RADIUS; c <= col + MNK_NEIGHBOUR_RADIUS; c++)
+        {
+            if (r >= 0 && r < board->rows && c >= 0 && c < board->cols)
+                board->neighbours[r * board->cols + c] += delta;
+        }
+    }
+}
+/**
+ * @brief Checks whether the mark on a cell completes a winning line.
+ * Only the four lines through that cell are examined.
+ * @param board The m,n,k board.
+ * @param cell Cell index of the last move.
+ * @return 1 if the move won the game, 0 otherwise.
+ */
+int mnk_is_winning_move(const MnkBoard* board, int cell)
+{
+    char mark = board->cells[cell];
+    int row = cell / board->cols, col = cell % board->cols;
+    for (int d = 0; d < 4; d++)
+    {
+        int count = 1;
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            int dr = sign * mnk_directions[d][0], dc = sign * mnk_directions[d][1];
+            int r = row + dr, c = col + dc;
+            while (r >= 0 && r < board->rows && c >= 0 && c < board->cols && board->cells[r * board->cols + c] == mark)
+            {
+                count++;
+                r += dr;
+                c += dc;
+            }
+        }
+        if (count >= board->win_length)
+            return 1;
+    }
+    return 0;
+}
+/**
+ * @brief Lists candidate moves (empty cells near existing marks), best first.
+ * Candidates are ordered by the table move, then by how much they help the
+ * side to move plus how much they would help the opponent (attack + defence).
+ * @param board The m,n,k board.
+ * @param player The side to move.
+ * @param table_move Best move stored in the transposition table, or -1.
+ * @param moves Stores the ordered candidate cells.
+ * @return Number of candidates, at most MNK_MAX_BRANCH.
+ */
+int mnk_generate_moves(MnkBoard* board, char player, int table_move, int* moves)
+{
+    int cell_count = board->rows * board->cols;
+    int ratings[MNK_MAX_CELLS];
+    int count = 0;
+    if (board->move_count == 0)
+    {
+        moves[0] = (board->rows / 2) * board->cols + board->cols / 2; // Open in the center.
+        return 1;
+    }
+
+    for (int cell = 0; cell < cell_count; cell++)
+    {
+        if (board->cells[cell] != EMPTY_CELL || board->neighbours[cell] == 0)
+            continue;
+        int base = mnk_window_score(board, cell);
+        board->cells[cell] = PLAYER1;
+        int x_gain = mnk_window_score(board, cell) - base;
+        board->cells[cell] = PLAYER2;
+        int o_gain = base - mnk_window_score(board, cell);
+        board->cells[cell] = EMPTY_CELL;
+
+        int rating = (player == PLAYER1) ? 2 * x_gain + o_gain : 2 * o_gain + x_gain;
+        if (cell == table_move)
+            rating = MNK_INFINITY;
+        // Insertion sort, best rating first.
+        int i = count++;
+        while (i > 0 && ratings[i - 1] < rating)
+        {
+            ratings[i] = ratings[i - 1];
+            moves[i] = moves[i - 1];
+            i--;
+        }
+        ratings[i] = rating;
+        moves[i] = cell;
+    }
+    return (count > MNK_MAX_BRANCH) ? MNK_MAX_BRANCH : count;
+}
+/**
+ * @brief Negamax alpha-beta search with a Zobrist-hashed transposition table.
+ * @param search Node counter, deadline and abort flag.
+ * @param board The m,n,k board (restored before returning).
+ * @param depth Remaining depth in plies.
+ * @param ply Distance from the root.
+ * @param alpha Lower bound of the search window.
+ * @param beta Upper bound of the search window.
+ * @param player The side to move.
+ * @return Score of the position for the side to move.
+ */
+int mnk_search(MnkSearch* search, MnkBoard* board, int depth, int ply, int alpha, int beta, char player)
+{
+    if ((++search->nodes & 1023) == 0 && now_seconds() > search->deadline)
+        search->aborted = 1;
+    if (search->aborted)
+        return 0;
+    if (depth == 0)
+        return (player == PLAYER1) ? board->evaluation : -board->evaluation;
+
+    uint64_t key = board->hash ^ ((player == PLAYER2) ? zobrist_side_key : 0);
+    MnkTTEntry* entry = &mnk_transposition_table[key & (MNK_TT_SIZE - 1)];
+    int table_move = -1;
+    if (entry->key == key)
+    {
+        table_move = entry->best_move;
+        // Win scores are stored relative to the node, so shift them back by ply.
+        int value = entry->value;
+        if (value > MNK_WIN_SCORE - MNK_MAX_CELLS)
+            value -= ply;
+        else if (value < -MNK_WIN_SCORE + MNK_MAX_CELLS)
+            value += ply;
+        if (ply > 0 && entry->depth >= depth &&
+            (entry->flag == TT_EXACT || (entry->flag == TT_LOWER && value >= beta) || (entry->flag == TT_UPPER && value <= alpha)))
+            return value;
+    }
+
+    int moves[MNK_MAX_CELLS];
+    int move_total = mnk_generate_moves(board, player, table_move, moves);
+    if (move_total == 0)
+        return 0; // Board full: draw.
+
+    char opponent = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    int alpha_original = alpha;
+    int best = -MNK_INFINITY;
+    int best_move = moves[0];
+    for (int i = 0; i < move_total; i++)
+    {
+        int value;
+        mnk_set_cell(board, moves[i], player);
+        if (mnk_is_winning_move(board, moves[i]))
+            value = MNK_WIN_SCORE - (ply + 1); // Faster wins score higher.
+        else
+            value = -mnk_search(search, board, depth - 1, ply + 1, -beta, -alpha, opponent);
+        mnk_set_cell(board, moves[i], EMPTY_CELL);
+        if (search->aborted)
+            return 0;
+
+        if (value > best)
+        {
+            best = value;
+            best_move = moves[i];
+            if (ply == 0)
+                search->best_move = best_move;
+        }
+        if (best > alpha)
+            alpha = best;
+        if (alpha >= beta)
+            break; // Cut-off.
+    }
+
+    entry->key = key;
+    entry->value = best;
+    if (best > MNK_WIN_SCORE - MNK_MAX_CELLS)
+        entry->value = best + ply;
+    else if (best < -MNK_WIN_SCORE + MNK_MAX_CELLS)
+        entry->value = best - ply;
+    entry->best_move = best_move;
+    entry->depth = depth;
+    entry->flag = (best <= alpha_original) ? TT_UPPER : (best >= beta) ? TT_LOWER : TT_EXACT;
+    return best;
+}
+/**
+ * @brief Picks a move with iterative deepening: searches depth 1, 2, 3, ...
+ * until the time budget runs out, keeping the result of the last finished depth.
+ * @param board The m,n,k board.
+ * @param player The side to move.
+ * @param time_budget_ms Thinking time per move in milliseconds.
+ * @param depth_reached Stores the deepest fully searched depth.
+ * @return Cell index of the chosen move.
+ */
+int mnk_find_best_move(MnkBoard* board, char player, int time_budget_ms, int* depth_reached)
+{
+    MnkSearch search = {.nodes = 0, .aborted = 0, .best_move = -1};
+    // Wall time, not clock(): CPU time runs faster with several threads and slower on a busy machine.
+    search.deadline = now_seconds() + time_budget_ms / 1000.0;
+
+    int moves[MNK_MAX_CELLS];
+    int best_move = (mnk_generate_moves(board, player, -1, moves) > 0) ? moves[0] : -1;
+    int max_depth = board->rows * board->cols - board->move_count;
+    if (max_depth > MNK_MAX_DEPTH)
+        max_depth = MNK_MAX_DEPTH;
+    *depth_reached = 0;
+    for (int depth = 1; depth <= max_depth; depth++)
+    {
+        int value = mnk_search(&search, board, depth, 0, -MNK_INFINITY, MNK_INFINITY, player);
+        if (search.aborted)
+            break; // Unfinished depth: keep the previous answer.
+        best_move = search.best_move;
+        *depth_reached = depth;
+        if (value > MNK_WIN_SCORE - MNK_MAX_CELLS || value < -MNK_WIN_SCORE + MNK_MAX_CELLS)
+            break; // Forced result found, deeper search cannot change it.
+    }
+    return best_move;
+}
+/**
+ * @brief Prints the m,n,k board with 1-based row and column numbers, plus the scoreboard.
+ * @param board The m,n,k board.
+ */
+void mnk_print_board(const MnkBoard* board)
+{
+    screen_begin_frame(&screen);
+    screen_printf(&screen, "Score Board:- You (X): %d, Computer (O): %d, Draw: %d\n", score.player1, score.player2, score.draw);
+    screen_printf(&screen, "%d x %d board, %d in a row wins\n\n   ", board->rows, board->cols, board->win_length);
+    for (int col = 0; col < board->cols; col++)
+    {
+        screen_printf(&screen, "%3d", col + 1);
+    }
+    screen_text(&screen, "\n");
+    for (int row = 0; row < board->rows; row++)
+    {
+        screen_printf(&screen, "%3d", row + 1);
+        for (int col = 0; col < board->cols; col++)
+        {
+            char mark = board->cells[row * board->cols + col];
+            screen_printf(&screen, "  %c", (mark == EMPTY_CELL) ? '.' : mark);
+        }
+        screen_text(&screen, "\n");
+    }
+    screen_present(&screen);
+}
+/**
+ * @brief Manages a single round of the m,n,k game against the computer.
+ * @param settings Board size, win length, AI engine and thinking time.
+ */
+void play_mnk_game(const MnkSettings* settings)
+{
+    static MnkBoard board; // Large; kept off the stack.
+    init_zobrist_keys();
+    mnk_init_board(&board, settings);
+    memset(mnk_transposition_table, 0, sizeof(mnk_transposition_table));
+    current_player_char = (random_below(&ai_rng, 2) == 0) ? PLAYER1 : PLAYER2; // Randomly decide who starts.
+
+    screen_invalidate(&screen); // The menus were printed outside the screen.
+    mnk_print_board(&board);
+    while (1)
+    {
+        int cell;
+        int depth = 0;
+        MctsStats stats = {.rollouts = 0, .seconds = 0, .threads = 0};
+        if (current_player_char == PLAYER1)
+        {
+            int row, col;
+            int input_status;
+            char prompt[PROMPT_LENGTH];
+            snprintf(prompt, sizeof(prompt), "Enter row (1 - %d) and column (1 - %d) for X: ", board.rows, board.cols);
+            do
+            {
+                print_under_board("\nYour turn.\n");
+                input_status = read_move(prompt, &row, &col);
+                row--;
+                col--;
+                if (input_status != 1 || row < 0 || row >= board.rows || col < 0 || col >= board.cols ||
+                    board.cells[row * board.cols + col] != EMPTY_CELL)
+                {
+                    print_under_board("Invalid input or move. Please enter two numbers for an empty cell.\n");
+                    input_status = 0;
+                }
+            } while (input_status != 1);
+            cell = row * board.cols + col;
+        }
+        else
+        {
+            print_under_board("\nComputer's turn...\n");
+            if (settings->threads > 0)
+            {
+                MctsSettings budget = {.threads = settings->threads, .rollouts = 0, .time_budget_ms = settings->time_budget_ms};
+                cell = mnk_mcts_best_cell(&board, PLAYER2, &budget, &mnk_mcts_pools[0][0], &ai_rng, &stats);
+            }
+            else
+            {
+                cell = mnk_find_best_move(&board, PLAYER2, settings->time_budget_ms, &depth);
+            }
+        }
+        mnk_set_cell(&board, cell, current_player_char);
+        mnk_print_board(&board);
+        print_under_board("\nLast move: %c at (%d, %d).", current_player_char, cell / board.cols + 1, cell % board.cols + 1);
+        if (current_player_char == PLAYER2 && settings->threads > 0)
+            print_under_board(" (%lld rollouts on %d threads)", stats.rollouts, stats.threads);
+        else if (current_player_char == PLAYER2)
+            print_under_board(" (searched %d plies ahead)", depth);
+        print_under_board("\n");
+
+        if (mnk_is_winning_move(&board, cell))
+        {
+            if (current_player_char == PLAYER1)
+            {
+                score.player1++;
+                printf("Congratulations!! You (X) have won.\n");
+            }
+            else
+            {
+                score.player2++;
+                printf("I (Computer O) won!! Better luck next time.\n");
+            }
+            break;
+        }
+        if (board.move_count == board.rows * board.cols)
+        {
+            score.draw++;
+            printf("\nIt's a draw.\n");
+            break;
+        }
+        current_player_char = (current_player_char == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+}
+/**
+ * @brief Picks a move for one of the simulator strategies.
+ * @param strategy Which AI to use.
+ * @param board The current bitboard.
+ * @param player The side to move.
+ * @param job The calling thread's job (random state and MCTS pool).
+ * @return Cell index to play.
+ */
+int strategy_cell(Strategy strategy, Board board, char player, SimulationJob* job)
+{
+    uint16_t empty = empty_cells(board);
+    switch (strategy)
+    {
+    case STRATEGY_RULE:
+        return rule_based_cell(board, player);
+    case STRATEGY_MINIMAX:
+    {
+        int row, col;
+        find_best_move(board, player, &job->rng, &row, &col);
+        return row * BOARD_SIZE + col;
+    }
+    case STRATEGY_MCTS:
+    {
+        MctsSettings settings = {.threads = 1, .rollouts = MCTS_SIMULATION_ROLLOUTS, .time_budget_ms = 0};
+        MctsStats stats;
+        return mcts_best_cell(board, player, &settings, job->mcts_pool, &job->rng, &stats);
+    }
+    default: // STRATEGY_RANDOM: skip a random number of empty cells.
+    {
+        int skip = (int)random_below(&job->rng, __builtin_popcount(empty));
+        while (skip--)
+            empty &= empty - 1;
+        return __builtin_ctz(empty);
+    }
+    }
+}
+/**
+ * @brief Plays one game between two strategies without any output.
+ * @param strategy_x Strategy playing 'X'.
+ * @param strategy_o Strategy playing 'O'.
+ * @param first Player making the first move.
+ * @param job The calling thread's job (random state and MCTS pool).
+ * @return The winner ('X' or 'O'), or EMPTY_CELL for a draw.
+ */
+char simulate_game(Strategy strategy_x, Strategy strategy_o, char first, SimulationJob* job)
+{
+    Board board = {.player1 = 0, .player2 = 0};
+    char player = first;
+    while (1)
+    {
+        Strategy strategy = (player == PLAYER1) ? strategy_x : strategy_o;
+        place_mark(&board, strategy_cell(strategy, board, player, job), player);
+        if (check_win(board, player))
+            return player;
+        if (check_draw(board))
+            return EMPTY_CELL;
+        player = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+}
+/**
+ * @brief Simulator thread routine: plays its share of games and counts results.
+ * @param arg Pointer to the thread's SimulationJob.
+ * @return NULL.
+ */
+void* run_simulation_job(void* arg)
+{
+    // Play on a copy on this thread's stack: the counters and generator are
+    // written every game, and the shared array is written back only once.
+    SimulationJob job = *(SimulationJob*)arg;
+    if (job.strategy_x == STRATEGY_MCTS || job.strategy_o == STRATEGY_MCTS)
+    {
+        job.mcts_pool = malloc(MCTS_POOL_SIZE * sizeof(MctsNode));
+        if (job.mcts_pool == NULL)
+            return NULL;
+    }
+    for (long long i = 0; i < job.games; i++)
+    {
+        char first = ((job.first_game + i) % 2 == 0) ? PLAYER1 : PLAYER2; // Alternate who starts.
+        char winner = simulate_game(job.strategy_x, job.strategy_o, first, &job);
+        if (winner == PLAYER1)
+            job.x_wins++;
+        else if (winner == PLAYER2)
+            job.o_wins++;
+        else
+            job.draws++;
+    }
+    free(job.mcts_pool);
+    job.mcts_pool = NULL;
+    *(SimulationJob*)arg = job;
+    return NULL;
+}
+/**
+ * @brief Returns the number of online CPU cores.
+ */
+int get_thread_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long cores = info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (cores < 1) ? 1 : (int)cores;
+}
+/**
+ * @brief Looks up a strategy by name.
+ * @param name "random", "rule" or "minimax".
+ * @return The Strategy, or -1 if the name is unknown.
+ */
+int parse_strategy(const char* name)
+{
+    for (int i = 0; i < STRATEGY_COUNT; i++)
+    {
+        if (strcmp(name, strategy_names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+/**
+ * @brief Runs the headless AI vs AI simulator and prints win/draw rates and throughput.
+ * Usage: --simulate <X strategy> <O strategy> [games] [threads] [seed]
+ * @param argc Argument count from main.
+ * @param argv Argument values from main.
+ * @return Process exit code.
+ */
+int run_simulation(int argc, char* argv[])
+{
+    int strategy_x = (argc > 2) ? parse_strategy(argv[2]) : -1;
+    int strategy_o = (argc > 3) ? parse_strategy(argv[3]) : -1;
+    long long games = (argc > 4) ? atoll(argv[4]) : 1000000;
+    int thread_count = (argc > 5) ? atoi(argv[5]) : get_thread_count();
+    uint64_t seed = (argc > 6) ? strtoull(argv[6], NULL, 10) : random_entropy();
+    if (strategy_x < 0 || strategy_o < 0 || games < 1 || thread_count < 1)
+    {
+        printf("Usage: %s --simulate <X strategy> <O strategy> [games] [threads] [seed]\n", argv[0]);
+        printf("Strategies: random, rule, minimax, mcts\n");
+        return 1;
+    }
+    if (thread_count > MAX_SIMULATION_THREADS)
+        thread_count = MAX_SIMULATION_THREADS;
+
+    SimulationJob jobs[MAX_SIMULATION_THREADS] = {0};
+    pthread_t threads[MAX_SIMULATION_THREADS];
+    long long first_game = 0;
+    for (int t = 0; t < thread_count; t++)
+    {
+        jobs[t].strategy_x = strategy_x;
+        jobs[t].strategy_o = strategy_o;
+        jobs[t].games = games / thread_count + (t < games % thread_count);
+        jobs[t].first_game = first_game;
+        first_game += jobs[t].games;
+        // Independent stream per thread: the seed jumped ahead t times.
+        random_seed_stream(&jobs[t].rng, seed, (unsigned)t);
+    }
+
+    double start = now_seconds();
+    for (int t = 0; t < thread_count; t++)
+    {
+        if (pthread_create(&threads[t], NULL, run_simulation_job, &jobs[t]) != 0)
+        {
+            printf("Failed to start thread %d.\n", t);
+            return 1;
+        }
+    }
+    long long x_wins = 0, o_wins = 0, draws = 0;
+    for (int t = 0; t < thread_count; t++)
+    {
+        pthread_join(threads[t], NULL);
+        x_wins += jobs[t].x_wins;
+        o_wins += jobs[t].o_wins;
+        draws += jobs[t].draws;
+    }
+    double seconds = now_seconds() - start;
+
+    if (x_wins + o_wins + draws != games)
+    {
+        printf("Out of memory for the MCTS node pools.\n");
+        return 1;
+    }
+    printf("%lld games: %s (X) vs %s (O), %d threads, starting player alternates\n", games, strategy_names[strategy_x],
+           strategy_names[strategy_o], thread_count);
+    printf("X wins: %6.2f%%\n", 100.0 * x_wins / games);
+    printf("O wins: %6.2f%%\n", 100.0 * o_wins / games);
+    printf("Draws : %6.2f%%\n", 100.0 * draws / games);
+    printf("Time  : %.3f s (%.0f games/s, %.0f games/s per thread)\n", seconds, games / seconds,
+           games / seconds / thread_count);
+    return 0;
+}
+/**
+ * @brief Prompts for the per-move budget of the MCTS difficulty.
+ */
+void get_mcts_settings()
+{
+    int cores = get_thread_count();
+    printf("\nMCTS setup\n");
+    mcts_settings.threads = get_bounded_number("Search threads", 1, (cores < MAX_MCTS_THREADS) ? cores : MAX_MCTS_THREADS);
+    printf("01. Fixed number of rollouts per move\n");
+    printf("02. Fixed thinking time per move\n");
+    if (get_bounded_number("Budget type", 1, 2) == 1)
+    {
+        mcts_settings.rollouts = get_bounded_number("Rollouts per move", 100, 10000000);
+        mcts_settings.time_budget_ms = 0;
+    }
+    else
+    {
+        mcts_settings.rollouts = 0;
+        mcts_settings.time_budget_ms = get_bounded_number("Thinking time in ms", 1, 60000);
+    }
+}
+/**
+ * @brief Returns monotonic time in seconds, for deadlines and durations.
+ * Unlike the wall clock it never jumps when the system time is set.
+ */
+double now_seconds()
+{
+    struct timespec now;
+#ifdef _WIN32
+    timespec_get(&now, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+/**
+ * @brief Plays uniformly random moves until the game ends.
+ * @param board Position to start from (game not over).
+ * @param player The side to move.
+ * @param rng Generator of the calling thread.
+ * @return The winner ('X' or 'O'), or EMPTY_CELL for a draw.
+ */
+char random_playout(Board board, char player, Random* rng)
+{
+    while (1)
+    {
+        uint16_t empty = empty_cells(board);
+        int skip = (int)random_below(rng, __builtin_popcount(empty));
+        while (skip--)
+            empty &= empty - 1;
+        place_mark(&board, __builtin_ctz(empty), player);
+        if (check_win(board, player))
+            return player;
+        if (check_draw(board))
+            return EMPTY_CELL;
+        player = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+}
+/**
+ * @brief UCT value of a child: average score plus exploration bonus.
+ * @param score The child's score (2 per win, 1 per draw).
+ * @param visits The child's visits; unvisited children come first.
+ * @param log_parent_visits Natural log of the parent's visits.
+ * @return The UCT value.
+ */
+double mcts_uct(uint32_t score, uint32_t visits, double log_parent_visits)
+{
+    if (visits == 0)
+        return HUGE_VAL;
+    return score / (2.0 * visits) + MCTS_EXPLORATION * sqrt(log_parent_visits / visits);
+}
+/**
+ * @brief Picks the child with the highest UCT value.
+ * @param pool The node pool.
+ * @param node Fully expanded node with at least one child.
+ * @return Index of the selected child.
+ */
+int mcts_select_child(const MctsNode* pool, int node)
+{
+    double log_visits = log((double)pool[node].visits);
+    double best_value = -1;
+    int best_child = pool[node].first_child;
+    for (int child = pool[node].first_child; child >= 0; child = pool[child].next_sibling)
+    {
+        double value = mcts_uct(pool[child].score, pool[child].visits, log_visits);
+        if (value > best_value)
+        {
+            best_value = value;
+            best_child = child;
+        }
+    }
+    return best_child;
+}
+/**
+ * @brief Grows one search tree: selection, expansion, random playout and backpropagation,
+ * repeated until the rollout or time budget is used up. When the pool is full, the tree
+ * stops growing and playouts start from the selected leaf.
+ * @param worker Search input; receives the rollout count and root move visits.
+ */
+void mcts_run(MctsWorker* worker)
+{
+    MctsNode* pool = worker->pool;
+    char opponent = (worker->player == PLAYER1) ? PLAYER2 : PLAYER1;
+    pool[0] = (MctsNode){.board = worker->root, .parent = -1, .first_child = -1, .next_sibling = -1,
+                         .untried = empty_cells(worker->root), .move = -1, .mover = opponent};
+    int used = 1;
+
+    for (worker->rollouts = 0; worker->rollout_budget == 0 || worker->rollouts < worker->rollout_budget; worker->rollouts++)
+    {
+        if ((worker->rollouts & 63) == 0 && worker->deadline > 0 && now_seconds() > worker->deadline)
+            break;
+
+        // 1. Selection: descend through fully expanded nodes.
+        int node = 0;
+        while (pool[node].untried == 0 && pool[node].first_child >= 0)
+            node = mcts_select_child(pool, node);
+
+        // 2. Expansion: add one random untried move.
+        if (pool[node].untried && used < MCTS_POOL_SIZE)
+        {
+            uint16_t untried = pool[node].untried;
+            int skip = (int)random_below(&worker->rng, __builtin_popcount(untried));
+            while (skip--)
+                untried &= untried - 1;
+            int move = __builtin_ctz(untried);
+            char mover = (pool[node].mover == PLAYER1) ? PLAYER2 : PLAYER1;
+
+            MctsNode* child = &pool[used];
+            *child = (MctsNode){.board = pool[node].board, .parent = node, .first_child = -1,
+                                .next_sibling = pool[node].first_child, .move = move, .mover = mover};
+            place_mark(&child->board, move, mover);
+            child->untried = (check_win(child->board, mover) || check_draw(child->board)) ? 0 : empty_cells(child->board);
+            pool[node].untried &= ~(1u << move);
+            pool[node].first_child = used;
+            node = used++;
+        }
+
+        // 3. Simulation: finished positions score directly, others get a random playout.
+        const MctsNode* leaf = &pool[node];
+        char winner;
+        if (check_win(leaf->board, leaf->mover))
+            winner = leaf->mover;
+        else if (check_draw(leaf->board))
+            winner = EMPTY_CELL;
+        else
+            winner = random_playout(leaf->board, (leaf->mover == PLAYER1) ? PLAYER2 : PLAYER1, &worker->rng);
+
+        // 4. Backpropagation.
+        for (; node >= 0; node = pool[node].parent)
+        {
+            pool[node].visits++;
+            pool[node].score += (winner == pool[node].mover) ? 2 : (winner == EMPTY_CELL) ? 1 : 0;
+        }
+    }
+
+    memset(worker->root_visits, 0, sizeof(worker->root_visits));
+    for (int child = pool[0].first_child; child >= 0; child = pool[child].next_sibling)
+        worker->root_visits[pool[child].move] = pool[child].visits;
+}
+/**
+ * @brief MCTS thread routine.
+ * @param arg Pointer to the thread's MctsWorker.
+ * @return NULL.
+ */
+void* mcts_thread(void* arg)
+{
+    mcts_run(arg);
+    return NULL;
+}
+/**
+ * @brief Chooses a move with root-parallel MCTS: every thread grows its own tree from the
+ * same position and the root move visit counts are summed. No locks are shared.
+ * @param board The current bitboard (game not over).
+ * @param player The side to move.
+ * @param settings Thread count and rollout/time budget.
+ * @param pools settings->threads pools of MCTS_POOL_SIZE nodes, one after another.
+ * @param rng Generator used to seed the threads.
+ * @param stats Stores the total number of rollouts, the search time and the threads that ran.
+ * @return Cell index of the most visited root move.
+ */
+int mcts_best_cell(Board board, char player, const MctsSettings* settings, MctsNode* pools, Random* rng,
+                   MctsStats* stats)
+{
+    MctsWorker workers[MAX_MCTS_THREADS];
+    pthread_t threads[MAX_MCTS_THREADS];
+    int thread_count = settings->threads;
+    double start = now_seconds();
+    for (int t = 0; t < thread_count; t++)
+    {
+        workers[t].root = board;
+        workers[t].player = player;
+        workers[t].rollout_budget = settings->rollouts ? (settings->rollouts + thread_count - 1) / thread_count : 0;
+        workers[t].deadline = settings->time_budget_ms ? start + settings->time_budget_ms / 1000.0 : 0;
+        random_seed(&workers[t].rng, random_next(rng));
+        workers[t].pool = pools + (size_t)t * MCTS_POOL_SIZE;
+    }
+    // Thread 0 runs on the calling thread.
+    int started = 1;
+    for (; started < thread_count; started++)
+    {
+        if (pthread_create(&threads[started], NULL, mcts_thread, &workers[started]) != 0)
+            break;
+    }
+    mcts_run(&workers[0]);
+
+    uint32_t visits[CELL_COUNT] = {0};
+    stats->rollouts = 0;
+    for (int t = 0; t < started; t++)
+    {
+        if (t > 0)
+            pthread_join(threads[t], NULL);
+        stats->rollouts += workers[t].rollouts;
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            visits[cell] += workers[t].root_visits[cell];
+    }
+    stats->seconds = now_seconds() - start;
+    stats->threads = started;
+
+    int best_cell = __builtin_ctz(empty_cells(board));
+    for (int cell = 0; cell < CELL_COUNT; cell++)
+    {
+        if (visits[cell] > visits[best_cell])
+            best_cell = cell;
+    }
+    return best_cell;
+}
+/**
+ * @brief Tells whether the game ended with the move on a cell.
+ * @param board The m,n,k board after the move.
+ * @param cell Cell index of the move, -1 for none.
+ * @return The winner, EMPTY_CELL for a draw, or 0 while the game goes on.
+ */
+char mnk_result(const MnkBoard* board, int cell)
+{
+    if (cell >= 0 && mnk_is_winning_move(board, cell))
+        return board->cells[cell];
+    if (board->move_count == board->rows * board->cols)
+        return EMPTY_CELL;
+    return 0;
+}
+/**
+ * @brief Plays random moves near the existing marks for up to MNK_MCTS_PLAYOUT_PLIES plies.
+ * An unfinished game goes to the side the window evaluation favours.
+ * @param board Position to start from (game not over); overwritten.
+ * @param player The side to move.
+ * @param rng Generator of the calling thread.
+ * @return The winner ('X' or 'O'), or EMPTY_CELL for a draw.
+ */
+char mnk_random_playout(MnkBoard* board, char player, Random* rng)
+{
+    int cell_count = board->rows * board->cols;
+    for (int ply = 0; ply < MNK_MCTS_PLAYOUT_PLIES; ply++)
+    {
+        // A few random probes find a candidate on most boards; otherwise scan from a random cell.
+        int cell = -1;
+        int start = (int)random_below(rng, cell_count);
+        for (int probe = 0; probe < 8 && cell < 0; probe++)
+        {
+            int c = (probe == 0) ? start : (int)random_below(rng, cell_count);
+            if (board->cells[c] == EMPTY_CELL && (board->neighbours[c] || board->move_count == 0))
+                cell = c;
+        }
+        for (int i = 1; i < cell_count && cell < 0; i++)
+        {
+            int c = (start + i) % cell_count;
+            if (board->cells[c] == EMPTY_CELL && (board->neighbours[c] || board->move_count == 0))
+                cell = c;
+        }
+        if (cell < 0)
+            return EMPTY_CELL;
+
+        mnk_set_cell(board, cell, player);
+        char winner = mnk_result(board, cell);
+        if (winner)
+            return winner;
+        player = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+    return (board->evaluation > 0) ? PLAYER1 : (board->evaluation < 0) ? PLAYER2 : EMPTY_CELL;
+}
+/**
+ * @brief Picks the child with the highest UCT value.
+ * @param pool The node pool.
+ * @param node Expanded node with at least one child.
+ * @return Index of the selected child.
+ */
+int mnk_mcts_select_child(const MnkMctsNode* pool, int node)
+{
+    double log_visits = log((double)pool[node].visits);
+    double best_value = -1;
+    int best_child = pool[node].first_child;
+    for (int child = pool[node].first_child; child >= 0; child = pool[child].next_sibling)
+    {
+        double value = mcts_uct(pool[child].score, pool[child].visits, log_visits);
+        if (value > best_value)
+        {
+            best_value = value;
+            best_child = child;
+        }
+    }
+    return best_child;
+}
+/**
+ * @brief Grows one m,n,k search tree until the rollout or time budget is used up.
+ * Unlike the 3x3 tree, a leaf lists all its candidate moves at once (best first, so
+ * unvisited children are tried in that order), and only after MNK_MCTS_EXPAND_VISITS
+ * visits: listing candidates costs more than a playout. When the pool is full, the
+ * tree stops growing and playouts start from the selected leaf.
+ * @param worker Search input; receives the rollout count and root move visits.
+ */
+void mnk_mcts_run(MnkMctsWorker* worker)
+{
+    MnkMctsNode* pool = worker->pool;
+    MnkBoard* board = &worker->board;
+    int moves[MNK_MAX_CELLS];
+    pool[0] = (MnkMctsNode){.parent = -1, .first_child = -1, .next_sibling = -1, .move = -1,
+                            .mover = (worker->player == PLAYER1) ? PLAYER2 : PLAYER1};
+    int used = 1;
+
+    for (worker->rollouts = 0; worker->rollout_budget == 0 || worker->rollouts < worker->rollout_budget; worker->rollouts++)
+    {
+        if ((worker->rollouts & 63) == 0 && worker->deadline > 0 && now_seconds() > worker->deadline)
+            break;
+
+        // 1. Selection: descend through expanded nodes, replaying their moves.
+        *board = *worker->root;
+        int node = 0;
+        while (pool[node].expanded && pool[node].first_child >= 0)
+        {
+            node = mnk_mcts_select_child(pool, node);
+            mnk_set_cell(board, pool[node].move, pool[node].mover);
+        }
+        char winner = mnk_result(board, pool[node].move);
+
+        // 2. Expansion: add every candidate move and continue with the best one.
+        if (!winner && (node == 0 || pool[node].visits >= MNK_MCTS_EXPAND_VISITS) && used + MNK_MAX_BRANCH <= MCTS_POOL_SIZE)
+        {
+            char mover = (pool[node].mover == PLAYER1) ? PLAYER2 : PLAYER1;
+            int count = mnk_generate_moves(board, mover, -1, moves);
+            for (int i = count - 1; i >= 0; i--) // Prepending leaves the best candidate first.
+            {
+                pool[used] = (MnkMctsNode){.parent = node, .first_child = -1, .next_sibling = pool[node].first_child,
+                                           .move = (int16_t)moves[i], .mover = mover};
+                pool[node].first_child = used++;
+            }
+            pool[node].expanded = 1;
+            node = pool[node].first_child;
+            mnk_set_cell(board, pool[node].move, mover);
+            winner = mnk_result(board, pool[node].move);
+        }
+
+        // 3. Simulation: finished positions score directly, others get a random playout.
+        if (!winner)
+            winner = mnk_random_playout(board, (pool[node].mover == PLAYER1) ? PLAYER2 : PLAYER1, &worker->rng);
+
+        // 4. Backpropagation.
+        for (; node >= 0; node = pool[node].parent)
+        {
+            pool[node].visits++;
+            pool[node].score += (winner == pool[node].mover) ? 2 : (winner == EMPTY_CELL) ? 1 : 0;
+        }
+    }
+
+    memset(worker->root_visits, 0, sizeof(worker->root_visits));
+    for (int child = pool[0].first_child; child >= 0; child = pool[child].next_sibling)
+        worker->root_visits[pool[child].move] = pool[child].visits;
+}
+/**
+ * @brief m,n,k MCTS thread routine.
+ * @param arg Pointer to the thread's MnkMctsWorker.
+ * @return NULL.
+ */
+void* mnk_mcts_thread(void* arg)
+{
+    mnk_mcts_run(arg);
+    return NULL;
+}
+/**
+ * @brief Chooses an m,n,k move with root-parallel MCTS, like mcts_best_cell().
+ * @param board The m,n,k board (game not over).
+ * @param player The side to move.
+ * @param settings Thread count and rollout/time budget.
+ * @param pools settings->threads pools of MCTS_POOL_SIZE nodes, one after another.
+ * @param rng Generator used to seed the threads.
+ * @param stats Stores the total number of rollouts, the search time and the threads that ran.
+ * @return Cell index of the most visited root move.
+ */
+int mnk_mcts_best_cell(const MnkBoard* board, char player, const MctsSettings* settings, MnkMctsNode* pools,
+                       Random* rng, MctsStats* stats)
+{
+    static MnkMctsWorker workers[MAX_MCTS_THREADS]; // Large; kept off the stack.
+    pthread_t threads[MAX_MCTS_THREADS];
+    int thread_count = settings->threads;
+    double start = now_seconds();
+    for (int t = 0; t < thread_count; t++)
+    {
+        workers[t].root = board;
+        workers[t].player = player;
+        workers[t].rollout_budget = settings->rollouts ? (settings->rollouts + thread_count - 1) / thread_count : 0;
+        workers[t].deadline = settings->time_budget_ms ? start + settings->time_budget_ms / 1000.0 : 0;
+        random_seed(&workers[t].rng, random_next(rng));
+        workers[t].pool = pools + (size_t)t * MCTS_POOL_SIZE;
+    }
+    // Thread 0 runs on the calling thread.
+    int started = 1;
+    for (; started < thread_count; started++)
+    {
+        if (pthread_create(&threads[started], NULL, mnk_mcts_thread, &workers[started]) != 0)
+            break;
+    }
+    mnk_mcts_run(&workers[0]);
+
+    static uint32_t visits[MNK_MAX_CELLS];
+    memset(visits, 0, sizeof(visits));
+    stats->rollouts = 0;
+    for (int t = 0; t < started; t++)
+    {
+        if (t > 0)
+            pthread_join(threads[t], NULL);
+        stats->rollouts += workers[t].rollouts;
+        for (int cell = 0; cell < MNK_MAX_CELLS; cell++)
+            visits[cell] += workers[t].root_visits[cell];
+    }
+    stats->seconds = now_seconds() - start;
+    stats->threads = started;
+
+    // Without a single finished rollout, the best-ordered candidate is played.
+    int moves[MNK_MAX_CELLS];
+    workers[0].board = *board;
+    mnk_generate_moves(&workers[0].board, player, -1, moves);
+    int best_cell = moves[0];
+    for (int cell = 0; cell < MNK_MAX_CELLS; cell++)
+    {
+        if (visits[cell] > visits[best_cell])
+            best_cell = cell;
+    }
+    return best_cell;
+}
+/**
+ * @brief Measures MCTS rollouts per second per thread from the empty board.
+ * With a board size, the m,n,k search is measured instead of the 3x3 one.
+ * Usage: --mcts-bench [rollouts] [threads] [size] [win length]
+ * @param argc Argument count from main.
+ * @param argv Argument values from main.
+ * @return Process exit code.
+ */
+int run_mcts_benchmark(int argc, char* argv[])
+{
+    MctsSettings settings = {.threads = get_thread_count(), .rollouts = 1000000, .time_budget_ms = 0};
+    MnkSettings mnk = {.rows = 0, .cols = 0, .win_length = 5, .time_budget_ms = 0, .threads = 0};
+    if (argc > 2)
+        settings.rollouts = atoll(argv[2]);
+    if (argc > 3)
+        settings.threads = atoi(argv[3]);
+    if (argc > 4)
+        mnk.rows = mnk.cols = atoi(argv[4]);
+    if (argc > 5)
+        mnk.win_length = atoi(argv[5]);
+    if (settings.rollouts < 1 || settings.threads < 1 ||
+        (argc > 4 && (mnk.rows < MNK_MIN_SIZE || mnk.rows > MNK_MAX_SIZE || mnk.win_length < MNK_MIN_SIZE ||
+                      mnk.win_length > MNK_MAX_WIN || mnk.win_length > mnk.rows)))
+    {
+        printf("Usage: %s --mcts-bench [rollouts] [threads] [size] [win length]\n", argv[0]);
+        return 1;
+    }
+    if (settings.threads > MAX_MCTS_THREADS)
+        settings.threads = MAX_MCTS_THREADS;
+
+    MctsStats stats;
+    int cell;
+    int cols = BOARD_SIZE;
+    if (argc > 4)
+    {
+        static MnkBoard board; // Large; kept off the stack.
+        init_zobrist_keys();
+        mnk_init_board(&board, &mnk);
+        cell = mnk_mcts_best_cell(&board, PLAYER1, &settings, &mnk_mcts_pools[0][0], &ai_rng, &stats);
+        cols = mnk.cols;
+    }
+    else
+    {
+        Board empty_board = {.player1 = 0, .player2 = 0};
+        cell = mcts_best_cell(empty_board, PLAYER1, &settings, &mcts_pools[0][0], &ai_rng, &stats);
+    }
+    printf("%lld rollouts on %d threads in %.3f s\n", stats.rollouts, stats.threads, stats.seconds);
+    printf("%.0f rollouts/s total, %.0f rollouts/s per thread\n", stats.rollouts / stats.seconds,
+           stats.rollouts / stats.seconds / stats.threads);
+    printf("Chosen opening move: (%d, %d)\n", cell / cols + 1, cell % cols + 1);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,590 @@
+/*
+ * Module Name: Input (buffered, non-blocking keyboard and line input)
+ * Date: 19th October 2026
+ *
+ * Shared by every interactive program in place of scanf() and the
+ * getchar() loops that flushed the rest of a line. Those block until a
+ * whole line arrives and leave a program unable to redraw meanwhile.
+ * Some of them also spin forever once stdin reaches its end.
+ *
+ * - Bytes are read with one read() per poll() wake-up into a buffer. A
+ *   program can wait for a key with a timeout and keep drawing.
+ * - In raw mode (a terminal only) the terminal neither echoes nor waits for
+ *   Enter. A small line editor takes over: it echoes and handles
+ *   Backspace (UTF-8 aware), Ctrl+U and Ctrl+D. It can mask a password with
+ *   '*' and redraw its prompt and the half-typed line. The terminal is
+ *   restored at exit and on SIGINT, SIGTERM and SIGHUP.
+ * - A line is parsed in one pass by the typed parsers. A bad line is never
+ *   scanned again and cannot leave anything behind for the next read.
+ * - The end of input is reported, never mistaken for a key.
+ *
+ * Usage:
+ *     Input* input = input_stdin();
+ *     int choice;
+ *     int status = input_int(input, &choice);  // 1 number, 0 invalid line, -1 end of input
+ *
+ *     input_raw(input, 1);                     // keys without Enter, e.g. for a live display
+ *     int key = input_key(input, 100);         // a byte, INPUT_NONE after 100 ms, or INPUT_EOF
+ *     input_line(input, line, sizeof(line), 200, redraw, context); // redraw() runs while waiting
+ */
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+    #include <conio.h>   // For _kbhit(), _getch()
+    #include <io.h>      // For _isatty(), _read()
+    #include <windows.h> // For Sleep(), GetTickCount()
+#else
+    #include <poll.h>
+    #include <termios.h> // For raw mode
+    #include <unistd.h>  // For read(), isatty()
+#endif
+/*================= Constant =================*/
+#define INPUT_BUFFER_SIZE 4096
+#define INPUT_LINE_LENGTH 256 // Longest line input_int() and friends accept.
+#define INPUT_NONE (-2)       // input_key(): nothing typed before the timeout.
+#define INPUT_EOF (-1)        // input_key(): end of input.
+#define INPUT_KEY_ESCAPE 0x1B
+#define INPUT_KEY_KILL_LINE 0x15 // Ctrl+U
+#define INPUT_KEY_END 0x04       // Ctrl+D
+/*================= Type =================*/
+typedef enum
+{
+    INPUT_END = -1,  // End of input and no partial line.
+    INPUT_PENDING,   // The line is not complete yet.
+    INPUT_READY      // A whole line is in the caller's buffer.
+} InputStatus;
+typedef struct
+{
+    int fd;
+    int terminal;  // fd is a terminal (console on Windows).
+    int raw;       // Raw mode: the line editor echoes and edits.
+    int at_end;    // read() reported the end of input.
+    int mask;      // Echo '*' for each character, for passwords.
+    int escape;    // Skipping an escape sequence (arrow keys): 1 after ESC, 2 inside.
+    size_t start, end; // Unread bytes are buffer[start, end).
+    char* line;        // Buffer of the line being edited.
+    size_t line_length;
+    unsigned char buffer[INPUT_BUFFER_SIZE];
+#ifndef _WIN32
+    int saved_valid;
+    struct termios saved; // Terminal settings before raw mode.
+#endif
+} Input;
+/*================= Function Definition =================*/
+/**
+ * @brief The input of the process (stdin), set up on first use.
+ */
+static inline Input* input_stdin(void)
+{
+    static Input input;
+    static int ready = 0;
+    if (!ready)
+    {
+#ifdef _WIN32
+        input.fd = _fileno(stdin);
+        input.terminal = _isatty(input.fd);
+        input.raw = input.terminal; // _getch() never echoes: the line editor always does
+#else
+        input.fd = STDIN_FILENO;
+        input.terminal = isatty(input.fd);
+#endif
+        ready = 1;
+    }
+    return &input;
+}
+#ifndef _WIN32
+static inline void input_restore_terminal(void)
+{
+    Input* input = input_stdin();
+    if (input->raw)
+    {
+        tcsetattr(input->fd, TCSANOW, &input->saved);
+    }
+}
+static inline void input_restore_on_signal(int signal_number)
+{
+    input_restore_terminal(); // tcsetattr() is async-signal-safe
+    signal(signal_number, SIG_DFL);
+    raise(signal_number);
+}
+#endif
+/**
+ * @brief Turns raw mode on or off. Raw mode needs a terminal; Ctrl+C still works.
+ * @param input The input.
+ * @param on 1 for raw mode, 0 to restore the terminal.
+ * @return 1 if raw mode is now on.
+ */
+static inline int input_raw(Input* input, int on)
+{
+#ifdef _WIN32
+    (void)on;
+    return input->raw;
+#else
+    if (!input->terminal || on == input->raw)
+    {
+        return input->raw;
+    }
+    if (!on)
+    {
+        tcsetattr(input->fd, TCSANOW, &input->saved);
+        input->raw = 0;
+        return 0;
+    }
+    if (!input->saved_valid)
+    {
+        if (tcgetattr(input->fd, &input->saved) != 0)
+        {
+            return 0;
+        }
+        input->saved_valid = 1;
+        atexit(input_restore_terminal);
+        int signals[] = {SIGINT, SIGTERM, SIGHUP};
+        for (int i = 0; i < 3; i++)
+        {
+            // Leave handlers the program installed itself (or SIG_IGN) alone
+            void (*previous)(int) = signal(signals[i], input_restore_on_signal);
+            if (previous != SIG_DFL && previous != SIG_ERR)
+            {
+                signal(signals[i], previous);
+            }
+        }
+    }
+    struct termios settings = input->saved;
+    settings.c_lflag &= ~(ICANON | ECHO); // ISIG stays: Ctrl+C still interrupts
+    settings.c_cc[VMIN] = 1;
+    settings.c_cc[VTIME] = 0;
+    if (tcsetattr(input->fd, TCSANOW, &settings) != 0)
+    {
+        return 0;
+    }
+    input->raw = 1;
+    return 1;
+#endif
+}
+/**
+ * @brief Reads once into the buffer; call only when input is waiting.
+ */
+static inline void input_fill(Input* input)
+{
+    if (input->start == input->end)
+    {
+        input->start = input->end = 0;
+    }
+    size_t room = INPUT_BUFFER_SIZE - input->end;
+    if (room == 0)
+    {
+        return;
+    }
+#ifdef _WIN32
+    if (input->terminal)
+    {
+        while (room > 0 && _kbhit())
+        {
+            int c = _getch();
+            if (c == 0 || c == 0xE0)
+            {
+                _getch(); // Second half of a function or arrow key
+                continue;
+            }
+            input->buffer[input->end++] = (unsigned char)((c == '\r') ? '\n' : c);
+            room--;
+        }
+        return;
+    }
+    int result = _read(input->fd, input->buffer + input->end, (unsigned)room);
+#else
+    ssize_t result = read(input->fd, input->buffer + input->end, room);
+#endif
+    if (result > 0)
+    {
+        input->end += result;
+    }
+    else if (result == 0 || (errno != EINTR && errno != EAGAIN))
+    {
+        input->at_end = 1;
+    }
+}
+/**
+ * @brief Waits until input is buffered or has ended. Pending output is flushed first.
+ * @param input The input.
+ * @param timeout_ms Longest wait; -1 waits for as long as it takes.
+ * @return 1 if a byte or the end of input can be taken, 0 after the timeout or a signal.
+ */
+static inline int input_wait(Input* input, int timeout_ms)
+{
+    if (input->start < input->end || input->at_end)
+    {
+        return 1;
+    }
+    fflush(stdout);
+#ifdef _WIN32
+    if (input->terminal)
+    {
+        DWORD begin = GetTickCount();
+        while (!_kbhit())
+        {
+            if (timeout_ms >= 0 && GetTickCount() - begin >= (DWORD)timeout_ms)
+            {
+                return 0;
+            }
+            Sleep(10);
+        }
+    }
+    // Pipes and files have no portable readiness check: read them when asked
+#else
+    struct pollfd watch = {.fd = input->fd, .events = POLLIN};
+    if (poll(&watch, 1, timeout_ms) <= 0)
+    {
+        return 0; // Timeout, or a signal the caller may want to see
+    }
+#endif
+    input_fill(input);
+    return input->start < input->end || input->at_end;
+}
+/**
+ * @brief Takes one byte of input.
+ * @param input The input.
+ * @param timeout_ms Longest wait; 0 only checks, -1 waits for as long as it takes.
+ * @return The byte (0 - 255), INPUT_NONE if nothing came in time, or INPUT_EOF.
+ */
+static inline int input_key(Input* input, int timeout_ms)
+{
+    if (!input_wait(input, timeout_ms))
+    {
+        return INPUT_NONE;
+    }
+    if (input->start == input->end)
+    {
+        return INPUT_EOF;
+    }
+    return input->buffer[input->start++];
+}
+static inline void input_echo(const char* text, size_t length)
+{
+    fwrite(text, 1, length, stdout);
+}
+/**
+ * @brief Erases the last character of the line being edited.
+ */
+static inline void input_erase_character(Input* input)
+{
+    if (input->line_length == 0)
+    {
+        return;
+    }
+    // Drop UTF-8 continuation bytes (10xxxxxx), then the lead byte
+    while (input->line_length > 1 && ((unsigned char)input->line[input->line_length - 1] & 0xC0) == 0x80)
+    {
+        input->line_length--;
+    }
+    input->line_length--;
+    input_echo("\b \b", 3);
+}
+/**
+ * @brief Edits a line with the buffered bytes, never waiting for more.
+ *
+ * Keep passing the same buffer until the line is ready. A line longer than
+ * size - 1 bytes is cut; the rest, up to the newline, is dropped. The
+ * newline is not stored.
+ * @param input The input.
+ * @param line Buffer of the line.
+ * @param size Size of the buffer.
+ * @return INPUT_READY, INPUT_PENDING, or INPUT_END at the end of input.
+ */
+static inline InputStatus input_poll_line(Input* input, char* line, size_t size)
+{
+    if (input->line != line)
+    {
+        input->line = line; // A new line begins
+        input->line_length = 0;
+        input->escape = 0;
+    }
+    while (input->start < input->end)
+    {
+        unsigned char c = input->buffer[input->start++];
+        if (c == '\n' || (c == '\r' && input->raw))
+        {
+            if (input->raw)
+            {
+                input_echo("\n", 1);
+            }
+            // A line from a Windows text file ends in "\r\n"
+            if (input->line_length > 0 && line[input->line_length - 1] == '\r')
+            {
+                input->line_length--;
+            }
+            line[input->line_length] = '\0';
+            input->line = NULL;
+            return INPUT_READY;
+        }
+        if (!input->raw)
+        {
+            if (input->line_length + 1 < size)
+            {
+                line[input->line_length++] = (char)c;
+            }
+            continue;
+        }
+        if (input->escape)
+        {
+            // Skip ESC [ parameters final-byte: cursor keys are not supported
+            if (input->escape == 1 && (c == '[' || c == 'O'))
+            {
+                input->escape = 2;
+            }
+            else if (input->escape == 1 || (c >= 0x40 && c <= 0x7E))
+            {
+                input->escape = 0;
+            }
+            continue;
+        }
+        if (c == '\b' || c == 0x7F)
+        {
+            input_erase_character(input);
+        }
+        else if (c == INPUT_KEY_KILL_LINE)
+        {
+            while (input->line_length > 0)
+            {
+                input_erase_character(input);
+            }
+        }
+        else if (c == INPUT_KEY_END && input->line_length == 0)
+        {
+            input->at_end = 1; // Ctrl+D on an empty line ends the input, as in cooked mode
+            input->start = input->end;
+        }
+        else if (c == INPUT_KEY_ESCAPE)
+        {
+            input->escape = 1;
+        }
+        else if (c >= 0x20 && input->line_length + 1 < size)
+        {
+            line[input->line_length++] = (char)c;
+            if (!input->mask)
+            {
+                input_echo((const char*)&c, 1);
+            }
+            else if ((c & 0xC0) != 0x80)
+            {
+                input_echo("*", 1); // One star per character, not per byte
+            }
+        }
+    }
+    if (input->at_end)
+    {
+        input->line = NULL;
+        if (input->line_length > 0) // Last line without a newline
+        {
+            line[input->line_length] = '\0';
+            return INPUT_READY;
+        }
+        line[0] = '\0';
+        return INPUT_END;
+    }
+    return INPUT_PENDING;
+}
+/**
+ * @brief Reads a line, running a callback at an interval while the user types.
+ * @param input The input.
+ * @param line Stores the line without its newline.
+ * @param size Size of the buffer.
+ * @param interval_ms Time between two calls of idle.
+ * @param idle Called while waiting, e.g. to redraw; may be NULL.
+ * @param context Passed to idle.
+ * @return 1 if a line was read, 0 at the end of input.
+ */
+static inline int input_line(Input* input, char* line, size_t size, int interval_ms, void (*idle)(void*),
+                             void* context)
+{
+    input->line = NULL;
+    while (1)
+    {
+        InputStatus status = input_poll_line(input, line, size);
+        if (status != INPUT_PENDING)
+        {
+            fflush(stdout);
+            return status == INPUT_READY;
+        }
+        if (!input_wait(input, (idle != NULL) ? interval_ms : -1) && idle != NULL)
+        {
+            idle(context);
+        }
+    }
+}
+/**
+ * @brief Rewrites the terminal line: a prompt, then what has been typed of the line.
+ * Only raw mode knows the typed text; otherwise nothing is written.
+ * @param input The input.
+ * @param prompt The prompt to show.
+ */
+static inline void input_redraw(Input* input, const char* prompt)
+{
+    if (!input->raw)
+    {
+        return;
+    }
+    printf("\r\x1b[K%s", prompt);
+    if (input->line != NULL)
+    {
+        for (size_t i = 0; i < input->line_length; i++)
+        {
+            if (!input->mask)
+            {
+                putchar(input->line[i]);
+            }
+            else if (((unsigned char)input->line[i] & 0xC0) != 0x80)
+            {
+                putchar('*');
+            }
+        }
+    }
+    fflush(stdout);
+}
+/**
+ * @brief Parses a whole number at a cursor and moves the cursor past it.
+ * Leading blanks are skipped; the number must end at a blank or the end of the text.
+ * @param cursor Position in the text.
+ * @param value Stores the number.
+ * @return 1 on success, 0 if there is no number or it does not fit.
+ */
+static inline int input_scan_int64(const char** cursor, int64_t* value)
+{
+    const char* text = *cursor + strspn(*cursor, " \t");
+    int negative = (*text == '-');
+    if (*text == '-' || *text == '+')
+    {
+        text++;
+    }
+    if (*text < '0' || *text > '9')
+    {
+        return 0;
+    }
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    uint64_t magnitude = 0;
+    for (; *text >= '0' && *text <= '9'; text++)
+    {
+        unsigned digit = (unsigned)(*text - '0');
+        if (magnitude > (limit - digit) / 10)
+        {
+            return 0; // Overflow
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    if (*text != '\0' && *text != ' ' && *text != '\t')
+    {
+        return 0; // "12abc" is not a number
+    }
+    *value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    *cursor = text;
+    return 1;
+}
+/**
+ * @brief Checks that only blanks are left.
+ */
+static inline int input_at_line_end(const char* text)
+{
+    return text[strspn(text, " \t")] == '\0';
+}
+/**
+ * @brief Parses a line holding exactly one 64-bit integer.
+ * @return 1 on success, 0 otherwise.
+ */
+static inline int input_parse_int64(const char* text, int64_t* value)
+{
+    return input_scan_int64(&text, value) && input_at_line_end(text);
+}
+/**
+ * @brief Parses a line holding exactly one int.
+ * @return 1 on success, 0 otherwise.
+ */
+static inline int input_parse_int(const char* text, int* value)
+{
+    int64_t number;
+    if (!input_parse_int64(text, &number) || number < INT32_MIN || number > INT32_MAX)
+    {
+        return 0;
+    }
+    *value = (int)number;
+    return 1;
+}
+/**
+ * @brief Parses a line holding exactly `count` ints separated by blanks, e.g. "2 3".
+ * @return 1 on success, 0 otherwise.
+ */
+static inline int input_parse_ints(const char* text, int* values, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int64_t number;
+        if (!input_scan_int64(&text, &number) || number < INT32_MIN || number > INT32_MAX)
+        {
+            return 0;
+        }
+        values[i] = (int)number;
+    }
+    return input_at_line_end(text);
+}
+/**
+ * @brief Parses a line holding exactly one finite number, e.g. "-2.5" or "1e3".
+ * @return 1 on success, 0 otherwise.
+ */
+static inline int input_parse_double(const char* text, double* value)
+{
+    char* end;
+    double number = strtod(text, &end);
+    if (end == text || !input_at_line_end(end) || !isfinite(number))
+    {
+        return 0;
+    }
+    *value = number;
+    return 1;
+}
+/**
+ * @brief Reads a line holding one int.
+ * @return 1 on success, 0 if the line was not a number (it is consumed), -1 at the end of input.
+ */
+static inline int input_int(Input* input, int* value)
+{
+    char line[INPUT_LINE_LENGTH];
+    if (!input_line(input, line, sizeof(line), 0, NULL, NULL))
+    {
+        return -1;
+    }
+    return input_parse_int(line, value);
+}
+/**
+ * @brief Reads a line holding one 64-bit integer; returns like input_int().
+ */
+static inline int input_int64(Input* input, int64_t* value)
+{
+    char line[INPUT_LINE_LENGTH];
+    if (!input_line(input, line, sizeof(line), 0, NULL, NULL))
+    {
+        return -1;
+    }
+    return input_parse_int64(line, value);
+}
+/**
+ * @brief Reads a line holding one finite number; returns like input_int().
+ */
+static inline int input_double(Input* input, double* value)
+{
+    char line[INPUT_LINE_LENGTH];
+    if (!input_line(input, line, sizeof(line), 0, NULL, NULL))
+    {
+        return -1;
+    }
+    return input_parse_double(line, value);
+}
+
+#endif // INPUT_H
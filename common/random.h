@@ -0,0 +1,252 @@
+/*
+ * Module Name: Random (xoshiro256** generator)
+ * Date: 19th October 2026
+ *
+ * Shared by the Number Guessing Game, Progress Bar, Simple Calculator and
+ * TIC-TAC-TOE programs in place of rand(). rand() has one hidden state for
+ * the whole process, is slow and unsafe to share between threads, and
+ * rand() % n favours small numbers.
+ *
+ * A Random value is the whole generator (32 bytes). Give each thread its
+ * own, either explicitly or through random_local(), so no locks are needed.
+ * - Seeding is reproducible: random_seed() expands a 64-bit seed with
+ *   splitmix64.
+ * - random_seed_stream() gives stream i the same seed advanced by i jumps
+ *   of 2^128 draws. Parallel streams therefore never overlap.
+ * - Bounded draws use Lemire's multiply-shift method. It is unbiased and
+ *   needs a division only in the rare rejection case.
+ * - The random_fill*() functions keep the state in registers for bulk
+ *   output.
+ *
+ * Usage:
+ *     Random random;
+ *     random_seed(&random, 42);                            // or random_entropy()
+ *     int die = (int)random_below(&random, 6) + 1;          // 1..6, unbiased
+ *     double u = random_double(&random);                    // [0, 1)
+ *     int coin = (int)random_below(random_local(), 2);      // per-thread generator
+ */
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+/*================= Constant =================*/
+#if defined(_MSC_VER)
+    #define RANDOM_THREAD_LOCAL __declspec(thread)
+#else
+    #define RANDOM_THREAD_LOCAL _Thread_local
+#endif
+/*================= Type =================*/
+typedef struct
+{
+    uint64_t s[4]; // Never all zero.
+} Random;
+/*================= Function Definition =================*/
+/**
+ * @brief One splitmix64 step; turns consecutive seeds into unrelated numbers.
+ */
+static inline uint64_t random_splitmix(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+/**
+ * @brief Seeds a generator; the same seed always gives the same sequence.
+ */
+static inline void random_seed(Random* random, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        random->s[i] = random_splitmix(&seed); // splitmix64 never yields four zeros in a row
+    }
+}
+static inline uint64_t random_rotate(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+/**
+ * @brief Draws 64 random bits.
+ */
+static inline uint64_t random_next(Random* random)
+{
+    uint64_t* s = random->s;
+    uint64_t result = random_rotate(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = random_rotate(s[3], 45);
+    return result;
+}
+/**
+ * @brief Advances a generator by 2^128 draws.
+ */
+static inline void random_jump(Random* random)
+{
+    static const uint64_t jump[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL,
+                                     0x39ABDC4529B1661CULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (jump[i] & (1ULL << bit))
+            {
+                for (int k = 0; k < 4; k++)
+                {
+                    s[k] ^= random->s[k];
+                }
+            }
+            random_next(random);
+        }
+    }
+    for (int k = 0; k < 4; k++)
+    {
+        random->s[k] = s[k];
+    }
+}
+/**
+ * @brief Seeds stream `stream` of a seed: the seeded generator advanced by `stream` jumps.
+ *
+ * Threads that take streams 0, 1, 2, ... of one seed get reproducible
+ * sequences 2^128 draws apart.
+ */
+static inline void random_seed_stream(Random* random, uint64_t seed, unsigned stream)
+{
+    random_seed(random, seed);
+    for (unsigned i = 0; i < stream; i++)
+    {
+        random_jump(random);
+    }
+}
+/**
+ * @brief A seed that differs between runs and threads: clock, time and a stack address.
+ */
+static inline uint64_t random_entropy(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    uint64_t seed = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    seed ^= (uint64_t)(uintptr_t)&now << 16; // differs per thread, and per run with ASLR
+    seed ^= (uint64_t)clock() << 40;
+    return random_splitmix(&seed);
+}
+/**
+ * @brief The calling thread's own generator, seeded from random_entropy() on first use.
+ */
+static inline Random* random_local(void)
+{
+    static RANDOM_THREAD_LOCAL Random local;
+    static RANDOM_THREAD_LOCAL int seeded = 0;
+    if (!seeded)
+    {
+        random_seed(&local, random_entropy());
+        seeded = 1;
+    }
+    return &local;
+}
+/**
+ * @brief Full 64 x 64 -> 128-bit product.
+ * @return The high half; the low half goes to *low.
+ */
+static inline uint64_t random_multiply(uint64_t a, uint64_t b, uint64_t* low)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *low = (uint64_t)product;
+    return (uint64_t)(product >> 64);
+#else
+    uint64_t a_low = (uint32_t)a, a_high = a >> 32, b_low = (uint32_t)b, b_high = b >> 32;
+    uint64_t p0 = a_low * b_low, p1 = a_low * b_high, p2 = a_high * b_low, p3 = a_high * b_high;
+    uint64_t middle = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    *low = (middle << 32) | (uint32_t)p0;
+    return p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32);
+#endif
+}
+/**
+ * @brief Draws a number in [0, bound) without bias (Lemire's method).
+ * @param bound At least 1.
+ */
+static inline uint64_t random_below(Random* random, uint64_t bound)
+{
+    // x * bound / 2^64 maps 64 bits onto [0, bound). The low half tells when
+    // x fell into one of the (2^64 mod bound) values that would over-weight
+    // a result; only then is the threshold computed and x redrawn.
+    uint64_t low;
+    uint64_t high = random_multiply(random_next(random), bound, &low);
+    if (low < bound)
+    {
+        uint64_t threshold = (0 - bound) % bound;
+        while (low < threshold)
+        {
+            high = random_multiply(random_next(random), bound, &low);
+        }
+    }
+    return high;
+}
+/**
+ * @brief Draws a number in [low, high], both included; any int64_t range works.
+ */
+static inline int64_t random_between(Random* random, int64_t low, int64_t high)
+{
+    uint64_t span = (uint64_t)high - (uint64_t)low; // count - 1
+    uint64_t offset = (span == UINT64_MAX) ? random_next(random) : random_below(random, span + 1);
+    return (int64_t)((uint64_t)low + offset);
+}
+/**
+ * @brief Draws a double in [0, 1) with all 53 bits random.
+ */
+static inline double random_double(Random* random)
+{
+    return (double)(random_next(random) >> 11) * 0x1.0p-53;
+}
+/**
+ * @brief Fills an array with random 64-bit numbers.
+ */
+static inline void random_fill(Random* random, uint64_t* out, size_t count)
+{
+    Random local = *random; // lets the compiler keep the state in registers
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = random_next(&local);
+    }
+    *random = local;
+}
+/**
+ * @brief Fills an array with unbiased numbers in [0, bound), bound at least 1.
+ */
+static inline void random_fill_below(Random* random, uint32_t* out, size_t count, uint32_t bound)
+{
+    Random local = *random;
+    uint32_t threshold = (0 - bound) % bound;
+    for (size_t i = 0; i < count; i++)
+    {
+        // 32-bit Lemire: the top 32 bits of a draw times the bound
+        uint64_t product = (random_next(&local) >> 32) * bound;
+        while ((uint32_t)product < threshold)
+        {
+            product = (random_next(&local) >> 32) * bound;
+        }
+        out[i] = (uint32_t)(product >> 32);
+    }
+    *random = local;
+}
+/**
+ * @brief Fills an array with doubles in [0, 1).
+ */
+static inline void random_fill_double(Random* random, double* out, size_t count)
+{
+    Random local = *random;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = random_double(&local);
+    }
+    *random = local;
+}
+
+#endif // RANDOM_H
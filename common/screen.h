@@ -0,0 +1,485 @@
+/*
+ * Module Name: Screen (incremental terminal renderer)
+ * Date: 19th October 2026
+ *
+ * Shared by the Digital Clock, Progress Bar and TIC-TAC-TOE programs.
+ * A frame is composed into a back buffer, compared with the previous frame
+ * and only the changed cells are sent to the terminal, using ANSI cursor
+ * movement, in a single write. No shell is spawned to clear the screen.
+ * Only the part of the frame that fits the terminal is drawn, and a resized
+ * terminal (SIGWINCH) gets a full redraw. Text printed under the frame, such
+ * as prompts, can be reported with screen_note_text(); the frame is redrawn in
+ * full only once that text may have scrolled the terminal.
+ *
+ * Usage:
+ *     screen_init(&screen, rows, cols);
+ *     screen_begin_frame(&screen);
+ *     screen_printf(&screen, "Time: %s\n", text);
+ *     screen_present(&screen);
+ */
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <signal.h> // For sig_atomic_t and SIGWINCH
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+    #include <windows.h> // Console API for enabling ANSI sequences
+#else
+    #include <sys/ioctl.h> // For TIOCGWINSZ
+    #include <unistd.h>    // For write()
+#endif
+/*================= Constant =================*/
+#define SCREEN_TAB_WIDTH 8
+#define SCREEN_SHORT_GAP 4 // Unchanged cells worth rewriting instead of moving the cursor.
+#define SCREEN_BLANK ((uint32_t)' ')
+#define SCREEN_UNKNOWN ((uint32_t)0) // Cell content the terminal may not show.
+/*================= Type =================*/
+// One glyph per cell: the UTF-8 bytes of a character packed into 32 bits.
+typedef struct
+{
+    int rows;
+    int cols;
+    uint32_t* front; // What the terminal currently shows.
+    uint32_t* back;  // Frame being composed.
+    char* out;       // Escape sequences and glyphs of the next write.
+    size_t out_length;
+    int pen_row;     // Where the next composed character goes.
+    int pen_col;
+    int full_clear;  // Clear the whole terminal on the next present.
+    FILE* stream;    // Terminal to draw on (stdout unless changed).
+    int view_rows;   // Part of the frame that fits the terminal, 0 until measured.
+    int view_cols;
+    int resizes_seen; // Value of screen_resizes when the size was measured.
+    int cursor_row;   // Where the last present and the text noted since left the cursor.
+    int cursor_col;
+} Screen;
+/*================= Global Variable =================*/
+static volatile sig_atomic_t screen_resizes = 0; // Counts SIGWINCH signals.
+/*================= Function Definition =================*/
+#ifndef _WIN32
+static inline void screen_handle_resize(int signal_number)
+{
+    signal(signal_number, screen_handle_resize); // Stay installed where signal() resets handlers.
+    screen_resizes++;
+}
+#endif
+/**
+ * @brief Allocates the buffers of a screen. The first present redraws everything.
+ * @param screen The screen to set up.
+ * @param rows Largest frame height.
+ * @param cols Largest frame width.
+ * @return 1 on success, 0 if memory allocation failed.
+ */
+static inline int screen_init(Screen* screen, int rows, int cols)
+{
+    screen->rows = rows;
+    screen->cols = cols;
+    screen->front = malloc((size_t)rows * cols * sizeof(uint32_t));
+    screen->back = malloc((size_t)rows * cols * sizeof(uint32_t));
+    // Worst case: every other cell needs a cursor move (up to 16 bytes) plus a 4-byte glyph.
+    screen->out = malloc((size_t)rows * cols * 20 + 64);
+    screen->out_length = 0;
+    screen->pen_row = 0;
+    screen->pen_col = 0;
+    screen->full_clear = 1;
+    screen->stream = stdout;
+    screen->view_rows = 0;
+    screen->view_cols = 0;
+    screen->resizes_seen = 0;
+    screen->cursor_row = 0;
+    screen->cursor_col = 0;
+    if (screen->front == NULL || screen->back == NULL || screen->out == NULL)
+    {
+        return 0;
+    }
+#ifndef _WIN32
+    signal(SIGWINCH, screen_handle_resize);
+#else
+    HANDLE h_output = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode;
+    if (GetConsoleMode(h_output, &mode))
+    {
+        SetConsoleMode(h_output, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+    return 1;
+}
+/**
+ * @brief Releases the buffers of a screen.
+ * @param screen The screen to free.
+ */
+static inline void screen_free(Screen* screen)
+{
+    free(screen->front);
+    free(screen->back);
+    free(screen->out);
+    screen->front = screen->back = NULL;
+    screen->out = NULL;
+}
+/**
+ * @brief Marks the terminal content as unknown, so the next present clears and redraws all.
+ * Call this after printing to the terminal outside the screen without screen_note_text() (menus).
+ * @param screen The screen.
+ */
+static inline void screen_invalidate(Screen* screen)
+{
+    screen->full_clear = 1;
+}
+/**
+ * @brief Records text printed under the frame outside the screen, such as a prompt and
+ * its echoed answer. While the text fits below the frame the terminal keeps still, so
+ * the next present still sends only the changed cells.
+ * @param screen The screen.
+ * @param text The text as printed, including its newlines.
+ */
+static inline void screen_note_text(Screen* screen, const char* text)
+{
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '\n' || (screen->view_cols > 0 && screen->cursor_col == screen->view_cols))
+        {
+            screen->cursor_row++; // A new line, or a long line wrapping
+            screen->cursor_col = 0;
+        }
+        if (*text != '\n' && ((unsigned char)*text & 0xC0) != 0x80) // UTF-8 continuation bytes take no cell
+        {
+            screen->cursor_col++;
+        }
+    }
+}
+/**
+ * @brief Measures the terminal and clamps the drawn part of the frame to it.
+ * Streams that are not terminals get the whole frame.
+ * @param screen The screen.
+ */
+static inline void screen_measure(Screen* screen)
+{
+    int rows = screen->rows, cols = screen->cols;
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    HANDLE h_output = GetStdHandle((screen->stream == stderr) ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
+    if (GetConsoleScreenBufferInfo(h_output, &info))
+    {
+        rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+        cols = info.srWindow.Right - info.srWindow.Left + 1;
+    }
+#else
+    struct winsize size;
+    screen->resizes_seen = screen_resizes;
+    if (ioctl(fileno(screen->stream), TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0)
+    {
+        rows = size.ws_row;
+        cols = size.ws_col;
+    }
+#endif
+    screen->view_rows = (rows < screen->rows) ? rows : screen->rows;
+    screen->view_cols = (cols < screen->cols) ? cols : screen->cols;
+}
+/**
+ * @brief Sends the pending output with one write call.
+ * @param screen The screen.
+ */
+static inline void screen_flush(Screen* screen)
+{
+    fflush(screen->stream); // Keep order with text printed through stdio.
+#ifdef _WIN32
+    fwrite(screen->out, 1, screen->out_length, screen->stream);
+    fflush(screen->stream);
+#else
+    size_t written = 0;
+    while (written < screen->out_length)
+    {
+        ssize_t result = write(fileno(screen->stream), screen->out + written, screen->out_length - written);
+        if (result <= 0)
+        {
+            break;
+        }
+        written += result;
+    }
+#endif
+    screen->out_length = 0;
+}
+/**
+ * @brief Clears the terminal right away, without spawning a shell.
+ * @param screen The screen.
+ */
+static inline void screen_clear_terminal(Screen* screen)
+{
+    memcpy(screen->out, "\x1b[H\x1b[2J", 7);
+    screen->out_length = 7;
+    screen_flush(screen);
+    for (int i = 0; i < screen->rows * screen->cols; i++)
+    {
+        screen->front[i] = SCREEN_BLANK;
+    }
+    screen->full_clear = 0;
+    screen->cursor_row = 0;
+    screen->cursor_col = 0;
+}
+/**
+ * @brief Starts a new frame: empties the back buffer and moves the pen to the top left.
+ * @param screen The screen.
+ */
+static inline void screen_begin_frame(Screen* screen)
+{
+    for (int i = 0; i < screen->rows * screen->cols; i++)
+    {
+        screen->back[i] = SCREEN_BLANK;
+    }
+    screen->pen_row = 0;
+    screen->pen_col = 0;
+}
+/**
+ * @brief Moves the pen to a cell of the frame.
+ * @param screen The screen.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ */
+static inline void screen_move(Screen* screen, int row, int col)
+{
+    screen->pen_row = row;
+    screen->pen_col = col;
+}
+/**
+ * @brief Packs the UTF-8 sequence of one character into a cell value.
+ * @param text UTF-8 text; the first character is packed.
+ * @param length Stores the number of bytes consumed (may be NULL).
+ * @return The glyph.
+ */
+static inline uint32_t screen_glyph(const char* text, int* length)
+{
+    const unsigned char* p = (const unsigned char*)text;
+    int bytes = (*p >= 0xF0) ? 4 : (*p >= 0xE0) ? 3 : (*p >= 0xC0) ? 2 : 1;
+    uint32_t glyph = 0;
+    int i = 0;
+    for (; i < bytes && p[i]; i++)
+    {
+        glyph |= (uint32_t)p[i] << (8 * i);
+    }
+    if (length != NULL)
+    {
+        *length = i;
+    }
+    return glyph;
+}
+/**
+ * @brief Copies ready-made cells into the frame at the pen, as one block.
+ * @param screen The screen.
+ * @param cells Glyphs to copy.
+ * @param count Number of glyphs.
+ */
+static inline void screen_cells(Screen* screen, const uint32_t* cells, int count)
+{
+    int room = screen->cols - screen->pen_col;
+    if (screen->pen_row < screen->rows && room > 0)
+    {
+        memcpy(screen->back + screen->pen_row * screen->cols + screen->pen_col, cells,
+               ((count < room) ? count : room) * sizeof(uint32_t));
+    }
+    screen->pen_col += count;
+}
+/**
+ * @brief Writes UTF-8 text into the frame at the pen. '\n' starts a new row and '\t'
+ * jumps to the next tab stop. Text outside the frame is dropped.
+ * @param screen The screen.
+ * @param text Null terminated UTF-8 text.
+ */
+static inline void screen_text(Screen* screen, const char* text)
+{
+    const unsigned char* p = (const unsigned char*)text;
+    while (*p)
+    {
+        if (*p == '\n')
+        {
+            screen->pen_row++;
+            screen->pen_col = 0;
+            p++;
+            continue;
+        }
+        if (*p == '\t')
+        {
+            screen->pen_col = (screen->pen_col / SCREEN_TAB_WIDTH + 1) * SCREEN_TAB_WIDTH;
+            p++;
+            continue;
+        }
+        int length;
+        uint32_t glyph = screen_glyph((const char*)p, &length);
+        p += length;
+        if (screen->pen_row < screen->rows && screen->pen_col < screen->cols)
+        {
+            screen->back[screen->pen_row * screen->cols + screen->pen_col] = glyph;
+        }
+        screen->pen_col++;
+    }
+}
+/**
+ * @brief printf-style version of screen_text().
+ * @param screen The screen.
+ * @param format printf format string.
+ */
+static inline void screen_printf(Screen* screen, const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    screen_text(screen, buffer);
+}
+/**
+ * @brief Appends an ANSI cursor position sequence to the pending output.
+ * @param screen The screen.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ */
+static inline void screen_emit_cursor(Screen* screen, int row, int col)
+{
+    screen->out_length += sprintf(screen->out + screen->out_length, "\x1b[%d;%dH", row + 1, col + 1);
+}
+/**
+ * @brief Shows the composed frame. Only cells that differ from the previous frame are
+ * written. Everything below the frame is erased and the cursor is left at the pen,
+ * so prompts printed after the frame appear right under it. Cells beyond the
+ * terminal's rows and columns are not drawn, so the terminal never wraps or scrolls.
+ * @param screen The screen.
+ */
+static inline void screen_present(Screen* screen)
+{
+#ifdef _WIN32
+    int view_rows = screen->view_rows, view_cols = screen->view_cols;
+    screen_measure(screen); // No SIGWINCH on Windows; asking the console every frame is cheap.
+    if (screen->view_rows != view_rows || screen->view_cols != view_cols)
+    {
+        screen->full_clear = 1;
+    }
+#else
+    if (screen->view_rows == 0 || screen->resizes_seen != screen_resizes)
+    {
+        screen_measure(screen);
+        screen->full_clear = 1; // A resized terminal reflows or drops what it showed.
+    }
+#endif
+    if (screen->cursor_row >= screen->view_rows)
+    {
+        screen->full_clear = 1; // Text noted under the frame scrolled the terminal.
+    }
+    if (screen->full_clear)
+    {
+        memcpy(screen->out + screen->out_length, "\x1b[H\x1b[2J", 7);
+        screen->out_length += 7;
+        for (int i = 0; i < screen->rows * screen->cols; i++)
+        {
+            screen->front[i] = SCREEN_BLANK;
+        }
+        screen->full_clear = 0;
+    }
+
+    int cursor_row = -1, cursor_col = -1; // Unknown until the first move.
+    for (int row = 0; row < screen->view_rows; row++)
+    {
+        uint32_t* front_row = screen->front + row * screen->cols;
+        uint32_t* back_row = screen->back + row * screen->cols;
+        if (memcmp(front_row, back_row, screen->view_cols * sizeof(uint32_t)) == 0)
+        {
+            continue; // Unchanged row.
+        }
+        for (int col = 0; col < screen->view_cols; col++)
+        {
+            uint32_t glyph = back_row[col];
+            if (glyph == front_row[col])
+            {
+                continue;
+            }
+            if (row == cursor_row && col > cursor_col && col - cursor_col <= SCREEN_SHORT_GAP)
+            {
+                col = cursor_col; // Rewriting a few unchanged cells is shorter than a cursor move.
+            }
+            else if (row != cursor_row || col != cursor_col)
+            {
+                screen_emit_cursor(screen, row, col);
+            }
+            glyph = back_row[col];
+            for (uint32_t bytes = glyph; bytes; bytes >>= 8)
+            {
+                screen->out[screen->out_length++] = (char)(bytes & 0xFF);
+            }
+            front_row[col] = glyph;
+            cursor_row = row;
+            cursor_col = col + 1;
+        }
+    }
+
+    // Erase leftovers (old prompts, a taller previous frame) below the frame.
+    int erase_row = screen->pen_row + (screen->pen_col > 0);
+    for (int row = erase_row; row < screen->rows; row++)
+    {
+        for (int col = 0; col < screen->cols; col++)
+        {
+            if (screen->back[row * screen->cols + col] != SCREEN_BLANK)
+            {
+                erase_row = row + 1; // Content placed below the pen with screen_move().
+                break;
+            }
+        }
+    }
+    if (erase_row < screen->view_rows)
+    {
+        screen_emit_cursor(screen, erase_row, 0);
+        memcpy(screen->out + screen->out_length, "\x1b[J", 3);
+        screen->out_length += 3;
+        for (int i = erase_row * screen->cols; i < screen->rows * screen->cols; i++)
+        {
+            screen->front[i] = SCREEN_BLANK;
+        }
+    }
+    // Park the cursor at the pen, where following prompts will appear.
+    int park_row = (screen->pen_row < screen->view_rows) ? screen->pen_row : screen->view_rows - 1;
+    int park_col = (screen->pen_col < screen->view_cols) ? screen->pen_col : screen->view_cols - 1;
+    if (park_row != erase_row || park_col != 0)
+    {
+        screen_emit_cursor(screen, park_row, park_col);
+    }
+    screen->cursor_row = park_row;
+    screen->cursor_col = park_col;
+    screen_flush(screen);
+}
+/**
+ * @brief Shows the first row of the frame on the terminal's current line, redrawn in
+ * place with a carriage return and clear-to-end-of-line. Nothing else is touched, so
+ * this suits a status line sharing the terminal with other output.
+ * @param screen The screen.
+ */
+static inline void screen_present_line(Screen* screen)
+{
+#ifdef _WIN32
+    screen_measure(screen);
+#else
+    if (screen->view_rows == 0 || screen->resizes_seen != screen_resizes)
+    {
+        screen_measure(screen);
+    }
+#endif
+    // The last terminal column is left free: writing it would make the next character wrap.
+    int length = screen->view_cols - 1;
+    while (length > 0 && screen->back[length - 1] == SCREEN_BLANK)
+    {
+        length--;
+    }
+    screen->out[screen->out_length++] = '\r';
+    for (int col = 0; col < length; col++)
+    {
+        for (uint32_t bytes = screen->back[col]; bytes; bytes >>= 8)
+        {
+            screen->out[screen->out_length++] = (char)(bytes & 0xFF);
+        }
+    }
+    memcpy(screen->out + screen->out_length, "\x1b[K", 3);
+    screen->out_length += 3;
+    screen_flush(screen);
+}
+
+#endif // SCREEN_H